@@ -4,31 +4,89 @@
 #include <iostream>
 
 const float REACTION_TIME = 0.5f;
+// projectiles that hit sooner than DODGE_TIME are dodged, at most once per DODGE_INTERVAL
+const float DODGE_TIME = 0.3f;
+const float DODGE_INTERVAL = 0.1f;
+// lookahead of the planner and how long its decisions are held
+const float PLAN_HORIZON = 1.0f;
+const float PLAN_COMMIT = 0.2f;
+// threats within a quarter of the arena width get a decision every PLAN_COMMIT,
+// those beyond half of it every PLAN_MAX_INTERVAL of them
+const float THREAT_NEAR = 0.25f;
+const float THREAT_FAR = 0.5f;
+const int PLAN_MAX_INTERVAL = 4;
 
-AI::AI(int playerNumber, Game* game)
-    : Player(playerNumber), game(game), reactionTime(REACTION_TIME)
-{}
+std::unique_ptr<AiScheduler> makeAiScheduler(const SimConfig& config, float thinkMs, float frameMs) {
+    if (thinkMs <= 0) {
+        return nullptr;
+    }
+    return std::make_unique<AiScheduler>(
+        AiSchedulerConfig{frameMs, thinkMs, THREAT_NEAR * config.w, THREAT_FAR * config.w, PLAN_MAX_INTERVAL},
+        PlannerConfig{thinkMs, config.ticks(PLAN_HORIZON), std::max(config.ticks(PLAN_COMMIT), 1), 1, 0});
+}
+
+AI::AI(int playerNumber, World* world, Perception* perception, AiScheduler* scheduler)
+    : Player(playerNumber, world), reactionTime(REACTION_TIME), dodgeTime(0), rng(world->rngStream(RNG_STREAM_AI + owner)), perception(perception),
+      scheduler(scheduler), planUntil(0)
+{
+    if (perception == nullptr) {
+        ownPerception = std::make_unique<Perception>();
+        this->perception = ownPerception.get();
+    }
+    if (scheduler != nullptr) {
+        scheduler->add(owner);
+    }
+}
 
 // AI need not handle events
 void AI::handleEvent(SDL_Event& event) {}
 
+// the AI keeps turning and presses the same buttons as a human player,
+// decisions of the scheduler replace the turning and the random actions while
+// they last, the shooting is always left to the aiming check; without a
+// decision, a boost away from a projectile about to hit comes first, as soon
+// as it leads to no more danger than staying
 void AI::update(float deltaTime) {
-    rotate(deltaTime);
+    PlannedAction action;
+    if (scheduler != nullptr && scheduler->takeDecision(owner, action)) {
+        pressed |= action.first;
+        held = action.held;
+        planUntil = world->tick + scheduler->commitTicks();
+    }
+    bool planned = world->tick < planUntil;
+    if (!planned) {
+        rotate();
+    }
     
-    std::shared_ptr<Agent> player = (game->getPlayer1()->pNumber() == pNumber()) ? game->getPlayer2() : game->getPlayer1();
-    auto enemies = player->getSpaceships();
-    auto spaceship = spaceships[activeSpaceship];
-    for (auto& enemy : enemies) {
-        Vector2 direction = enemy->pos - spaceship->pos;
-        float angle = spaceship->velocity.angleBetween(direction); // in degrees
-        if (-10 <= angle && angle <= 10) {
-            shoot();
-        }
+    perception->update(*world);
+    const OwnerPerception& seen = perception->owner(owner);
+    if (seen.active < 0) {
+        return;
+    }
+    // shoot when any enemy is within 10 degrees of the heading
+    if (seen.enemyInSight) {
+        shoot();
+    }
+    if (planned) {
+        return;
     }
     
     reactionTime -= deltaTime;
+    dodgeTime -= deltaTime;
+    if (seen.threatTime < DODGE_TIME && dodgeTime <= 0) {
+        // a boost turns by rotBoostDeg first; while it would lead somewhere
+        // more dangerous, keep turning and look again next tick
+        const SimConfig& cfg = world->config;
+        Vector2 pos = world->ships.transform[seen.active].pos;
+        Vector2 to = pos + direction(world->ships.transform[seen.active].angle + cfg.rotBoostDeg) * (cfg.forceBoost * DODGE_TIME);
+        if (perception->danger(owner, to) <= perception->danger(owner, pos)) {
+            dodgeTime = DODGE_INTERVAL;
+            rotateAndBoost();
+        }
+        return;
+    }
     if (reactionTime <= 0) {
-        int randomAction = rand() % 100;
+        int randomAction = rng.below(100);
         reactionTime = REACTION_TIME;
         if (randomAction < 33) {
             rotateAndBoost();
@@ -39,5 +97,4 @@ void AI::update(float deltaTime) {
         }
         
     }
-    Player::update(deltaTime);
 }
\ No newline at end of file
@@ -1,17 +1,26 @@
 #ifndef AI_H
 #define AI_H
 #include "player.h"
-#include "game.h"
-#include "spaceship.h"
 #include "math.h"
+#include "ai/perception.h"
+#include "ai/scheduler.h"
+
+// the scheduler of planning AIs with thinkMs per decision and at most frameMs
+// per frame for all of them, null for thinkMs 0
+std::unique_ptr<AiScheduler> makeAiScheduler(const SimConfig& config, float thinkMs, float frameMs);
 
-class Game;
 class AI : public Player {
 private:
-    Game* game;
     float reactionTime;
+    float dodgeTime; // until the next dodge may start
+    Rng rng; // own stream of the match seed, independent of the spawner
+    Perception* perception; // shared by the AIs of the world, or ownPerception
+    std::unique_ptr<Perception> ownPerception;
+    AiScheduler* scheduler; // plans for this AI, null for the reactive AI
+    uint32_t planUntil;     // tick the last decision of the scheduler ends at
 public:
-    AI(int playerNumber, Game* game);
+    // without a perception, the AI builds one of its own
+    AI(int playerNumber, World* world, Perception* perception = nullptr, AiScheduler* scheduler = nullptr);
     void handleEvent(SDL_Event& event);
     void update(float deltaTime);
 };
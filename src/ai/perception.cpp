@@ -0,0 +1,373 @@
+#include "ai/perception.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "sim/job_system.h"
+
+// weights stamped on the danger grid
+const int SHIP_WEIGHT = 2;
+const int BULLET_WEIGHT = 1;
+const int LASER_WEIGHT = 4;
+const int MINE_WEIGHT[] = {1, 3, 4, 0}; // by MinePhase
+// owners per parallelFor chunk, each one sweeps every projectile
+const size_t OWNER_CHUNK = 1;
+
+const float NONE = std::numeric_limits<float>::infinity();
+
+static int cells(float length, float cellSize) {
+    return std::max((int)std::ceil(length / cellSize), 1);
+}
+
+Perception::Perception()
+    : current(false), updates(0), tick(0), shipGridW(0), shipGridH(0), gridW(0), gridH(0) {}
+
+void Perception::reset(const World& world) {
+    gridW = cells(world.config.w, CELL_SIZE);
+    gridH = cells(world.config.h, CELL_SIZE);
+    shipGridW = cells(world.config.w, SHIP_CELL);
+    shipGridH = cells(world.config.h, SHIP_CELL);
+    total.assign((size_t)gridW * gridH, 0);
+    teams.assign(world.numTeams(), total);
+    stamps.clear();
+    owners.resize(world.numPlayers());
+}
+
+void Perception::update(const World& world) {
+    if (current && world.tick == tick) {
+        return;
+    }
+    if (!current || gridW != cells(world.config.w, CELL_SIZE) || gridH != cells(world.config.h, CELL_SIZE) ||
+        (int)teams.size() != world.numTeams() || (int)owners.size() != world.numPlayers()) {
+        reset(world);
+    }
+    current = true;
+    tick = world.tick;
+    teamOf = world.team;
+    updates++;
+
+    buildShipGrid(world);
+    const SimConfig& cfg = world.config;
+    const LaserTable& lasers = world.lasers;
+    beams.resize(lasers.size());
+    for (size_t l = 0; l < lasers.size(); l++) {
+        Beam& beam = beams[l];
+        float angle = lasers.angle[l];
+        beam.pos = lasers.pos[l];
+        beam.dir = direction(angle);
+        RayIntersection res = getRayIntersectionBorder(beam.pos, angle, cfg.w, cfg.h);
+        if (res.side == BorderSide::LEFT || res.side == BorderSide::RIGHT) {
+            angle = 180 - angle;
+        } else if (res.side == BorderSide::TOP || res.side == BorderSide::BOTTOM) {
+            angle = -angle;
+        }
+        beam.reflectPos = res.intersectionPoint;
+        beam.reflectDir = direction(angle);
+        // off the border first, or the reflection ends where it starts
+        beam.reflectEnd = getRayIntersectionBorder(beam.reflectPos + beam.reflectDir, angle, cfg.w, cfg.h).intersectionPoint;
+    }
+    parallelFor(world.jobs, owners.size(), OWNER_CHUNK, [&](size_t begin, size_t end) {
+        for (size_t owner = begin; owner < end; owner++) {
+            perceive(world, owner);
+        }
+    });
+    updateDanger(world);
+}
+
+void Perception::buildShipGrid(const World& world) {
+    const ShipTable& ships = world.ships;
+    cellStart.assign((size_t)shipGridW * shipGridH + 1, 0);
+    shipCell.resize(ships.size());
+    shipRows.resize(ships.size());
+    for (size_t i = 0; i < ships.size(); i++) {
+        Vector2 pos = ships.transform[i].pos;
+        int x = std::clamp((int)(pos.x / SHIP_CELL), 0, shipGridW - 1);
+        int y = std::clamp((int)(pos.y / SHIP_CELL), 0, shipGridH - 1);
+        shipCell[i] = y * shipGridW + x;
+        cellStart[shipCell[i] + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    // every start moves to the end of its cell while filling, which is the start of the next
+    for (size_t i = 0; i < ships.size(); i++) {
+        shipRows[cellStart[shipCell[i]]++] = i;
+    }
+    for (size_t c = cellStart.size() - 1; c > 0; c--) {
+        cellStart[c] = cellStart[c - 1];
+    }
+    cellStart[0] = 0;
+}
+
+void Perception::perceive(const World& world, int owner) {
+    OwnerPerception& p = owners[owner];
+    p.active = world.activeIndex(owner);
+    p.numNearest = 0;
+    p.enemyInSight = false;
+    p.threatTime = NONE;
+    p.threatDistance = NONE;
+    if (p.active < 0) {
+        return;
+    }
+    const SimConfig& cfg = world.config;
+    const ShipTable& ships = world.ships;
+    const Vector2 pos = ships.transform[p.active].pos;
+    const Vector2 heading = ships.velocity[p.active].dir;
+    const Vector2 velocity = heading * ships.velocity[p.active].speed;
+    auto foe = [&](int other) { return (world.relation(other, owner) & RELATION_HIT) != 0; };
+
+    // nearest foes, ring by ring of ship cells: every ship beyond ring r is at
+    // least r cells away, so the search stops once the nearest are closer
+    const int qx = std::clamp((int)(pos.x / SHIP_CELL), 0, shipGridW - 1);
+    const int qy = std::clamp((int)(pos.y / SHIP_CELL), 0, shipGridH - 1);
+    const int rings = std::max(shipGridW, shipGridH);
+    for (int r = 0; r < rings; r++) {
+        for (int y = std::max(qy - r, 0); y <= std::min(qy + r, shipGridH - 1); y++) {
+            int step = (y == qy - r || y == qy + r) ? 1 : 2 * r;
+            for (int x = qx - r; x <= qx + r; x += step) {
+                if (x < 0 || x >= shipGridW) {
+                    continue;
+                }
+                int c = y * shipGridW + x;
+                for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; k++) {
+                    uint32_t row = shipRows[k];
+                    if (!foe(ships.owner[row])) {
+                        continue;
+                    }
+                    float d = pos.distanceSquared(ships.transform[row].pos);
+                    int n = p.numNearest;
+                    if (n == PERCEPTION_NEAREST && d >= p.nearestDistance[n - 1]) {
+                        continue;
+                    }
+                    n = std::min(n, PERCEPTION_NEAREST - 1);
+                    for (; n > 0 && p.nearestDistance[n - 1] > d; n--) {
+                        p.nearest[n] = p.nearest[n - 1];
+                        p.nearestDistance[n] = p.nearestDistance[n - 1];
+                    }
+                    p.nearest[n] = row;
+                    p.nearestDistance[n] = d;
+                    p.numNearest = std::min(p.numNearest + 1, PERCEPTION_NEAREST);
+                }
+            }
+        }
+        float reach = r * SHIP_CELL;
+        if (p.numNearest == PERCEPTION_NEAREST && p.nearestDistance[PERCEPTION_NEAREST - 1] <= reach * reach) {
+            break;
+        }
+    }
+    float nearestSq = p.numNearest > 0 ? p.nearestDistance[0] : NONE;
+    for (int n = 0; n < p.numNearest; n++) {
+        p.nearestDistance[n] = std::sqrt(p.nearestDistance[n]);
+        p.enemyInSight |= inSight(heading, ships.transform[p.nearest[n]].pos - pos);
+    }
+
+    // bullets: first time the relative motion comes within reach, before the bullet expires
+    const BulletTable& bullets = world.bullets;
+    for (size_t b = 0; b < bullets.size(); b++) {
+        if (!foe(bullets.owner[b])) {
+            continue;
+        }
+        Vector2 f = bullets.pos[b] - pos;
+        nearestSq = std::min(nearestSq, f.dot(f));
+        Vector2 v = direction(bullets.angle[b]) * bullets.speed[b] - velocity;
+        float c = f.dot(f) - cfg.shipBulletRadiusSq;
+        if (c <= 0.0f) {
+            p.threatTime = 0.0f;
+            continue;
+        }
+        float a = v.dot(v), half = f.dot(v);
+        float disc = half * half - a * c;
+        if (half >= 0.0f || disc < 0.0f) {
+            continue;
+        }
+        float t = (-half - std::sqrt(disc)) / a;
+        float life = bullets.expiresAt[b] > world.tick ? (bullets.expiresAt[b] - world.tick) * cfg.tickDuration : 0.0f;
+        if (t <= life) {
+            p.threatTime = std::min(p.threatTime, t);
+        }
+    }
+
+    const LaserTable& lasers = world.lasers;
+    for (size_t l = 0; l < lasers.size(); l++) {
+        if (!foe(lasers.owner[l])) {
+            continue;
+        }
+        const Beam& beam = beams[l];
+        if (std::abs((pos.x - beam.pos.x) * beam.dir.y - (pos.y - beam.pos.y) * beam.dir.x) <= cfg.laserHitDistance ||
+            std::abs((pos.x - beam.reflectPos.x) * beam.reflectDir.y - (pos.y - beam.reflectPos.y) * beam.reflectDir.x) <=
+                cfg.laserHitDistance) {
+            p.threatTime = 0.0f;
+        }
+    }
+
+    // armed mines of foes are set off by coming within their trigger radius,
+    // activated and exploding ones of anybody hit everything in the blast
+    const MineTable& mines = world.mines;
+    const float triggerRadiusSq = std::min(cfg.mineTriggerRadiusSq, cfg.mineExplosionRadiusSq);
+    for (size_t m = 0; m < mines.size(); m++) {
+        float d = pos.distanceSquared(mines.pos[m]);
+        bool foeMine = foe(mines.owner[m]);
+        if (foeMine) {
+            nearestSq = std::min(nearestSq, d);
+        }
+        switch (mines.phase[m]) {
+            case MinePhase::ARMED:
+                if (foeMine && d <= triggerRadiusSq) {
+                    p.threatTime = std::min(p.threatTime, cfg.mineActivationTicks * cfg.tickDuration);
+                }
+                break;
+            case MinePhase::ACTIVATED:
+                if (d <= cfg.mineBlastRadiusSq) {
+                    float left = mines.explodeAt[m] > world.tick ? (mines.explodeAt[m] - world.tick) * cfg.tickDuration : 0.0f;
+                    p.threatTime = std::min(p.threatTime, left);
+                }
+                break;
+            case MinePhase::EXPLODING:
+                if (d <= cfg.mineBlastRadiusSq) {
+                    p.threatTime = 0.0f;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    p.threatDistance = std::sqrt(nearestSq);
+}
+
+uint32_t Perception::cellOf(Vector2 pos) const {
+    int x = std::clamp((int)(pos.x / CELL_SIZE), 0, gridW - 1);
+    int y = std::clamp((int)(pos.y / CELL_SIZE), 0, gridH - 1);
+    return y * gridW + x;
+}
+
+int Perception::danger(int owner, Vector2 pos) const {
+    if (!current) {
+        return 0;
+    }
+    uint32_t cell = cellOf(pos);
+    return total[cell] - teams[teamOf[owner]][cell];
+}
+
+Perception::Stamp* Perception::restamp(int id, int team, int weight, uint64_t key) {
+    auto [it, added] = stamps.try_emplace(id);
+    Stamp& stamp = it->second;
+    if (!added && stamp.team == team && stamp.weight == weight && stamp.key == key) {
+        stamp.seen = updates;
+        return nullptr;
+    }
+    if (!added) {
+        apply(stamp, -1);
+    }
+    stamp.team = team;
+    stamp.weight = weight;
+    stamp.key = key;
+    stamp.cells.clear();
+    stamp.seen = updates;
+    return &stamp;
+}
+
+// every cell within radius of the center of the cell, not of the entity, so
+// the stamp only depends on the cell
+void Perception::stampDisc(Stamp& stamp, uint32_t center, float radius) {
+    const int r = (int)std::ceil(radius / CELL_SIZE);
+    const int cx = center % gridW, cy = center / gridW;
+    for (int y = std::max(cy - r, 0); y <= std::min(cy + r, gridH - 1); y++) {
+        for (int x = std::max(cx - r, 0); x <= std::min(cx + r, gridW - 1); x++) {
+            if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r + r) {
+                stamp.cells.push_back(y * gridW + x);
+            }
+        }
+    }
+}
+
+// the cells of a line between the cells of from and to, in the arena
+void Perception::stampSegment(Stamp& stamp, Vector2 from, Vector2 to) {
+    uint32_t a = cellOf(from), b = cellOf(to);
+    int x = a % gridW, y = a / gridW;
+    const int x1 = b % gridW, y1 = b / gridW;
+    const int dx = std::abs(x1 - x), dy = -std::abs(y1 - y);
+    const int sx = x < x1 ? 1 : -1, sy = y < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        stamp.cells.push_back(y * gridW + x);
+        if (x == x1 && y == y1) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+void Perception::apply(const Stamp& stamp, int sign) {
+    const int weight = sign * stamp.weight;
+    std::vector<int>& own = teams[stamp.team];
+    for (uint32_t cell : stamp.cells) {
+        total[cell] += weight;
+        own[cell] += weight;
+    }
+}
+
+void Perception::updateDanger(const World& world) {
+    const SimConfig& cfg = world.config;
+    const ShipTable& ships = world.ships;
+    for (size_t i = 0; i < ships.size(); i++) {
+        uint32_t cell = cellOf(ships.transform[i].pos);
+        if (Stamp* stamp = restamp(ships.id[i], teamOf[ships.owner[i]], SHIP_WEIGHT, cell)) {
+            stampDisc(*stamp, cell, 2 * cfg.shipRadius);
+            apply(*stamp, 1);
+        }
+    }
+    const BulletTable& bullets = world.bullets;
+    for (size_t b = 0; b < bullets.size(); b++) {
+        float life = bullets.expiresAt[b] > world.tick ? (bullets.expiresAt[b] - world.tick) * cfg.tickDuration : 0.0f;
+        Vector2 to = bullets.pos[b] + direction(bullets.angle[b]) * (bullets.speed[b] * std::min(BULLET_LOOKAHEAD, life));
+        uint64_t key = (uint64_t)cellOf(bullets.pos[b]) << 32 | cellOf(to);
+        if (Stamp* stamp = restamp(bullets.id[b], teamOf[bullets.owner[b]], BULLET_WEIGHT, key)) {
+            stampSegment(*stamp, bullets.pos[b], to);
+            apply(*stamp, 1);
+        }
+    }
+    const LaserTable& lasers = world.lasers;
+    for (size_t l = 0; l < lasers.size(); l++) {
+        // beams do not move, the key only tells a restored beam of the same id apart
+        uint32_t angle;
+        std::memcpy(&angle, &lasers.angle[l], sizeof(angle));
+        if (Stamp* stamp = restamp(lasers.id[l], teamOf[lasers.owner[l]], LASER_WEIGHT, (uint64_t)cellOf(beams[l].pos) << 32 | angle)) {
+            stampSegment(*stamp, beams[l].pos, beams[l].reflectPos);
+            // without the cell the reflection starts in a second time
+            size_t beam = stamp->cells.size();
+            stampSegment(*stamp, beams[l].reflectPos, beams[l].reflectEnd);
+            stamp->cells.erase(stamp->cells.begin() + beam);
+            apply(*stamp, 1);
+        }
+    }
+    const MineTable& mines = world.mines;
+    for (size_t m = 0; m < mines.size(); m++) {
+        int weight = MINE_WEIGHT[(int)mines.phase[m]];
+        if (weight == 0) {
+            continue;
+        }
+        uint32_t cell = cellOf(mines.pos[m]);
+        if (Stamp* stamp = restamp(mines.id[m], teamOf[mines.owner[m]], weight, (uint64_t)mines.phase[m] << 32 | cell)) {
+            stampDisc(*stamp, cell, cfg.mineExplosionRadius);
+            apply(*stamp, 1);
+        }
+    }
+    // entities that are gone
+    for (auto it = stamps.begin(); it != stamps.end();) {
+        if (it->second.seen != updates) {
+            apply(it->second, -1);
+            it = stamps.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef AI_PERCEPTION_H
+#define AI_PERCEPTION_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "sim/world.h"
+
+// foe spaceships kept per owner, nearest first
+constexpr int PERCEPTION_NEAREST = 4;
+// cos^2 of the aiming cone of the AI, 10 degrees
+constexpr float SIGHT_COS_SQ = 0.96984631f;
+
+// whether offset lies within the aiming cone around heading, without the acos
+inline bool inSight(Vector2 heading, Vector2 offset) {
+    float dot = heading.dot(offset);
+    return dot > 0.0f && dot * dot >= SIGHT_COS_SQ * heading.dot(heading) * offset.dot(offset);
+}
+
+// What one owner's AI knows about the surroundings of its active spaceship
+struct OwnerPerception {
+    int active;                      // row of the active spaceship, -1 without one
+    int numNearest;
+    int nearest[PERCEPTION_NEAREST]; // rows of the nearest foe spaceships
+    float nearestDistance[PERCEPTION_NEAREST];
+    bool enemyInSight;    // one of the nearest foe spaceships is in sight of the heading
+    float threatTime;     // seconds until a foe projectile or any blast reaches the spaceship, infinity for none
+    float threatDistance; // to the nearest foe spaceship, bullet or mine, infinity for none
+};
+
+// What the AI agents of one world perceive, computed once per tick and shared
+// by all of them.
+//
+// Nearest foes are looked up in a uniform grid of the spaceships, rebuilt
+// every tick with a counting sort and searched ring by ring; the aiming check
+// only looks at them. Threat times sweep the projectiles against every active
+// spaceship: bullets along their straight path until they expire (border
+// bounces are not predicted), laser beams and their reflection as hitting
+// right away, mines by the time left until they go off over the spaceship.
+//
+// The danger grid counts, per team and cell of CELL_SIZE, what the team
+// threatens there: its spaceships, the path of its bullets over the next
+// BULLET_LOOKAHEAD seconds, its mines by phase and its beams. Every entity
+// stamps integer weights on cells derived from the cell it is in, and a tick
+// only restamps the entities that changed cell, weight or team and removes
+// the ones that are gone, so most ticks touch a few cells. The AI dodges
+// towards cells the grid rates no more dangerous than its own.
+class Perception {
+public:
+    static constexpr float CELL_SIZE = 40.0f;       // of the danger grid, in pixels
+    static constexpr float SHIP_CELL = 160.0f;      // of the spaceship grid
+    static constexpr float BULLET_LOOKAHEAD = 0.25f;
+
+    Perception();
+
+    // catches up with world, nothing if it was already done for its tick: every
+    // AI of a tick sees the world as the first one did, not the inputs applied since
+    void update(const World& world);
+
+    const OwnerPerception& owner(int owner) const { return owners[owner]; }
+    // of the teams hitting owner at pos
+    int danger(int owner, Vector2 pos) const;
+    // of team at cell (x, y)
+    int teamDanger(int team, int x, int y) const { return teams[team][y * gridW + x]; }
+    int columns() const { return gridW; }
+    int rows() const { return gridH; }
+
+private:
+    struct Stamp {
+        int team;
+        int weight;
+        uint64_t key;   // cells the stamp was built from, it is only rebuilt when this changes
+        std::vector<uint32_t> cells;
+        uint32_t seen;  // last update that found the entity
+    };
+    // a laser beam and its reflection off the border
+    struct Beam {
+        Vector2 pos, dir, reflectPos, reflectDir, reflectEnd;
+    };
+
+    bool current;
+    uint32_t updates;
+    uint32_t tick;
+    std::vector<OwnerPerception> owners;
+    std::vector<int> teamOf; // per owner
+
+    // rows of the spaceships in ship cell c at shipRows[cellStart[c]] up to cellStart[c + 1]
+    int shipGridW, shipGridH;
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> shipRows;
+    std::vector<uint32_t> shipCell; // per row
+    std::vector<Beam> beams;        // per laser row
+
+    int gridW, gridH;
+    std::vector<int> total;                // of every team
+    std::vector<std::vector<int>> teams;
+    std::unordered_map<int, Stamp> stamps; // by entity id
+
+    void reset(const World& world);
+    void buildShipGrid(const World& world);
+    void perceive(const World& world, int owner);
+    void updateDanger(const World& world);
+    uint32_t cellOf(Vector2 pos) const;
+    // the stamp of id with its old weights removed and no cells, null if it is unchanged
+    Stamp* restamp(int id, int team, int weight, uint64_t key);
+    void stampDisc(Stamp& stamp, uint32_t center, float radius);
+    void stampSegment(Stamp& stamp, Vector2 from, Vector2 to);
+    void apply(const Stamp& stamp, int sign);
+};
+
+#endif
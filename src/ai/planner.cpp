@@ -0,0 +1,174 @@
+#include "ai/planner.h"
+#include <algorithm>
+#include "ai/perception.h"
+
+// what an owner can decide to do for commitTicks, first includes the held buttons;
+// shooting is left to the aiming check, like in every rollout
+static const PlannedAction CANDIDATES[] = {
+    {0, 0},                                      // drift
+    {INPUT_ROTATE, INPUT_ROTATE},                // turn
+    {INPUT_BOOST, 0},                            // boost
+    {INPUT_BOOST | INPUT_ROTATE, INPUT_ROTATE},  // boost and turn
+    {INPUT_SPLIT | INPUT_ROTATE, INPUT_ROTATE},  // split
+    {INPUT_SWITCH | INPUT_ROTATE, INPUT_ROTATE}, // switch spaceship
+};
+const int NUM_CANDIDATES = sizeof(CANDIDATES) / sizeof(CANDIDATES[0]);
+
+// chance per tick of a random boost, split or switch in a rollout, about one per REACTION_TIME of the AI
+const uint32_t ROLLOUT_ACTION_ODDS = 30;
+
+bool enemyInSight(const World& world, int owner) {
+    int active = world.activeIndex(owner);
+    if (active < 0) {
+        return false;
+    }
+    const ShipTable& ships = world.ships;
+    Vector2 dir = ships.velocity[active].dir;
+    Vector2 pos = ships.transform[active].pos;
+    for (size_t enemy = 0; enemy < ships.size(); enemy++) {
+        if ((world.relation(owner, ships.owner[enemy]) & RELATION_HIT) && inSight(dir, ships.transform[enemy].pos - pos)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// the policy of every owner after the candidate, what the reactive AI does
+static uint8_t rolloutButtons(Rng& rng) {
+    uint32_t r = rng.below(3 * ROLLOUT_ACTION_ODDS);
+    return r == 0 ? INPUT_BOOST : r == 1 ? INPUT_SPLIT : r == 2 ? INPUT_SWITCH : INPUT_ROTATE;
+}
+
+Planner::Planner(const PlannerConfig& config)
+    : config(config), jobs(nullptr), owner(0), roundsDone(0), nextSlot(0), batchTime(0), active(false) {
+    this->config.rolloutsPerRound = std::max(config.rolloutsPerRound, 1);
+}
+
+void Planner::begin(const World& world, int owner) {
+    if (root == nullptr) {
+        root = std::make_unique<World>(world);
+    } else {
+        *root = world;
+    }
+    // rollouts run inside jobs of their own and nobody reads their hashes
+    jobs = world.jobs;
+    root->jobs = nullptr;
+    root->hashInterval = 0;
+    root->events.clear();
+    this->owner = owner;
+    roundsDone = 0;
+    nextSlot = 0;
+    total.assign(NUM_CANDIDATES, 0.0);
+    scores.resize((size_t)NUM_CANDIDATES * config.rolloutsPerRound);
+    active = world.activeIndex(owner) >= 0;
+}
+
+void Planner::runBatch() {
+    Clock::time_point start = Clock::now();
+    const size_t slots = scores.size();
+    const size_t batch = std::min<size_t>(jobs != nullptr ? jobs->numWorkers() + 1 : 1, slots - nextSlot);
+    while (scratch.size() < batch) {
+        scratch.push_back(*root);
+    }
+    const size_t first = nextSlot;
+    const uint64_t firstSample = (uint64_t)roundsDone * config.rolloutsPerRound;
+    parallelFor(jobs, batch, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            size_t s = first + i;
+            scratch[i] = *root;
+            scores[s] = rollout(scratch[i], s % NUM_CANDIDATES, firstSample + s / NUM_CANDIDATES);
+        }
+    });
+    nextSlot += batch;
+    if (nextSlot == slots) {
+        for (size_t s = 0; s < slots; s++) {
+            total[s % NUM_CANDIDATES] += scores[s];
+        }
+        roundsDone++;
+        nextSlot = 0;
+        if (config.maxRounds > 0 && roundsDone >= config.maxRounds) {
+            active = false;
+        }
+    }
+    batchTime = Clock::now() - start;
+}
+
+bool Planner::think(Clock::time_point deadline) {
+    while (active && Clock::now() + batchTime <= deadline) {
+        runBatch();
+    }
+    return active;
+}
+
+void Planner::finishRound() {
+    while (active && (nextSlot != 0 || roundsDone == 0)) {
+        runBatch();
+    }
+}
+
+PlannedAction Planner::best() const {
+    if (roundsDone == 0) {
+        return {0, 0};
+    }
+    // the first of equal candidates, so ties do not depend on anything but the scores
+    int best = 0;
+    for (int c = 1; c < NUM_CANDIDATES; c++) {
+        if (total[c] > total[best]) {
+            best = c;
+        }
+    }
+    return CANDIDATES[best];
+}
+
+PlannedAction Planner::plan(const World& world, int owner) {
+    begin(world, owner);
+    think(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(config.budgetMs)));
+    if (roundsDone == 0) {
+        finishRound();
+    }
+    return best();
+}
+
+float Planner::rollout(World& world, int candidate, uint64_t sample) const {
+    Rng rng(root->seed ^ ((uint64_t)root->tick << 32) ^ sample, RNG_STREAM_PLANNER + owner);
+    const int players = world.numPlayers();
+    auto values = [&](float& own, float& foes) {
+        own = 0.0f;
+        foes = 0.0f;
+        for (size_t i = 0; i < world.ships.size(); i++) {
+            int other = world.ships.owner[i];
+            if (other == owner) {
+                own += world.ships.value[i];
+            } else if (world.relation(owner, other) & RELATION_HIT) {
+                foes += world.ships.value[i];
+            }
+        }
+    };
+    int numFoes = 0;
+    for (int other = 0; other < players; other++) {
+        numFoes += (world.relation(owner, other) & RELATION_HIT) != 0;
+    }
+    float ownBefore, foesBefore;
+    values(ownBefore, foesBefore);
+
+    const PlannedAction& action = CANDIDATES[candidate];
+    int hits = 0;
+    for (int t = 0; t < config.horizonTicks; t++) {
+        for (int other = 0; other < players; other++) {
+            // drawn for the owner too, so every candidate sees the same futures
+            uint8_t buttons = rolloutButtons(rng);
+            if (other == owner && t < config.commitTicks) {
+                buttons = t == 0 ? action.first : action.held;
+            }
+            world.applyInput(other, enemyInSight(world, other) ? buttons | INPUT_SHOOT : buttons);
+        }
+        world.step();
+        for (const SimEvent& event : world.events) {
+            hits += event.type == SimEventType::SHIP_HIT && event.owner == owner;
+        }
+        world.events.clear();
+    }
+    float ownAfter, foesAfter;
+    values(ownAfter, foesAfter);
+    return ownAfter - ownBefore - (numFoes > 0 ? (foesAfter - foesBefore) / numFoes : 0.0f) + HIT_WEIGHT * hits;
+}
@@ -0,0 +1,94 @@
+#ifndef AI_PLANNER_H
+#define AI_PLANNER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "sim/world.h"
+#include "sim/job_system.h"
+
+struct PlannerConfig {
+    float budgetMs;       // wall time of one decision, spent in rounds of rollouts
+    int horizonTicks;     // length of a rollout
+    int commitTicks;      // a decision is held this long, then the next one is planned
+    int rolloutsPerRound; // per candidate, every round runs candidates * rolloutsPerRound rollouts in parallel
+    int maxRounds;        // 0 for as many as the budget allows
+};
+
+// Buttons of a decision: first on its first tick, held on the others.
+// first includes the held buttons, so a player presses first and holds held.
+struct PlannedAction {
+    uint8_t first;
+    uint8_t held;
+};
+
+// Whether an enemy spaceship is in sight of owner's active one, the aiming
+// check of the reactive AI; rollouts have no Perception, so every foe counts
+// rather than the nearest
+bool enemyInSight(const World& world, int owner);
+
+// Monte Carlo lookahead for one owner.
+// Every candidate action is held for commitTicks on a copy of the world, then
+// every owner (the planning one included) plays like the reactive AI until
+// horizonTicks: turning, shooting at enemies in sight and now and then a
+// random boost, split or switch. Candidates leave the shooting to the same
+// aiming check, the planner decides where to go and when to split or switch. A rollout scores the value the owner gained minus the average
+// its foes gained, plus HIT_WEIGHT per hit it landed; the candidate with the
+// best mean wins. Rollout k of every candidate uses the same random numbers,
+// so candidates are compared on the same futures.
+//
+// A round runs rolloutsPerRound samples of every candidate, in batches of one
+// rollout per thread of the planned world's jobs, and only finished rounds
+// count, so a search can stop between any two batches and go on later.
+// Rollouts run on scratch worlds that are copied over, not rebuilt, so after
+// the first decision a copy reuses every buffer. The rollouts write to their
+// own slots and are merged in order, so for a given number of rounds the
+// decision does not depend on the threads.
+// With a time budget, the number of rounds depends on the machine: matches
+// stay replayable since replays record the buttons, not the decisions.
+class Planner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr float HIT_WEIGHT = 0.5f;
+
+    explicit Planner(const PlannerConfig& config);
+
+    const PlannerConfig& settings() const { return config; }
+
+    // starts a search from a copy of world, the previous one is dropped; the
+    // rollouts run on world.jobs, or on the caller without
+    void begin(const World& world, int owner);
+    // runs batches until the next would end after deadline; false once the
+    // search is done (maxRounds, or no active spaceship)
+    bool think(Clock::time_point deadline);
+    // runs batches until a round is finished, whatever the time
+    void finishRound();
+    // the best candidate so far, nothing before the first round
+    PlannedAction best() const;
+    int rounds() const { return roundsDone; }
+    // wall time of the last batch, zero before the first
+    Clock::duration batchDuration() const { return batchTime; }
+
+    // begin, think for budgetMs (or one round if that takes longer) and best
+    PlannedAction plan(const World& world, int owner);
+
+private:
+    PlannerConfig config;
+    JobSystem* jobs;
+    std::unique_ptr<World> root;
+    std::vector<World> scratch; // one per rollout of a batch
+    std::vector<float> scores;  // per rollout of the current round
+    std::vector<double> total;  // per candidate over the finished rounds
+    int owner;
+    int roundsDone;
+    size_t nextSlot;            // of the current round, candidate slot % NUM_CANDIDATES
+    Clock::duration batchTime;  // of the last batch, to stop before the deadline
+    bool active;
+
+    void runBatch();
+    float rollout(World& world, int candidate, uint64_t sample) const;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "ai/scheduler.h"
+#include <algorithm>
+
+AiScheduler::AiScheduler(const AiSchedulerConfig& config, const PlannerConfig& planner)
+    : config(config), plannerConfig(planner), lastTick(0) {
+    this->config.maxInterval = std::max(config.maxInterval, 1);
+}
+
+void AiScheduler::add(int owner) {
+    agents.push_back({owner, std::make_unique<Planner>(plannerConfig), false, false, {0, 0}, 0, 0, 0.0f, 0.0});
+}
+
+uint32_t AiScheduler::interval(float threat) const {
+    const uint32_t commit = plannerConfig.commitTicks;
+    if (threat <= config.nearDistance) {
+        return commit;
+    }
+    float far = std::clamp((threat - config.nearDistance) / std::max(config.farDistance - config.nearDistance, 1.0f), 0.0f, 1.0f);
+    return commit * (1 + (uint32_t)(far * (config.maxInterval - 1) + 0.5f));
+}
+
+void AiScheduler::decide(Agent& agent, uint32_t tick) {
+    agent.action = agent.planner->best();
+    agent.ready = true;
+    agent.searching = false;
+    agent.dueTick = tick + interval(agent.threat);
+    totals.decisions++;
+}
+
+void AiScheduler::run(const World& world, Perception& perception) {
+    Clock::time_point start = Clock::now();
+    const Clock::time_point cap = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(config.frameMs));
+
+    if (world.tick < lastTick) {
+        for (Agent& agent : agents) {
+            agent.searching = false;
+            agent.ready = false;
+            agent.dueTick = 0;
+        }
+    }
+    lastTick = world.tick;
+    perception.update(world);
+    const float commitSeconds = plannerConfig.commitTicks * world.config.tickDuration;
+
+    order.clear();
+    for (Agent& agent : agents) {
+        if (!agent.searching && world.tick >= agent.dueTick) {
+            agent.planner->begin(world, agent.owner);
+            agent.searching = true;
+            agent.startTick = world.tick;
+            const OwnerPerception& seen = perception.owner(agent.owner);
+            agent.threat = seen.threatTime <= commitSeconds ? 0.0f : seen.threatDistance;
+            agent.spentMs = 0.0;
+        }
+        if (agent.searching) {
+            order.push_back(&agent);
+        }
+    }
+    // due longest first, then the most threatened, then by owner
+    std::sort(order.begin(), order.end(), [](const Agent* a, const Agent* b) {
+        if (a->dueTick != b->dueTick) {
+            return a->dueTick < b->dueTick;
+        }
+        if (a->threat != b->threat) {
+            return a->threat < b->threat;
+        }
+        return a->owner < b->owner;
+    });
+
+    for (Agent* agent : order) {
+        Clock::time_point now = Clock::now();
+        if (now + agent->planner->batchDuration() > cap) {
+            totals.deferred++;
+            continue;
+        }
+        // the budget of a search lasts at least until its first round
+        Clock::time_point slice = now + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(config.thinkMs - agent->spentMs));
+        bool more = agent->planner->think(agent->planner->rounds() > 0 ? std::min(slice, cap) : cap);
+        agent->spentMs += std::chrono::duration<double, std::milli>(Clock::now() - now).count();
+        double batchMs = std::chrono::duration<double, std::milli>(agent->planner->batchDuration()).count();
+        if (!more || (agent->planner->rounds() > 0 && agent->spentMs + batchMs > config.thinkMs)) {
+            decide(*agent, world.tick);
+        }
+    }
+    // stale searches decide with the rounds they have, even without a slice
+    for (Agent* agent : order) {
+        if (agent->searching && agent->planner->rounds() > 0 && world.tick >= agent->startTick + plannerConfig.commitTicks) {
+            decide(*agent, world.tick);
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    totals.runs++;
+    totals.totalMs += ms;
+    totals.maxMs = std::max(totals.maxMs, ms);
+    totals.overruns += ms > config.frameMs;
+}
+
+bool AiScheduler::takeDecision(int owner, PlannedAction& action) {
+    for (Agent& agent : agents) {
+        if (agent.owner == owner && agent.ready) {
+            agent.ready = false;
+            action = agent.action;
+            return true;
+        }
+    }
+    return false;
+}
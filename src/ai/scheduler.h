@@ -0,0 +1,85 @@
+#ifndef AI_SCHEDULER_H
+#define AI_SCHEDULER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ai/planner.h"
+#include "ai/perception.h"
+
+struct AiSchedulerConfig {
+    float frameMs;      // planning of every agent together per run
+    float thinkMs;      // of one decision, spread over as many runs as it takes
+    float nearDistance; // threats closer than this are planned for every commitTicks
+    float farDistance;  // threats beyond this only every maxInterval commitTicks
+    int maxInterval;
+};
+
+// Time-slices the planners of many AI agents.
+// The agents keep aiming and shooting on their own every tick; the scheduler
+// only runs the deep planning. An agent is due for a decision once its last
+// one ran out, which takes one commitTicks with a threat (foe spaceship or
+// projectile) within nearDistance or a projectile about to hit within
+// commitTicks, and stretches to maxInterval of them as the nearest threat
+// gets farther, as the shared Perception sees it. run spends at most frameMs, on the searches
+// that are due longest first and the most threatened among equal ones, each
+// up to what is left of its thinkMs; a search that did not get its budget
+// goes on in the next runs. A search is decided once it has a round and no
+// further batch fits in its budget, or commitTicks after it started, when its
+// world is stale. Agents hold a decision for commitTicks and play
+// reactively until the next one, like the rollouts assume.
+//
+// A batch of rollouts is only started if the last one of its planner would
+// fit before the cap, but cannot be cut short: a run that took longer than
+// frameMs anyway is counted as an overrun. A world that went back
+// in time (a restored snapshot) drops every search and decision.
+class AiScheduler {
+public:
+    using Clock = Planner::Clock;
+
+    struct Stats {
+        uint64_t runs = 0;
+        uint64_t overruns = 0;  // runs longer than frameMs
+        uint64_t decisions = 0;
+        uint64_t deferred = 0;  // searches left without a slice in a run, as it would not fit
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    AiScheduler(const AiSchedulerConfig& config, const PlannerConfig& planner);
+
+    // plans for owner from the next run on
+    void add(int owner);
+    // once per frame, before the agents update; brings perception up to date
+    void run(const World& world, Perception& perception);
+    // the decision for owner finished since the last call, if any
+    bool takeDecision(int owner, PlannedAction& action);
+
+    int commitTicks() const { return plannerConfig.commitTicks; }
+    const Stats& stats() const { return totals; }
+
+private:
+    struct Agent {
+        int owner;
+        std::unique_ptr<Planner> planner;
+        bool searching;
+        bool ready;          // action is a decision not taken yet
+        PlannedAction action;
+        uint32_t dueTick;    // the next search starts at this tick
+        uint32_t startTick;  // of the current search
+        float threat;        // distance to the nearest threat when the search started, 0 for one about to hit
+        double spentMs;      // on the current search
+    };
+
+    AiSchedulerConfig config;
+    PlannerConfig plannerConfig;
+    std::vector<Agent> agents;
+    std::vector<Agent*> order; // of a run, reused
+    uint32_t lastTick;         // of the last run
+    Stats totals;
+
+    uint32_t interval(float threat) const; // ticks until the next decision
+    void decide(Agent& agent, uint32_t tick);
+};
+
+#endif
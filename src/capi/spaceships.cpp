@@ -0,0 +1,215 @@
+#define SPACESHIPS_BUILD
+#include "capi/spaceships.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "sim/world.h"
+#include "sim/snapshot.h"
+#include "sim/hash.h"
+#include "sim/rules.h"
+
+// the views point straight at the component columns, the C structs must match them
+static_assert(sizeof(ss_vec2) == sizeof(Vector2) && offsetof(ss_vec2, y) == offsetof(Vector2, y), "ss_vec2");
+static_assert(sizeof(ss_transform) == sizeof(Transform) && offsetof(ss_transform, angle) == offsetof(Transform, angle), "ss_transform");
+static_assert(sizeof(ss_velocity) == sizeof(Velocity) && offsetof(ss_velocity, speed) == offsetof(Velocity, speed), "ss_velocity");
+static_assert(sizeof(ss_weapon) == sizeof(WeaponState) && offsetof(ss_weapon, ammo) == offsetof(WeaponState, ammo), "ss_weapon");
+static_assert(sizeof(ss_event) == sizeof(SimEvent) && offsetof(ss_event, detail) == offsetof(SimEvent, detail), "ss_event");
+static_assert(sizeof(ProjectileType) == sizeof(int32_t) && sizeof(SimEventType) == sizeof(int32_t), "enums");
+static_assert(sizeof(MinePhase) == sizeof(uint8_t) && sizeof(int) == sizeof(int32_t), "columns");
+static_assert(SS_WEAPON_PLUS == (int)ProjectileType::PLUS && SS_MINE_SPENT == (int)MinePhase::SPENT
+              && SS_EVENT_POWERUP_PICKED == (int)SimEventType::POWERUP_PICKED && SS_INPUT_SWITCH == (int)INPUT_SWITCH, "values");
+
+const int32_t MAX_PLAYERS = 16;
+
+struct ss_world {
+    World world;
+    std::vector<uint8_t> snapshot; // reused by ss_world_snapshot
+};
+
+static SimConfig toConfig(const ss_settings& s) {
+    SimConfig config{};
+    config.w = s.width;
+    config.h = s.height;
+    config.numStartSpaceships = s.num_start_spaceships;
+    config.tickRate = s.tick_rate;
+    config.powerupSpawnInterval = s.powerup_spawn_interval;
+    config.powerupRadius = s.powerup_radius;
+    config.spaceshipSize = s.spaceship_size;
+    config.rotationSpeed = s.rotation_speed;
+    config.forceBoost = s.force_boost;
+    config.drag = s.drag;
+    config.rotBoostDeg = s.rot_boost_deg;
+    config.bulletSpeed = s.bullet_speed;
+    config.bulletRadius = s.bullet_radius;
+    config.bulletLifeTime = s.bullet_life_time;
+    config.laserBeamLifeTime = s.laser_beam_life_time;
+    config.laserBeamWidth = s.laser_beam_width;
+    config.mineActivationDuration = s.mine_activation_duration;
+    config.mineActiveRadius = s.mine_active_radius;
+    config.mineExplosionRadius = s.mine_explosion_radius;
+    config.mineExplosionDuration = s.mine_explosion_duration;
+    config.mineSize = s.mine_size;
+    config.finalize();
+    return config;
+}
+
+template <class T, class U>
+static const T* view(const std::vector<U>& column) {
+    return reinterpret_cast<const T*>(column.data());
+}
+
+extern "C" {
+
+uint32_t ss_api_version(void) {
+    return SS_API_VERSION;
+}
+
+void ss_default_settings(ss_settings* out) {
+    const SimConfig c = TournamentProfile::config();
+    *out = {sizeof(ss_settings), c.w, c.h, c.numStartSpaceships, c.tickRate, c.powerupSpawnInterval, c.powerupRadius,
+            c.spaceshipSize, c.rotationSpeed, c.forceBoost, c.drag, c.rotBoostDeg, c.bulletSpeed, c.bulletRadius,
+            c.bulletLifeTime, c.laserBeamLifeTime, c.laserBeamWidth, c.mineActivationDuration, c.mineActiveRadius,
+            c.mineExplosionRadius, c.mineExplosionDuration, c.mineSize};
+}
+
+ss_world* ss_world_create(const ss_settings* settings, int32_t num_players, const int32_t* teams, uint64_t seed) {
+    if (settings == nullptr || num_players < 2 || num_players > MAX_PLAYERS) {
+        return nullptr;
+    }
+    // fields newer than the caller keep their defaults
+    ss_settings s;
+    ss_default_settings(&s);
+    memcpy(&s, settings, std::min((size_t)settings->size, sizeof(s)));
+    if (s.width <= 0 || s.height <= 0 || s.tick_rate <= 0 || s.num_start_spaceships <= 0) {
+        return nullptr;
+    }
+    std::vector<int> team(num_players);
+    for (int owner = 0; owner < num_players; owner++) {
+        team[owner] = teams != nullptr ? teams[owner] : owner;
+    }
+    // numbered from 0 without gaps
+    if (*std::min_element(team.begin(), team.end()) < 0) {
+        return nullptr;
+    }
+    for (int t = 0, last = *std::max_element(team.begin(), team.end()); t <= last; t++) {
+        if (std::find(team.begin(), team.end(), t) == team.end()) {
+            return nullptr;
+        }
+    }
+    ss_world* world = new ss_world{World(toConfig(s), num_players, seed), {}};
+    world->world.setTeams(team);
+    for (int owner = 0; owner < num_players; owner++) {
+        world->world.spawnPlayer(owner);
+    }
+    return world;
+}
+
+ss_world* ss_world_clone(const ss_world* world) {
+    return new ss_world{world->world, {}};
+}
+
+void ss_world_destroy(ss_world* world) {
+    delete world;
+}
+
+void ss_world_step(ss_world* world, const uint8_t* inputs, uint32_t ticks) {
+    World& w = world->world;
+    const int players = w.numPlayers();
+    w.events.clear();
+    for (uint32_t t = 0; t < ticks; t++) {
+        if (inputs != nullptr) {
+            for (int owner = 0; owner < players; owner++) {
+                w.applyInput(owner, inputs[(size_t)t * players + owner]);
+            }
+        }
+        w.step();
+    }
+}
+
+uint32_t ss_world_tick(const ss_world* world) {
+    return world->world.tick;
+}
+
+int32_t ss_world_num_players(const ss_world* world) {
+    return world->world.numPlayers();
+}
+
+int32_t ss_world_teams_alive(const ss_world* world, int32_t* lowest) {
+    int survivor;
+    int alive = world->world.teamsAlive(survivor);
+    if (lowest != nullptr) {
+        *lowest = survivor;
+    }
+    return alive;
+}
+
+const int32_t* ss_world_active_ships(const ss_world* world) {
+    return view<int32_t>(world->world.activeShip);
+}
+
+const int32_t* ss_world_teams(const ss_world* world) {
+    return view<int32_t>(world->world.team);
+}
+
+const ss_event* ss_world_events(const ss_world* world, size_t* count) {
+    *count = world->world.events.size();
+    return view<ss_event>(world->world.events);
+}
+
+ss_ships_view ss_world_ships(const ss_world* world) {
+    const ShipTable& t = world->world.ships;
+    return {t.size(), view<int32_t>(t.id), view<ss_transform>(t.transform), view<ss_velocity>(t.velocity),
+            view<int32_t>(t.owner), view<int32_t>(t.value), view<ss_weapon>(t.weapon)};
+}
+
+ss_bullets_view ss_world_bullets(const ss_world* world) {
+    const BulletTable& t = world->world.bullets;
+    return {t.size(), view<int32_t>(t.id), view<int32_t>(t.owner), view<ss_vec2>(t.pos), t.angle.data(), t.speed.data(),
+            t.expiresAt.data()};
+}
+
+ss_lasers_view ss_world_lasers(const ss_world* world) {
+    const LaserTable& t = world->world.lasers;
+    return {t.size(), view<int32_t>(t.id), view<int32_t>(t.owner), view<ss_vec2>(t.pos), t.angle.data(), t.expiresAt.data()};
+}
+
+ss_mines_view ss_world_mines(const ss_world* world) {
+    const MineTable& t = world->world.mines;
+    return {t.size(), view<int32_t>(t.id), view<int32_t>(t.owner), view<ss_vec2>(t.pos), view<uint8_t>(t.phase),
+            t.explodeAt.data(), t.spentAt.data()};
+}
+
+ss_powerups_view ss_world_powerups(const ss_world* world) {
+    const PowerupTable& t = world->world.powerups;
+    return {t.size(), view<int32_t>(t.id), view<ss_vec2>(t.pos), t.radius.data(), view<int32_t>(t.type)};
+}
+
+size_t ss_world_snapshot(const ss_world* world, uint8_t* buffer, size_t capacity) {
+    std::vector<uint8_t>& data = const_cast<ss_world*>(world)->snapshot;
+    saveSnapshot(world->world, data);
+    if (buffer != nullptr && data.size() <= capacity) {
+        memcpy(buffer, data.data(), data.size());
+    }
+    return data.size();
+}
+
+int32_t ss_world_restore(ss_world* world, const uint8_t* data, size_t size) {
+    // loadSnapshot checks the values used as indices, the player count is held to what ss_world_create accepts
+    SnapshotHeader header;
+    if (data == nullptr || size < sizeof(header)) {
+        return SS_RESTORE_INVALID;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.numPlayers < 2 || header.numPlayers > MAX_PLAYERS) {
+        return SS_RESTORE_INVALID;
+    }
+    return loadSnapshot(world->world, data, size) ? SS_RESTORE_OK : SS_RESTORE_INVALID;
+}
+
+uint64_t ss_world_hash(const ss_world* world) {
+    return hashWorld(world->world);
+}
+
+}
@@ -0,0 +1,215 @@
+#ifndef SPACESHIPS_H
+#define SPACESHIPS_H
+
+/*
+ * C interface of the simulation, built as libspaceships by make lib.
+ * Nothing here needs SDL: worlds are created from a settings struct, stepped
+ * with the buttons of every player and read through views of the component
+ * columns, the same arrays the simulation works on.
+ *
+ * Compatibility: functions are only ever added. ss_settings is passed with
+ * its size, fields are only appended, so an older caller keeps working with a
+ * newer library. Views stay valid until the next call that changes the world
+ * (step, restore, destroy).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifdef SPACESHIPS_BUILD
+#define SS_API __declspec(dllexport)
+#else
+#define SS_API __declspec(dllimport)
+#endif
+#else
+#define SS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SS_API_VERSION 1
+
+/* InputButton bits, one byte per player and tick */
+enum {
+    SS_INPUT_ROTATE = 1 << 0,
+    SS_INPUT_BOOST = 1 << 1,
+    SS_INPUT_SHOOT = 1 << 2,
+    SS_INPUT_SPLIT = 1 << 3,
+    SS_INPUT_SWITCH = 1 << 4
+};
+
+/* ProjectileType, the weapon of a spaceship and the kind of a powerup */
+enum {
+    SS_WEAPON_BULLET,
+    SS_WEAPON_LASER_BEAM,
+    SS_WEAPON_MINE,
+    SS_WEAPON_PLUS
+};
+
+/* MinePhase */
+enum {
+    SS_MINE_ARMED,
+    SS_MINE_ACTIVATED,
+    SS_MINE_EXPLODING,
+    SS_MINE_SPENT
+};
+
+/* SimEventType */
+enum {
+    SS_EVENT_BULLET_FIRED,
+    SS_EVENT_LASER_FIRED,
+    SS_EVENT_MINE_PLACED,
+    SS_EVENT_MINE_EXPLODED,
+    SS_EVENT_SHIP_HIT,
+    SS_EVENT_SHIP_DESTROYED,
+    SS_EVENT_SHIPS_MERGED,
+    SS_EVENT_SHIP_SPLIT,
+    SS_EVENT_POWERUP_PICKED
+};
+
+/* Gameplay settings of a match, the fields of config.json that the
+ * simulation uses. size is sizeof(ss_settings) of the caller. */
+typedef struct ss_settings {
+    uint32_t size;
+    int32_t width, height;
+    int32_t num_start_spaceships;
+    int32_t tick_rate;
+    float powerup_spawn_interval, powerup_radius;
+    int32_t spaceship_size;
+    float rotation_speed, force_boost, drag, rot_boost_deg;
+    float bullet_speed, bullet_radius, bullet_life_time;
+    float laser_beam_life_time, laser_beam_width;
+    float mine_activation_duration, mine_active_radius, mine_explosion_radius, mine_explosion_duration, mine_size;
+} ss_settings;
+
+typedef struct ss_vec2 {
+    float x, y;
+} ss_vec2;
+
+typedef struct ss_transform {
+    ss_vec2 pos;
+    float angle; /* degrees */
+} ss_transform;
+
+typedef struct ss_velocity {
+    ss_vec2 dir; /* unit direction of travel */
+    float speed;
+} ss_velocity;
+
+typedef struct ss_weapon {
+    int32_t type;      /* SS_WEAPON_* */
+    float cooldown;    /* seconds per reloaded bullet */
+    uint32_t reload_at; /* tick of the next reload, 0 for none */
+    int32_t max_ammo;
+    int32_t ammo;
+} ss_weapon;
+
+typedef struct ss_event {
+    int32_t type;   /* SS_EVENT_* */
+    int32_t owner;  /* the attacker for SS_EVENT_SHIP_HIT */
+    int32_t entity;
+    int32_t detail;
+} ss_event;
+
+/* Columns of the entity tables, count rows each, sorted by id */
+typedef struct ss_ships_view {
+    size_t count;
+    const int32_t* id;
+    const ss_transform* transform;
+    const ss_velocity* velocity;
+    const int32_t* owner;
+    const int32_t* value;
+    const ss_weapon* weapon;
+} ss_ships_view;
+
+typedef struct ss_bullets_view {
+    size_t count;
+    const int32_t* id;
+    const int32_t* owner;
+    const ss_vec2* pos;
+    const float* angle;
+    const float* speed;
+    const uint32_t* expires_at;
+} ss_bullets_view;
+
+typedef struct ss_lasers_view {
+    size_t count;
+    const int32_t* id;
+    const int32_t* owner;
+    const ss_vec2* pos;
+    const float* angle;
+    const uint32_t* expires_at;
+} ss_lasers_view;
+
+typedef struct ss_mines_view {
+    size_t count;
+    const int32_t* id;
+    const int32_t* owner;
+    const ss_vec2* pos;
+    const uint8_t* phase; /* SS_MINE_* */
+    const uint32_t* explode_at;
+    const uint32_t* spent_at;
+} ss_mines_view;
+
+typedef struct ss_powerups_view {
+    size_t count;
+    const int32_t* id;
+    const ss_vec2* pos;
+    const float* radius;
+    const int32_t* type; /* SS_WEAPON_* */
+} ss_powerups_view;
+
+typedef struct ss_world ss_world;
+
+SS_API uint32_t ss_api_version(void);
+/* the tournament rules, size is filled in */
+SS_API void ss_default_settings(ss_settings* out);
+
+/* A match of num_players (2 to 16) whose spaceships are spawned, teams[owner]
+ * numbered from 0 without gaps or NULL for every owner on its own.
+ * NULL if the arguments are invalid. */
+SS_API ss_world* ss_world_create(const ss_settings* settings, int32_t num_players, const int32_t* teams, uint64_t seed);
+SS_API ss_world* ss_world_clone(const ss_world* world);
+SS_API void ss_world_destroy(ss_world* world);
+
+/* Steps ticks ticks, inputs holds num_players buttons per tick, or is NULL
+ * for no buttons. The events of these ticks replace the previous ones. */
+SS_API void ss_world_step(ss_world* world, const uint8_t* inputs, uint32_t ticks);
+
+SS_API uint32_t ss_world_tick(const ss_world* world);
+SS_API int32_t ss_world_num_players(const ss_world* world);
+/* teams with spaceships left, the lowest of them in *lowest if not NULL */
+SS_API int32_t ss_world_teams_alive(const ss_world* world, int32_t* lowest);
+/* entity id of the active spaceship per owner, -1 for none */
+SS_API const int32_t* ss_world_active_ships(const ss_world* world);
+SS_API const int32_t* ss_world_teams(const ss_world* world);
+SS_API const ss_event* ss_world_events(const ss_world* world, size_t* count);
+
+SS_API ss_ships_view ss_world_ships(const ss_world* world);
+SS_API ss_bullets_view ss_world_bullets(const ss_world* world);
+SS_API ss_lasers_view ss_world_lasers(const ss_world* world);
+SS_API ss_mines_view ss_world_mines(const ss_world* world);
+SS_API ss_powerups_view ss_world_powerups(const ss_world* world);
+
+/* Writes the snapshot if it fits in capacity, returns its size either way */
+SS_API size_t ss_world_snapshot(const ss_world* world, uint8_t* buffer, size_t capacity);
+/* results of ss_world_restore, a failure is 0 so `if (!ss_world_restore(...))` keeps working */
+enum {
+    SS_RESTORE_OK = 1,
+    /* the world is left untouched: the data is truncated, was written by another
+     * version, or holds fewer than 2 or more than 16 players, a non-positive
+     * arena or tick rate, or owners or teams of no player */
+    SS_RESTORE_INVALID = 0
+};
+SS_API int32_t ss_world_restore(ss_world* world, const uint8_t* data, size_t size);
+/* hash of the whole simulation state, equal for equal worlds */
+SS_API uint64_t ss_world_hash(const ss_world* world);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
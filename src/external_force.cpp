@@ -3,51 +3,49 @@
 Force::Force(ForceType type, float strength, float radius, Vector2 position)
     : type(type), strength(strength), radius(radius), position(position) {}
 
-void Force::apply(float delta, const std::vector<std::shared_ptr<Spaceship>>& spaceships, const std::vector<std::shared_ptr<Projectile>>& projectiles) {
-    for (auto& spaceship : spaceships) {
-        float distance = (spaceship->pos - position).magnitude();
+void Force::apply(float delta, World& world) {
+    ShipTable& ships = world.ships;
+    for (size_t i = 0; i < ships.size(); i++) {
+        Vector2 pos = ships.transform[i].pos;
+        float distance = (pos - position).magnitude();
         if (distance < radius) {
             float force = strength * (1 - distance / radius);
-            Vector2 direction = (position - spaceship->pos).normalize();
+            Vector2 direction = (position - pos).normalize();
             if (type == ForceType::Repulsion) {
                 direction = Vector2(0, 0) - direction;
             }
-            spaceship->velocity += direction * force * delta;
+            ships.velocity[i].dir += direction * force * delta;
         }
     }
 
-    // projectile has angle and speed instead of velocity and speed
-    // cast projectile to derived class to access angle
-    for (auto& projectile : projectiles) {
-        std::shared_ptr<Bullet> bullet = std::dynamic_pointer_cast<Bullet>(projectile);
-        if (bullet) {
-            float distance = (bullet->pos - position).magnitude();
-            if (distance < radius) {
-                float force = strength * (1 - distance / radius);
-                Vector2 direction = (position - bullet->pos).normalize();
-                if (type == ForceType::Repulsion) {
-                    direction = Vector2(0, 0) - direction;
-                }
-                // calculate angle of the direction
-                float angle = std::atan2(direction.y, direction.x);
-                angle = rad2deg(angle);
-                bullet->angle = angle;
-                bullet->speed = force;
+    // bullets have angle and speed instead of velocity and speed
+    BulletTable& bullets = world.bullets;
+    for (size_t i = 0; i < bullets.size(); i++) {
+        float distance = (bullets.pos[i] - position).magnitude();
+        if (distance < radius) {
+            float force = strength * (1 - distance / radius);
+            Vector2 direction = (position - bullets.pos[i]).normalize();
+            if (type == ForceType::Repulsion) {
+                direction = Vector2(0, 0) - direction;
             }
+            // calculate angle of the direction
+            float angle = std::atan2(direction.y, direction.x);
+            bullets.angle[i] = rad2deg(angle);
+            bullets.speed[i] = force;
         }
+    }
 
-        std::shared_ptr<Mine> mine = std::dynamic_pointer_cast<Mine>(projectile);
-        // mine get dragged by the force, and only has pos
-        if (mine) {
-            float distance = (mine->pos - position).magnitude();
-            if (distance < radius) {
-                float force = strength * (1 - distance / radius);
-                Vector2 direction = (position - mine->pos).normalize();
-                if (type == ForceType::Repulsion) {
-                    direction = Vector2(0, 0) - direction;
-                }
-                mine->pos += direction * force * delta;
+    // mines get dragged by the force, and only have pos
+    MineTable& mines = world.mines;
+    for (size_t i = 0; i < mines.size(); i++) {
+        float distance = (mines.pos[i] - position).magnitude();
+        if (distance < radius) {
+            float force = strength * (1 - distance / radius);
+            Vector2 direction = (position - mines.pos[i]).normalize();
+            if (type == ForceType::Repulsion) {
+                direction = Vector2(0, 0) - direction;
             }
+            mines.pos[i] += direction * force * delta;
         }
     }
 }
@@ -2,11 +2,8 @@
 #define EXTERNAL_FORCE_H
 
 #include "math.h"
-#include "spaceship.h"
-#include "projectile.h"
 #include "settings.h"
-#include <memory>
-#include <vector>
+#include "sim/world.h"
 #include "utils.h"
 
 class Force {
@@ -17,7 +14,7 @@ private:
     Vector2 position;
 public:
     Force(ForceType type, float strength, float radius, Vector2 position);
-    void apply(float delta, const std::vector<std::shared_ptr<Spaceship>>& spaceships, const std::vector<std::shared_ptr<Projectile>>& projectiles);
+    void apply(float delta, World& world);
     void render(SDL_Renderer* renderer) const;
 };
 
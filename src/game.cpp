@@ -2,18 +2,23 @@
 #include <iostream>
 #include <algorithm>
 #include <cstdlib>
+#include <thread>
 #include "utils.h"
 #include "ui.h"
+#include "render.h"
+#include "sim/snapshot.h"
 
+// F5 saves the running match, F9 resumes it
+const char* QUICKSAVE_PATH = "quicksave.snap";
+// every match is recorded here, play it back with game --replay last.replay
+const char* LAST_REPLAY_PATH = "last.replay";
 
 Game::Game() 
-    : settings(GameSettings::get()), window(nullptr), renderer(nullptr), player1(nullptr), player2(nullptr), powerupSpawnTimer(0.0f)
+    : settings(GameSettings::get()), window(nullptr), renderer(nullptr), world(nullptr), simTime(0.0f),
+      jobs(std::max(1u, std::thread::hardware_concurrency()) - 1)
 {}
 
 bool Game::init() {
-    // init random seed
-    srand(time(nullptr));
-
     // Init
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         std::cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
@@ -119,17 +124,27 @@ Game::~Game() {
 }
 
 void Game::reset() {
-    powerups.clear();
-    powerupSpawnTimer = 0.0f;
+    // the next match brings its own agents, and AI only if it has any: the
+    // AI agents point into the scheduler and perception, so they go first
+    agents.clear();
+    aiScheduler = nullptr;
+    aiPerception = nullptr;
+    world = nullptr;
+    simTime = 0.0f;
     clk.reset();
 }
 
-std::shared_ptr<Agent> Game::getPlayer1() {
-    return player1;
-}
-
-std::shared_ptr<Agent> Game::getPlayer2() {
-    return player2;
+void Game::playSounds() {
+    for (const SimEvent& event : world->events) {
+        if (event.type == SimEventType::BULLET_FIRED) {
+            Mix_PlayMusic(settings->sdlSettings->bulletSound, 1);
+        } else if (event.type == SimEventType::LASER_FIRED) {
+            Mix_PlayMusic(settings->sdlSettings->laserSound, 1);
+        } else if (event.type == SimEventType::MINE_EXPLODED) {
+            Mix_PlayMusic(settings->sdlSettings->mineSound, 1);
+        }
+    }
+    world->events.clear();
 }
 
 void Game::playerMenu() {
@@ -146,8 +161,8 @@ void Game::playerMenu() {
         SDL_Color{255, 0, 0},
         renderTextAsTexture(renderer, settings->sdlSettings->font, "Human Player", SDL_Color{255, 255, 255}), 
         [&]() {
-        player1 = std::make_shared<Player>(1);
-        player2 = std::make_shared<Player>(2);
+        world = std::make_shared<World>(settings->simConfig(), 2, time(nullptr));
+        agents = {std::make_shared<Player>(1, world.get()), std::make_shared<Player>(2, world.get())};
         ui.stop();
     });
 
@@ -157,13 +172,39 @@ void Game::playerMenu() {
         SDL_Color{0, 255, 0}, 
         renderTextAsTexture(renderer, settings->sdlSettings->font, "AI Player", SDL_Color{255, 255, 255}), 
         [&]() {
-        player1 = std::make_shared<Player>(1);
-        player2 = std::make_shared<AI>(2, this);
+        world = std::make_shared<World>(settings->simConfig(), 2, time(nullptr));
+        aiPerception = std::make_unique<Perception>();
+        aiScheduler = makeAiScheduler(world->config, settings->aiThinkMs, settings->aiFrameMs);
+        agents = {std::make_shared<Player>(1, world.get()), std::make_shared<AI>(2, world.get(), aiPerception.get(), aiScheduler.get())};
+        ui.stop();
+    });
+
+    // player 1 and the AI for everybody else, teammates side by side
+    Button btnTeamMatch(
+        Vector2(w / 2 - btnW / 2, h / 2 - btnH / 2), 
+        Vector2(btnW, btnH), 
+        SDL_Color{0, 0, 255}, 
+        renderTextAsTexture(renderer, settings->sdlSettings->font, "Team Match", SDL_Color{255, 255, 255}), 
+        [&]() {
+        int players = settings->teamMatchPlayers, teams = settings->teamMatchTeams;
+        world = std::make_shared<World>(settings->simConfig(), players, time(nullptr));
+        std::vector<int> team(players);
+        for (int owner = 0; owner < players; owner++) {
+            team[owner] = owner * teams / players;
+        }
+        world->setTeams(team);
+        aiPerception = std::make_unique<Perception>();
+        aiScheduler = makeAiScheduler(world->config, settings->aiThinkMs, settings->aiFrameMs);
+        agents = {std::make_shared<Player>(1, world.get())};
+        for (int owner = 1; owner < players; owner++) {
+            agents.push_back(std::make_shared<AI>(owner + 1, world.get(), aiPerception.get(), aiScheduler.get()));
+        }
         ui.stop();
     });
 
     ui.addComponent(std::make_shared<Button>(btnHumanPlayer));
     ui.addComponent(std::make_shared<Button>(btnAIPlayer));
+    ui.addComponent(std::make_shared<Button>(btnTeamMatch));
 
     while (ui.isRunning()) {
         SDL_Event event;
@@ -241,8 +282,13 @@ void Game::tutorialMenu() {
 
 int Game::gameLoop() {
     bool running = true;
+    world->jobs = &jobs;
+    replay.begin(*world);
+    std::vector<uint8_t> buttons(world->numPlayers());
+    int survivor;
     while (running) {
         float deltaTime = clk.delta();
+        bool fighting = world->teamsAlive(survivor) > 1;
 
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
@@ -250,63 +296,55 @@ int Game::gameLoop() {
                 exit(0);
                 return false;
             }
-            if (player1->hasSpaceship() && player2->hasSpaceship()) {
-                player1->handleEvent(event);
-                player2->handleEvent(event);
+            if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_F5) {
+                saveSnapshotFile(*world, QUICKSAVE_PATH);
+            } else if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_F9) {
+                // only a quicksave of this match setup can be resumed
+                World saved = *world;
+                if (loadSnapshotFile(saved, QUICKSAVE_PATH) && saved.numPlayers() == world->numPlayers()) {
+                    *world = std::move(saved);
+                    replay.begin(*world);
+                }
+            }
+            if (fighting) {
+                for (auto& agent : agents) {
+                    agent->handleEvent(event);
+                }
             }
         }
 
-        handleProjectileCollision();
-        handleAdversarialCollision();
-        handleMergeCollision();
-        handlePowerupCollision();
-
         // Update game state
-        if (player1->hasSpaceship() && player2->hasSpaceship()) {
-            player1->update(deltaTime);
-            player2->update(deltaTime);
+        if (fighting) {
+            if (aiScheduler != nullptr) {
+                aiScheduler->run(*world, *aiPerception);
+            }
+            for (auto& agent : agents) {
+                agent->update(deltaTime);
+            }
         }
-
-        // Spawn powerups
-        powerupSpawnTimer += deltaTime;
-        if (powerupSpawnTimer >= settings->powerupSpawnInterval) {
-            powerupSpawnTimer = 0.0f;
-            float x = rand() % settings->w;
-            float y = rand() % settings->h;
-
-            // random laser beam or mine
-            // ProjectileType type = rand() % 2 == 0 ? ProjectileType::LASER_BEAM : ProjectileType::MINE;
-            int r = rand() % 3;
-            ProjectileType pw[]{ProjectileType::LASER_BEAM, ProjectileType::MINE, ProjectileType::PLUS};
-            ProjectileType type = pw[r];
-            //! TODO: update mine before enabling it
-            // ProjectileType type = ProjectileType::LASER_BEAM;
-            Powerup powerup(Vector2(x, y), 10.0f, type);
-            powerups.push_back(powerup);
+        // the simulation runs at a fixed tick rate whatever the frame rate is,
+        // a long frame is caught up with several ticks
+        simTime = std::min(simTime + deltaTime, 0.25f);
+        while (simTime >= world->config.tickDuration) {
+            for (int owner = 0; owner < world->numPlayers(); owner++) {
+                buttons[owner] = agents[owner]->takeInput();
+                world->applyInput(owner, buttons[owner]);
+            }
+            replay.record(buttons.data());
+            world->step();
+            broadcast.push(*world);
+            simTime -= world->config.tickDuration;
         }
+        playSounds();
 
         // background
         SDL_RenderCopy(renderer, settings->sdlSettings->background, nullptr, nullptr);
 
-        player1->render(renderer);
-        player2->render(renderer);
-
-        for (auto& powerup : powerups) {
-            powerup.render(renderer);
-        }
+        renderWorld(renderer, *world, *settings);
 
-        if (!player1->hasSpaceship() && !player2->hasSpaceship()) {
-            // SDL_Rect dstRect = {settings->w / 2 - 100, settings->h / 2 - 50, 200, 100};
-            // SDL_RenderCopy(renderer, settings->sdlSettings->stalemateText, nullptr, &dstRect);
-            return 0;
-        } else if (!player1->hasSpaceship()) {
-            // SDL_Rect dstRect = {settings->w / 2 - 100, settings->h / 2 - 50, 200, 100};
-            // SDL_RenderCopy(renderer, settings->sdlSettings->player2WinText, nullptr, &dstRect);
-            return 2;
-        } else if (!player2->hasSpaceship()) {
-            // SDL_Rect dstRect = {settings->w / 2 - 100, settings->h / 2 - 50, 200, 100};
-            // SDL_RenderCopy(renderer, settings->sdlSettings->player1WinText, nullptr, &dstRect);
-            return 1;
+        // the last team standing wins, every owner is a team of its own outside team matches
+        if (world->teamsAlive(survivor) <= 1) {
+            return survivor + 1;
         }
 
         SDL_RenderPresent(renderer);
@@ -320,7 +358,8 @@ bool Game::gameOverMenu(int winner) {
     int h = settings->h;
     bool cont = true;
     UI ui;
-    std::string status = winner == 0 ? "Stalemate" : winner == 1 ? "Player 1 Win" : "Player 2 Win";
+    bool teamMatch = world != nullptr && world->numTeams() < world->numPlayers();
+    std::string status = winner == 0 ? "Stalemate" : (teamMatch ? "Team " : "Player ") + std::to_string(winner) + " Win";
     TextArea text(
         Vector2(w / 2 - 100, h / 4), 
         Vector2(200, 100), 
@@ -346,10 +385,21 @@ bool Game::gameOverMenu(int winner) {
         cont = false;
         ui.stop();
     });
+    bool watch = false;
+    Button btnReplay(
+        Vector2(w / 2 - 150, h / 2 + 150), 
+        Vector2(300, 100), 
+        SDL_Color{0, 0, 255}, 
+        renderTextAsTexture(renderer, settings->sdlSettings->font, "Replay", SDL_Color{255, 255, 255}), 
+        [&]() {
+        watch = true;
+        ui.stop();
+    });
 
     ui.addComponent(std::make_shared<TextArea>(text));
     ui.addComponent(std::make_shared<Button>(btnRestart));
     ui.addComponent(std::make_shared<Button>(btnQuit));
+    ui.addComponent(std::make_shared<Button>(btnReplay));
 
     while (ui.isRunning()) {
         SDL_Event event;
@@ -367,217 +417,385 @@ bool Game::gameOverMenu(int winner) {
         SDL_Delay(1000 / settings->fps);
     }
 
+    if (watch) {
+        playback(replay);
+        return gameOverMenu(winner);
+    }
     return cont;
 }
 
-void Game::run() {
-    bool cont = true;
-    while (cont) {
-        playerMenu();
-        tutorialMenu();
-        int winner = gameLoop();
-        cont = gameOverMenu(winner);
-        reset();
+// Space pauses, Left/Right seek 5 seconds, Up/Down double or halve the speed,
+// Home goes back to the start and Escape leaves
+void Game::playback(const Replay& recorded) {
+    ReplayPlayer player;
+    if (!player.open(recorded)) {
+        std::cerr << "Replay was recorded by an incompatible version" << std::endl;
+        return;
     }
-}
+    player.world.jobs = &jobs;
+    const float tickDuration = player.world.config.tickDuration;
+    const uint32_t seekTicks = player.world.config.ticks(5.0f);
+    float speed = 1.0f;
+    bool paused = false;
+    float playTime = 0.0f;
+    clk.reset();
+    while (true) {
+        float deltaTime = clk.delta();
 
-void Game::handleAdversarialCollision() {
-    auto p1s = player1->getSpaceships();
-    auto p2s = player2->getSpaceships();
-    std::vector<int> p1collisionCnt(p1s.size(), 0);
-    std::vector<int> p2collisionCnt(p2s.size(), 0);
-
-    for (int i = 0; i < p1s.size(); i++) {
-        for (int j = 0; j < p2s.size(); j++) {
-            auto p1 = p1s[i];
-            auto p2 = p2s[j];
-            auto p1c = p1->getCollisionShape();
-            auto p2c = p2->getCollisionShape();
-            if (p1c.collides(p2c)) {
-                p1collisionCnt[i]++;
-                p2collisionCnt[j]++;
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                exit(0);
             }
-            if (p1c.collides(p2c) && p1->readyForOppositeSideCollision && p2->readyForOppositeSideCollision) {
-                p1->value--;
-                p2->value--;
-                auto diff = p1->pos - p2->pos;
-                p1->velocity = (p1->velocity + (p1->pos - p2->pos) * p1->speed).normalize();
-                p2->velocity = (p2->velocity + (p2->pos - p1->pos) * p2->speed).normalize();
-                p1->speed = (p1->speed + p2->speed) / 2;
-                p2->speed = p1->speed;
-                p1->readyForOppositeSideCollision = false;
-                p2->readyForOppositeSideCollision = false;
+            if (event.type != SDL_KEYDOWN) {
+                continue;
+            }
+            switch (event.key.keysym.scancode) {
+                case SDL_SCANCODE_ESCAPE:
+                    return;
+                case SDL_SCANCODE_SPACE:
+                    paused = !paused;
+                    break;
+                case SDL_SCANCODE_LEFT:
+                    player.seek(player.tick() > seekTicks ? player.tick() - seekTicks : 0);
+                    break;
+                case SDL_SCANCODE_RIGHT:
+                    player.seek(player.tick() + seekTicks);
+                    break;
+                case SDL_SCANCODE_HOME:
+                    player.seek(0);
+                    break;
+                case SDL_SCANCODE_UP:
+                    speed = std::min(speed * 2.0f, 16.0f);
+                    break;
+                case SDL_SCANCODE_DOWN:
+                    speed = std::max(speed / 2.0f, 0.125f);
+                    break;
+                default:
+                    break;
             }
         }
-    }
 
-    for (int i = 0; i < p1s.size(); i++) {
-        if (p1collisionCnt[i] == 0) {
-            p1s[i]->readyForOppositeSideCollision = true;
-        }
-    }
-    for (int i = 0; i < p2s.size(); i++) {
-        if (p2collisionCnt[i] == 0) {
-            p2s[i]->readyForOppositeSideCollision = true;
+        if (!paused) {
+            playTime = std::min(playTime + deltaTime * speed, 0.25f * speed);
+            while (playTime >= tickDuration && player.stepForward()) {
+                playTime -= tickDuration;
+            }
         }
+
+        SDL_RenderCopy(renderer, settings->sdlSettings->background, nullptr, nullptr);
+        renderWorld(renderer, player.world, *settings);
+
+        // progress bar along the bottom edge
+        SDL_Rect bar = {0, settings->h - 4, int((int64_t)settings->w * player.tick() / std::max(player.length(), 1u)), 4};
+        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+        SDL_RenderFillRect(renderer, &bar);
+
+        SDL_RenderPresent(renderer);
+        SDL_Delay(1000 / settings->fps);
     }
+}
 
+bool Game::watchReplay(const char* path) {
+    Replay recorded;
+    if (!loadReplayFile(recorded, path)) {
+        std::cerr << "Failed to load replay " << path << std::endl;
+        return false;
+    }
+    playback(recorded);
+    return true;
 }
 
-void Game::handleMergeCollision() {
-    auto p1s = player1->getSpaceships();
-    auto p2s = player2->getSpaceships();
-    std::vector<int> p1collisionCnt(p1s.size(), 0);
-    std::vector<int> p2collisionCnt(p2s.size(), 0);
-
-    for (int i = 0; i < p1s.size(); i++) {
-        for (int j = i + 1; j < p1s.size(); j++) {
-            auto p1 = p1s[i];
-            auto p2 = p1s[j];
-            auto p1c = p1->getCollisionShape();
-            auto p2c = p2->getCollisionShape();
-            if (p1c.collides(p2c)) {
-                p1collisionCnt[i]++;
-                p1collisionCnt[j]++;
-            }
-            if (p1c.collides(p2c) && p1->readyForSameSideCollision && p2->readyForSameSideCollision) {
-                player1->mergeSpaceships(p1->id, p2->id);
+// Like gameLoop, with the other player's input coming from the session.
+// The match is decided on a second world that only runs confirmed ticks, so
+// both sides end on the same tick with the same winner whatever they predicted.
+// Returns the winner like gameLoop, -1 if the connection broke.
+int Game::onlineLoop(RollbackSession& session, Agent& local) {
+    World confirmed = *world;
+    replay.begin(confirmed);
+    while (true) {
+        float deltaTime = clk.delta();
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                exit(0);
             }
+            local.handleEvent(event);
         }
-    }
+        local.update(deltaTime);
 
-    for (int i = 0; i < p1s.size(); i++) {
-        if (p1collisionCnt[i] == 0) {
-            p1s[i]->readyForSameSideCollision = true;
+        simTime = std::min(simTime + deltaTime, 0.25f);
+        while (simTime >= world->config.tickDuration) {
+            session.poll();
+            if (session.readyToAdvance()) {
+                session.advance(local.takeInput());
+            }
+            simTime -= world->config.tickDuration;
+        }
+        if (session.desynced()) {
+            std::cerr << "Out of sync with the other player since tick " << session.desyncedAt() << std::endl;
+            return -1;
+        }
+        if (session.disconnected()) {
+            std::cerr << "Lost the connection to the other player" << std::endl;
+            return -1;
         }
-    }
 
-    for (int i = 0; i < p2s.size(); i++) {
-        for (int j = i + 1; j < p2s.size(); j++) {
-            auto p1 = p2s[i];
-            auto p2 = p2s[j];
-            auto p1c = p1->getCollisionShape();
-            auto p2c = p2->getCollisionShape();
-            if (p1c.collides(p2c)) {
-                p2collisionCnt[i]++;
-                p2collisionCnt[j]++;
+        while (confirmed.tick < session.confirmedFrame()) {
+            uint8_t buttons[2];
+            session.confirmedInputs(confirmed.tick, buttons);
+            for (int owner = 0; owner < 2; owner++) {
+                confirmed.applyInput(owner, buttons[owner]);
             }
-            if (p1c.collides(p2c) && p1->readyForSameSideCollision && p2->readyForSameSideCollision) {
-                player2->mergeSpaceships(p1->id, p2->id);
+            replay.record(buttons);
+            confirmed.step();
+            broadcast.push(confirmed);
+            confirmed.events.clear();
+            if (!confirmed.hasSpaceship(0) || !confirmed.hasSpaceship(1)) {
+                // keep answering for a moment, the other side may still miss our last inputs
+                for (Uint32 until = SDL_GetTicks() + 1000; SDL_GetTicks() < until; SDL_Delay(1000 / settings->fps)) {
+                    session.poll();
+                }
+                return confirmed.hasSpaceship(0) ? 1 : confirmed.hasSpaceship(1) ? 2 : 0;
             }
         }
+        playSounds();
+
+        SDL_RenderCopy(renderer, settings->sdlSettings->background, nullptr, nullptr);
+        renderWorld(renderer, *world, *settings);
+        SDL_RenderPresent(renderer);
+
+        SDL_Delay(1000 / settings->fps);
+    }
+}
+
+bool Game::playOnline(int localPlayer, const char* address) {
+    UdpSocket socket;
+    NetAddress peer = {0, 0};
+    if (localPlayer == 1 && !NetAddress::parse(address, peer)) {
+        std::cerr << "Cannot resolve " << address << std::endl;
+        return false;
+    }
+    if (!socket.open(localPlayer == 0 ? atoi(address) : 0)) {
+        std::cerr << "Cannot open a UDP socket" << std::endl;
+        return false;
     }
 
-    for (int i = 0; i < p2s.size(); i++) {
-        if (p2collisionCnt[i] == 0) {
-            p2s[i]->readyForSameSideCollision = true;
+    // the window stays responsive while waiting, Escape gives up
+    uint64_t seed = time(nullptr);
+    SDL_Texture* waiting = renderTextAsTexture(renderer, settings->sdlSettings->font,
+        localPlayer == 0 ? "Waiting for player 2" : "Connecting", SDL_Color{255, 255, 255});
+    SDL_Rect waitingRect = {settings->w / 2 - 150, settings->h / 2 - 25, 300, 50};
+    while (!connectPeer(socket, localPlayer, peer, seed, 1.0f / settings->fps)) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                exit(0);
+            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_ESCAPE) {
+                SDL_DestroyTexture(waiting);
+                return false;
+            }
         }
+        SDL_RenderCopy(renderer, settings->sdlSettings->background, nullptr, nullptr);
+        SDL_RenderCopy(renderer, waiting, nullptr, &waitingRect);
+        SDL_RenderPresent(renderer);
     }
+    SDL_DestroyTexture(waiting);
 
+    // both sides spawn the players in owner order, online everyone plays with the keys of player 1
+    world = std::make_shared<World>(settings->simConfig(), 2, seed);
+    if (localPlayer == 1) {
+        world->spawnPlayer(0);
+    }
+    Player local(localPlayer + 1, world.get(), 0);
+    if (localPlayer == 0) {
+        world->spawnPlayer(1);
+    }
+    world->jobs = &jobs;
+    RollbackSession session(*world, socket, peer, localPlayer, seed, DEFAULT_ROLLBACK);
+    clk.reset();
+    int winner = onlineLoop(session, local);
+    reset();
+    if (winner < 0) {
+        return false;
+    }
+    saveReplayFile(replay, LAST_REPLAY_PATH);
+    // Restart connects again, the other player has to restart as well
+    return gameOverMenu(winner);
 }
 
-void Game::handleProjectileCollision() {
-    auto p1s = player1->getSpaceships();
-    auto p2s = player2->getSpaceships();
-    auto p1p = player1->getProjectiles();
-    auto p2p = player2->getProjectiles();
-
-    for (auto projectile : p1p) {
-        for (auto ship : p2s) {
-            if (projectile->isCollidingWith(ship->getCollisionShape())) {
-                if (projectile->getType() == ProjectileType::BULLET) {
-                    ship->value--;
-                    auto bullet = std::dynamic_pointer_cast<Bullet>(projectile);
-                    bullet->eol = true;
-                } else if (projectile->getType() == ProjectileType::MINE) {
-                    auto proj = std::dynamic_pointer_cast<Mine>(projectile);
-                    // activated by the enemy
-                    if (!proj->activated) {
-                        proj->activated = true;
-                    }
-                } else {
-                    ship->value = 0;
-                }
-            }
-        }
+// The server runs the match, this side only sends the buttons of the local
+// player and draws the snapshots it gets back.
+bool Game::playServer(const char* address) {
+    UdpSocket socket;
+    NetAddress server = {0, 0};
+    if (!NetAddress::parse(address, server)) {
+        std::cerr << "Cannot resolve " << address << std::endl;
+        return false;
+    }
+    if (!socket.open(0)) {
+        std::cerr << "Cannot open a UDP socket" << std::endl;
+        return false;
     }
 
-    for (auto projectile : p2p) {
-        for (auto ship : p1s) {
-            if (projectile->isCollidingWith(ship->getCollisionShape())) {
-                if (projectile->getType() == ProjectileType::BULLET) {
-                    ship->value--;
-                    // invalidate the projectile
-                    auto bullet = std::dynamic_pointer_cast<Bullet>(projectile);
-                    bullet->eol = true;
-                } else if (projectile->getType() == ProjectileType::MINE) {
-                    auto proj = std::dynamic_pointer_cast<Mine>(projectile);
-                    // activated by the enemy
-                    if (!proj->activated) {
-                        proj->activated = true;
-                    }
-                } else {
-                    ship->value = 0;
-                }
+    StateClient client(socket, server);
+    SDL_Texture* waiting = renderTextAsTexture(renderer, settings->sdlSettings->font, "Connecting", SDL_Color{255, 255, 255});
+    SDL_Rect waitingRect = {settings->w / 2 - 150, settings->h / 2 - 25, 300, 50};
+    while (!client.connect(1.0f / settings->fps)) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                exit(0);
+            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_ESCAPE) {
+                SDL_DestroyTexture(waiting);
+                return false;
             }
         }
+        SDL_RenderCopy(renderer, settings->sdlSettings->background, nullptr, nullptr);
+        SDL_RenderCopy(renderer, waiting, nullptr, &waitingRect);
+        SDL_RenderPresent(renderer);
     }
+    SDL_DestroyTexture(waiting);
 
-    p1s.insert(p1s.end(), p2s.begin(), p2s.end()); // all spaceships
-    p1p.insert(p1p.end(), p2p.begin(), p2p.end()); // all projectiles
-    // mine of any player will kill all spaceships in range if exploded
-    for (auto projectile : p1p) {
-        for (auto ship : p1s) {
-            if (projectile->getType() == ProjectileType::MINE) {
-                auto proj = std::dynamic_pointer_cast<Mine>(projectile);
-                if (proj->exploding && proj->isCollidingWith(ship->getCollisionShape())) {
-                    ship->value = 0;
-                }
+    // view only holds what the snapshots describe, it is never stepped
+    World view(settings->simConfig(), client.numPlayers(), 0);
+    std::unique_ptr<Player> local;
+    if (client.owner() >= 0) {
+        local = std::make_unique<Player>(client.owner() + 1, &view, 0);
+    }
+    StateFrame frame;
+    clk.reset();
+    while (!client.disconnected()) {
+        float deltaTime = clk.delta();
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                exit(0);
             }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_ESCAPE) {
+                return true;
+            }
+            if (local) {
+                local->handleEvent(event);
+            }
+        }
+        if (local) {
+            local->update(deltaTime);
+        }
+
+        // spectators send empty inputs, they acknowledge the snapshots all the same
+        simTime = std::min(simTime + deltaTime, 0.25f);
+        while (simTime >= view.config.tickDuration) {
+            client.sendInput(local ? local->takeInput() : 0);
+            simTime -= view.config.tickDuration;
         }
+        client.poll();
+        client.advance(deltaTime, view.config.tickRate);
+
+        SDL_RenderCopy(renderer, settings->sdlSettings->background, nullptr, nullptr);
+        if (client.sample(frame)) {
+            buildView(frame, view);
+            renderWorld(renderer, view, *settings);
+        }
+        SDL_RenderPresent(renderer);
+
+        SDL_Delay(1000 / settings->fps);
     }
+    std::cerr << "Lost the connection to the server" << std::endl;
+    return false;
 }
 
-void Game::handlePowerupCollision() {
-    auto p1s = player1->getSpaceships();
-    auto p2s = player2->getSpaceships();
+bool Game::broadcastTo(const char* target) {
+    if (!broadcast.open(target)) {
+        std::cerr << "Cannot stream to " << target << std::endl;
+        return false;
+    }
+    return true;
+}
 
-    for (auto& powerup : powerups) {
-        auto powerupShape = powerup.getCollisionShape();
-        for (auto p1 : p1s) {
-            if (powerupShape.collides(p1->getCollisionShape())) {
-                powerup.acquire();
-                p1->pickUpProjectile(powerup.getType());
+bool Game::watchStream(const char* source) {
+    StreamReader reader;
+    if (!reader.open(source)) {
+        std::cerr << "Cannot read the stream " << source << std::endl;
+        return false;
+    }
+    SDL_Texture* waiting = renderTextAsTexture(renderer, settings->sdlSettings->font, "Waiting for the stream", SDL_Color{255, 255, 255});
+    SDL_Rect waitingRect = {settings->w / 2 - 150, settings->h / 2 - 25, 300, 50};
+
+    // view only holds what the stream describes, it is never stepped;
+    // the frames right before and after the drawn tick are blended like on a client
+    std::unique_ptr<World> view;
+    StreamFrame next;
+    StateFrame before, after, frame;
+    float drawTick = 0.0f;
+    clk.reset();
+    while (!reader.ended() || (view && drawTick < after.tick)) {
+        float deltaTime = clk.delta();
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                exit(0);
+            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.scancode == SDL_SCANCODE_ESCAPE) {
+                SDL_DestroyTexture(waiting);
+                return true;
             }
         }
 
-        for (auto p2 : p2s) {
-            if (powerupShape.collides(p2->getCollisionShape())) {
-                powerup.acquire();
-                p2->pickUpProjectile(powerup.getType());
+        if (view) {
+            drawTick = std::min(drawTick + deltaTime * view->config.tickRate, (float)after.tick);
+        }
+        while ((!view || after.tick <= drawTick) && reader.take(next)) {
+            if (next.newMatch || !view) {
+                view = std::make_unique<World>(next.config, (int)next.team.size(), 0);
+                view->setTeams(next.team);
+                before = next.state;
+                drawTick = next.state.tick;
+            } else {
+                before = std::move(after);
             }
+            after = std::move(next.state);
         }
-    }
 
-    powerups.erase(std::remove_if(powerups.begin(), powerups.end(), [](const Powerup& powerup) {
-        return powerup.isAcquired();
-    }), powerups.end());
-}
+        SDL_RenderCopy(renderer, settings->sdlSettings->background, nullptr, nullptr);
+        if (view) {
+            if (after.tick > before.tick) {
+                interpolate(before, after, std::clamp((drawTick - before.tick) / (after.tick - before.tick), 0.0f, 1.0f), frame);
+                buildView(frame, *view);
+            } else {
+                buildView(after, *view);
+            }
+            renderWorld(renderer, *view, *settings);
+        } else {
+            SDL_RenderCopy(renderer, waiting, nullptr, &waitingRect);
+        }
+        SDL_RenderPresent(renderer);
 
-std::vector<std::shared_ptr<Spaceship>> Game::getSpaceships() {
-    std::vector<std::shared_ptr<Spaceship>> spaceships;
-    auto p1s = player1->getSpaceships();
-    auto p2s = player2->getSpaceships();
-    spaceships.insert(spaceships.end(), p1s.begin(), p1s.end());
-    spaceships.insert(spaceships.end(), p2s.begin(), p2s.end());
-    return spaceships;
+        SDL_Delay(1000 / settings->fps);
+    }
+    SDL_DestroyTexture(waiting);
+    return true;
 }
 
-std::vector<std::shared_ptr<Projectile>> Game::getProjectiles() {
-    std::vector<std::shared_ptr<Projectile>> projectiles;
-    auto p1p = player1->getProjectiles();
-    auto p2p = player2->getProjectiles();
-    projectiles.insert(projectiles.end(), p1p.begin(), p1p.end());
-    projectiles.insert(projectiles.end(), p2p.begin(), p2p.end());
-    return projectiles;
-}
\ No newline at end of file
+void Game::run() {
+    bool cont = true;
+    while (cont) {
+        playerMenu();
+        tutorialMenu();
+        int winner = gameLoop();
+        saveReplayFile(replay, LAST_REPLAY_PATH);
+        if (aiScheduler != nullptr) {
+            const AiScheduler::Stats& ai = aiScheduler->stats();
+            std::cout << "AI planning: " << ai.totalMs / std::max<uint64_t>(ai.runs, 1) << " ms per frame, at most " << ai.maxMs
+                      << " ms, " << ai.overruns << " of " << ai.runs << " frames over " << settings->aiFrameMs << " ms, "
+                      << ai.deferred << " searches deferred" << std::endl;
+        }
+        cont = gameOverMenu(winner);
+        reset();
+    }
+}
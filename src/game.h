@@ -8,43 +8,56 @@
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <vector>
 #include "clock.h"
 #include "player.h"
 #include "ai.h"
-#include "spaceship.h"
 #include "settings.h"
-#include "powerup.h"
+#include "sim/world.h"
+#include "sim/replay.h"
+#include "sim/job_system.h"
+#include "net/rollback.h"
+#include "net/state_client.h"
+#include "net/broadcast.h"
 
 class Game {
-friend class AI;
 private:
     SDL_Window* window;
     SDL_Renderer* renderer;
     Clock clk;
-    std::shared_ptr<Agent> player1, player2;
+    std::vector<std::shared_ptr<Agent>> agents; // one per owner of the world
     std::shared_ptr<GameSettings> settings;
+    std::shared_ptr<World> world;
+    float simTime; // frame time not yet simulated, less than one tick
+    Replay replay; // inputs of the current match, kept for playback once it is over
+    JobSystem jobs; // spreads the per-entity work of the simulation and the AI over the cores
+    StreamWriter broadcast; // every tick of the local and online matches, once broadcastTo opened it
+    std::unique_ptr<Perception> aiPerception; // what the AI agents of the match see, built once per tick for all of them
+    std::unique_ptr<AiScheduler> aiScheduler; // plans for the AI agents of the match, null with aiThinkMs 0
 
-    std::vector<Powerup> powerups;
-    float powerupSpawnTimer;
-
-    void handleAdversarialCollision();
-    void handleMergeCollision();
-    void handleProjectileCollision();
-    void handlePowerupCollision();
-    std::shared_ptr<Agent> getPlayer1();
-    std::shared_ptr<Agent> getPlayer2();
-    std::vector<std::shared_ptr<Spaceship>> getSpaceships();
-    std::vector<std::shared_ptr<Projectile>> getProjectiles();
+    void playSounds();
     void reset();
     void playerMenu();
     void tutorialMenu();
     int gameLoop();
     bool gameOverMenu(int winner);
+    void playback(const Replay& replay);
+    int onlineLoop(RollbackSession& session, Agent& local);
 public:
     Game();
     ~Game();
     bool init();
     void run();
+    bool watchReplay(const char* path);
+    // address is the port to listen on for player 0, HOST:PORT of player 0 for player 1
+    bool playOnline(int localPlayer, const char* address);
+    // plays on the dedicated server at HOST:PORT, or watches once two players are there,
+    // until Escape or the connection breaks
+    bool playServer(const char* address);
+    // streams the matches played from now on to a file, FIFO or unix:PATH socket
+    bool broadcastTo(const char* target);
+    // draws the matches of a stream written by broadcastTo, until Escape or the stream ends
+    bool watchStream(const char* source);
 };
 
 #endif
@@ -0,0 +1,241 @@
+#include "headless.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ai.h"
+#include "settings.h"
+#include "sim/replay.h"
+#include "net/state_server.h"
+#include "net/broadcast.h"
+
+// matches still undecided after this long are stalemates
+const float MAX_MATCH_SECONDS = 300.0f;
+
+struct MatchResult {
+    int winner; // team number, the player number without teams, 0 for a stalemate
+    uint32_t ticks;
+    AiScheduler::Stats ai; // of the planning team
+};
+
+struct WorkerStats {
+    uint64_t ticks = 0;
+    double seconds = 0.0; // time spent playing, excluding waiting on the other threads
+};
+
+// players split into teams of consecutive owners, teams == players is a free for all,
+// the AI of the first team plans for thinkMs per decision and frameMs per tick
+static MatchResult playMatch(const SimConfig& config, uint64_t seed, int players, int teams, float thinkMs, float frameMs,
+                             Replay* replay) {
+    World world(config, players, seed);
+    std::vector<int> team(players);
+    for (int owner = 0; owner < players; owner++) {
+        team[owner] = owner * teams / players;
+    }
+    world.setTeams(team);
+    Perception perception;
+    std::unique_ptr<AiScheduler> scheduler = makeAiScheduler(config, thinkMs, frameMs);
+    std::vector<std::unique_ptr<AI>> agents;
+    for (int owner = 0; owner < players; owner++) {
+        agents.push_back(std::make_unique<AI>(owner + 1, &world, &perception, team[owner] == 0 ? scheduler.get() : nullptr));
+    }
+    if (replay != nullptr) {
+        replay->begin(world);
+    }
+    const uint32_t maxTicks = config.ticks(MAX_MATCH_SECONDS);
+    std::vector<uint8_t> buttons(players);
+    int survivor;
+    while (world.teamsAlive(survivor) > 1 && world.tick < maxTicks) {
+        // the agents decide once per tick, as they would at a frame rate equal to the tick rate
+        if (scheduler != nullptr) {
+            scheduler->run(world, perception);
+        }
+        for (int owner = 0; owner < players; owner++) {
+            agents[owner]->update(config.tickDuration);
+            buttons[owner] = agents[owner]->takeInput();
+            world.applyInput(owner, buttons[owner]);
+        }
+        if (replay != nullptr) {
+            replay->record(buttons.data());
+        }
+        world.step();
+        world.events.clear();
+    }
+    return {world.teamsAlive(survivor) == 1 ? survivor + 1 : 0, world.tick,
+            scheduler != nullptr ? scheduler->stats() : AiScheduler::Stats()};
+}
+
+int runHeadless(int argc, char** argv) {
+    int matches = 100;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = time(nullptr);
+    const char* replayDir = nullptr;
+    int players = 2, teams = 0;
+    float thinkMs = 0.0f;
+    float frameMs = GameSettings::get()->aiFrameMs;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--matches") && i + 1 < argc) {
+            matches = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--config") && i + 1 < argc) {
+            GameSettings::init(argv[++i]);
+        } else if (!strcmp(argv[i], "--replays") && i + 1 < argc) {
+            replayDir = argv[++i];
+        } else if (!strcmp(argv[i], "--players") && i + 1 < argc) {
+            players = std::clamp(atoi(argv[++i]), 2, 16);
+        } else if (!strcmp(argv[i], "--teams") && i + 1 < argc) {
+            teams = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--think") && i + 1 < argc) {
+            thinkMs = std::max(0.0f, (float)atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--ai-frame") && i + 1 < argc) {
+            frameMs = std::max(0.0f, (float)atof(argv[++i]));
+        } else {
+            fprintf(stderr, "usage: %s --headless [--matches N] [--threads T] [--seed S] [--config FILE] [--replays DIR]"
+                            " [--players N] [--teams T] [--think MS] [--ai-frame MS]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    teams = teams >= 2 ? std::min(teams, players) : players;
+
+    // every match gets its own copy of the settings and its own world
+    const SimConfig config = GameSettings::get()->simConfig();
+    std::vector<MatchResult> results(matches);
+    std::vector<WorkerStats> stats(threads);
+    std::atomic<int> next(0);
+    auto worker = [&](WorkerStats& own) {
+        Replay replay;
+        for (int i = next++; i < matches; i = next++) {
+            auto start = std::chrono::steady_clock::now();
+            results[i] = playMatch(config, seed + i, players, teams, thinkMs, frameMs, replayDir != nullptr ? &replay : nullptr);
+            own.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            own.ticks += results[i].ticks;
+            if (replayDir != nullptr) {
+                std::string path = std::string(replayDir) + "/match" + std::to_string(seed + i) + ".replay";
+                if (!saveReplayFile(replay, path.c_str())) {
+                    fprintf(stderr, "could not write %s\n", path.c_str());
+                }
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.emplace_back(worker, std::ref(stats[t]));
+    }
+    worker(stats[0]);
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<int> wins(teams + 1, 0);
+    uint64_t totalTicks = 0;
+    uint32_t shortest = UINT32_MAX, longest = 0;
+    AiScheduler::Stats ai;
+    for (const MatchResult& r : results) {
+        wins[r.winner]++;
+        totalTicks += r.ticks;
+        shortest = std::min(shortest, r.ticks);
+        longest = std::max(longest, r.ticks);
+        ai.runs += r.ai.runs;
+        ai.overruns += r.ai.overruns;
+        ai.decisions += r.ai.decisions;
+        ai.deferred += r.ai.deferred;
+        ai.totalMs += r.ai.totalMs;
+        ai.maxMs = std::max(ai.maxMs, r.ai.maxMs);
+    }
+    double busy = 0.0;
+    for (const WorkerStats& s : stats) {
+        busy += s.seconds;
+    }
+    const float tick = config.tickDuration;
+    printf("%d matches of %d players in %d teams from seed %" PRIu64 " on %d threads in %.2f s\n", matches, players, teams,
+           seed, threads, seconds);
+    printf("wins:");
+    for (int t = 1; t <= teams; t++) {
+        printf(" %s %d %.1f%%,", teams < players ? "team" : "player", t, 100.0 * wins[t] / matches);
+    }
+    printf(" stalemate %.1f%%\n", 100.0 * wins[0] / matches);
+    printf("match length: mean %.1f s, min %.1f s, max %.1f s of game time\n",
+           totalTicks * tick / matches, shortest * tick, longest * tick);
+    printf("speed: %.0f ticks/s overall, %.0f ticks/s per thread\n", totalTicks / seconds, totalTicks / std::max(busy, 1e-9));
+    if (ai.runs > 0) {
+        printf("planning: %.3f ms per tick, at most %.2f ms, %" PRIu64 " of %" PRIu64 " ticks over %.1f ms, %" PRIu64
+               " decisions, %" PRIu64 " searches deferred\n", ai.totalMs / ai.runs, ai.maxMs, ai.overruns, ai.runs, frameMs,
+               ai.decisions, ai.deferred);
+    }
+    return 0;
+}
+
+// seconds a finished match stays on the clients' screens before the next one starts
+const float SERVER_RESTART_SECONDS = 3.0f;
+
+int runServer(int argc, char** argv) {
+    int port = argc > 2 ? atoi(argv[2]) : 0;
+    const char* broadcastTarget = nullptr;
+    for (int i = 3; i < argc; i++) {
+        if (!strcmp(argv[i], "--config") && i + 1 < argc) {
+            GameSettings::init(argv[++i]);
+        } else if (!strcmp(argv[i], "--broadcast") && i + 1 < argc) {
+            broadcastTarget = argv[++i];
+        } else {
+            port = 0;
+        }
+    }
+    UdpSocket socket;
+    if (port <= 0 || !socket.open(port)) {
+        fprintf(stderr, "usage: %s --server PORT [--config FILE] [--broadcast TARGET]\n", argv[0]);
+        return 2;
+    }
+    StreamWriter broadcast;
+    if (broadcastTarget != nullptr && !broadcast.open(broadcastTarget)) {
+        fprintf(stderr, "cannot stream to %s\n", broadcastTarget);
+        return 2;
+    }
+
+    const SimConfig config = GameSettings::get()->simConfig();
+    World world(config, 2, time(nullptr));
+    StateServer server(world, socket);
+    printf("serving on port %d\n", port);
+    using Clock = std::chrono::steady_clock;
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(config.tickDuration));
+    Clock::time_point nextTick = Clock::now();
+    while (true) {
+        // the AI stands in for every player without a client
+        world = World(config, 2, time(nullptr));
+        Perception perception;
+        AI player1(1, &world, &perception);
+        AI player2(2, &world, &perception);
+        Agent* agents[] = {&player1, &player2};
+        uint32_t over = 0; // tick the match was decided at
+        while (over == 0 || world.tick < over + config.ticks(SERVER_RESTART_SECONDS)) {
+            server.poll();
+            for (int owner = 0; owner < world.numPlayers(); owner++) {
+                agents[owner]->update(config.tickDuration);
+                uint8_t buttons = server.controlled(owner) ? server.takeInput(owner) : agents[owner]->takeInput();
+                world.applyInput(owner, over == 0 ? buttons : 0);
+            }
+            world.step();
+            world.events.clear();
+            server.sendSnapshots();
+            broadcast.push(world);
+            if (over == 0 && (!world.hasSpaceship(0) || !world.hasSpaceship(1) || world.tick >= config.ticks(MAX_MATCH_SECONDS))) {
+                over = world.tick;
+            }
+            nextTick += tickDuration;
+            std::this_thread::sleep_until(nextTick);
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// game --headless [--matches N] [--threads T] [--seed S] [--config FILE] [--replays DIR] [--players N] [--teams T]
+// Plays AI-vs-AI matches without a window, one world per match spread over T
+// threads, and prints the win rates, match lengths and simulation speed.
+// N players, 2 by default and up to 16, play each for themselves or split
+// into T teams of neighbouring owners.
+// Match i is played with seed S + i, so a run is reproducible from its seed.
+// Returns the exit code of the process.
+int runHeadless(int argc, char** argv);
+
+// game --server PORT [--config FILE] [--broadcast TARGET]
+// Dedicated server, runs matches one after another in real time and streams
+// them to the clients that connect with game --connect. The first two clients
+// play, the AI plays for a missing one, further clients watch. Every tick also
+// goes to TARGET for game --watch, like game --broadcast does.
+int runServer(int argc, char** argv);
+
+#endif
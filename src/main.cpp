@@ -1,5 +1,7 @@
 #include "game.h"
+#include "headless.h"
 #include <memory>
+#include <cstring>
 
 #ifndef _WIN32
 int main(int argc, char* argv[])
@@ -8,10 +10,44 @@ int main(int argc, char* argv[])
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow )
 #endif
 {
+#ifdef _WIN32
+    int argc = __argc;
+    char** argv = __argv;
+#endif
     GameSettings::init("config.json");
+    // game --headless ... plays AI matches without opening a window
+    if (argc > 1 && !strcmp(argv[1], "--headless")) {
+        return runHeadless(argc, argv);
+    }
+    // game --server PORT runs a dedicated server without a window
+    if (argc > 1 && !strcmp(argv[1], "--server")) {
+        return runServer(argc, argv);
+    }
     Game game;
     if (!game.init()) {
         return -1;
     }
+    // game --replay FILE plays a recorded match back instead
+    if (argc == 3 && !strcmp(argv[1], "--replay")) {
+        return game.watchReplay(argv[2]) ? 0 : 1;
+    }
+    // game --host PORT and game --join HOST:PORT play one against one over the network
+    if (argc == 3 && (!strcmp(argv[1], "--host") || !strcmp(argv[1], "--join"))) {
+        int localPlayer = !strcmp(argv[1], "--join");
+        while (game.playOnline(localPlayer, argv[2])) {
+        }
+        return 0;
+    }
+    // game --connect HOST:PORT plays or watches on a dedicated server
+    if (argc == 3 && !strcmp(argv[1], "--connect")) {
+        return game.playServer(argv[2]) ? 0 : 1;
+    }
+    // game --watch SOURCE draws the matches another game streams with game --broadcast TARGET
+    if (argc == 3 && !strcmp(argv[1], "--watch")) {
+        return game.watchStream(argv[2]) ? 0 : 1;
+    }
+    if (argc == 3 && !strcmp(argv[1], "--broadcast") && !game.broadcastTo(argv[2])) {
+        return 1;
+    }
     game.run();
 }
\ No newline at end of file
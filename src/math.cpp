@@ -1,80 +1,84 @@
 #include "math.h"
 
-float deg2rad(float degrees) {
-    return degrees * M_PI / 180.0;
-}
-
-float rad2deg(float radians) {
-    return radians * 180.0 / M_PI;
-}
-
-Vector2::Vector2(float x, float y) : x(x), y(y) {}
-
-Vector2 Vector2::operator+(const Vector2& other) const {
-    return Vector2(x + other.x, y + other.y);
-}
-
-Vector2 Vector2::operator-(const Vector2& other) const {
-    return Vector2(x - other.x, y - other.y);
-}
-
-Vector2 Vector2::operator*(float scalar) const {
-    return Vector2(x * scalar, y * scalar);
-}
-
-Vector2 Vector2::operator/(float scalar) const {
-    return Vector2(x / scalar, y / scalar);
-}
-
-Vector2& Vector2::operator+=(const Vector2& other) {
-    x += other.x;
-    y += other.y;
-    return *this;
-}
-
-Vector2& Vector2::operator-=(const Vector2& other) {
-    x -= other.x;
-    y -= other.y;
-    return *this;
-}
-
-Vector2& Vector2::operator*=(float scalar) {
-    x *= scalar;
-    y *= scalar;
-    return *this;
-}
-
-Vector2& Vector2::operator/=(float scalar) {
-    x /= scalar;
-    y /= scalar;
-    return *this;
-}
-
-float Vector2::magnitude() const {
-    return std::sqrt(x * x + y * y);
-}
-
-Vector2 Vector2::normalize() const {
-    return *this / magnitude();
-}
-
-float Vector2::dot(const Vector2& other) const {
-    return x * other.x + y * other.y;
-}
-
-float Vector2::distance(const Vector2& other) const {
-    return (*this - other).magnitude();
-}
-
-float Vector2::angleBetween(const Vector2& other) const {
-    return rad2deg(std::acos(dot(other) / (magnitude() * other.magnitude())));
-}
-
-Circle::Circle(Vector2 center, float radius) : center(center), radius(radius) {}
-bool Circle::contains(Vector2 point) const {
-    return center.distance(point) <= radius;
-}
-
-bool Circle::collides(const Circle& other) const {
-    return center.distance(other.center) <= radius + other.radius;
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MATH_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+// Every variant computes dx * dx + dy * dy with separate multiplies and adds,
+// in the same order as Vector2::distanceSquared, so they agree bit for bit.
+
+static size_t circleOverlapsScalar(Vector2 center, float reachSq, const float* xs, const float* ys, size_t n, uint8_t* hits) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        float dx = center.x - xs[i];
+        float dy = center.y - ys[i];
+        hits[i] = dx * dx + dy * dy <= reachSq;
+        count += hits[i];
+    }
+    return count;
+}
+
+#ifdef MATH_X86_DISPATCH
+
+__attribute__((target("sse2")))
+static size_t circleOverlapsSSE2(Vector2 center, float reachSq, const float* xs, const float* ys, size_t n, uint8_t* hits) {
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 r = _mm_set1_ps(reachSq);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 dx = _mm_sub_ps(cx, _mm_loadu_ps(xs + i));
+        __m128 dy = _mm_sub_ps(cy, _mm_loadu_ps(ys + i));
+        __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(d, r));
+        for (int k = 0; k < 4; k++) {
+            hits[i + k] = (mask >> k) & 1;
+        }
+        count += __builtin_popcount(mask);
+    }
+    return count + circleOverlapsScalar(center, reachSq, xs + i, ys + i, n - i, hits + i);
+}
+
+__attribute__((target("avx2")))
+static size_t circleOverlapsAVX2(Vector2 center, float reachSq, const float* xs, const float* ys, size_t n, uint8_t* hits) {
+    const __m256 cx = _mm256_set1_ps(center.x);
+    const __m256 cy = _mm256_set1_ps(center.y);
+    const __m256 r = _mm256_set1_ps(reachSq);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 dx = _mm256_sub_ps(cx, _mm256_loadu_ps(xs + i));
+        __m256 dy = _mm256_sub_ps(cy, _mm256_loadu_ps(ys + i));
+        __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(d, r, _CMP_LE_OQ));
+        for (int k = 0; k < 8; k++) {
+            hits[i + k] = (mask >> k) & 1;
+        }
+        count += __builtin_popcount(mask);
+    }
+    return count + circleOverlapsSSE2(center, reachSq, xs + i, ys + i, n - i, hits + i);
+}
+
+#endif
+
+using CircleOverlapsFn = size_t (*)(Vector2, float, const float*, const float*, size_t, uint8_t*);
+
+static CircleOverlapsFn selectCircleOverlaps() {
+#ifdef MATH_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return circleOverlapsAVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return circleOverlapsSSE2;
+    }
+#endif
+    return circleOverlapsScalar;
+}
+
+size_t circleOverlaps(Vector2 center, float reachSq, const float* xs, const float* ys, size_t n, uint8_t* hits) {
+    static const CircleOverlapsFn impl = selectCircleOverlaps();
+    return impl(center, reachSq, xs, ys, n, hits);
 }
@@ -1,37 +1,176 @@
 #ifndef MATH_H
 #define MATH_H
 #include <cmath>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
 
-float deg2rad(float degrees);
-float rad2deg(float radians);
+// Everything below is inline so the simulation loops can fold it without LTO.
+// Only the batched circle kernels live in math.cpp (they need runtime CPU dispatch).
+
+constexpr float PI_F = 3.14159265358979323846f;
+
+constexpr float deg2rad(float degrees) {
+    return degrees * PI_F / 180.0f;
+}
+
+constexpr float rad2deg(float radians) {
+    return radians * 180.0f / PI_F;
+}
 
 struct Vector2 {
     float x, y;
 
-    Vector2(float x, float y);
-    Vector2 operator+(const Vector2& other) const;
-    Vector2 operator-(const Vector2& other) const;
-    Vector2 operator*(float scalar) const;
-    Vector2 operator/(float scalar) const;
-    Vector2& operator+=(const Vector2& other);
-    Vector2& operator-=(const Vector2& other);
-    Vector2& operator*=(float scalar);
-    Vector2& operator/=(float scalar);
-    float magnitude() const;
-    Vector2 normalize() const;
-
-    float dot(const Vector2& other) const;
-    float distance(const Vector2& other) const;
-    float angleBetween(const Vector2& other) const;
+    constexpr Vector2() : x(0.0f), y(0.0f) {}
+    constexpr Vector2(float x, float y) : x(x), y(y) {}
+
+    constexpr Vector2 operator+(const Vector2& other) const { return Vector2(x + other.x, y + other.y); }
+    constexpr Vector2 operator-(const Vector2& other) const { return Vector2(x - other.x, y - other.y); }
+    constexpr Vector2 operator*(float scalar) const { return Vector2(x * scalar, y * scalar); }
+    constexpr Vector2 operator/(float scalar) const { return Vector2(x / scalar, y / scalar); }
+    constexpr Vector2& operator+=(const Vector2& other) { x += other.x; y += other.y; return *this; }
+    constexpr Vector2& operator-=(const Vector2& other) { x -= other.x; y -= other.y; return *this; }
+    constexpr Vector2& operator*=(float scalar) { x *= scalar; y *= scalar; return *this; }
+    constexpr Vector2& operator/=(float scalar) { x /= scalar; y /= scalar; return *this; }
+
+    constexpr float dot(const Vector2& other) const {
+        return x * other.x + y * other.y;
+    }
+
+    constexpr float distanceSquared(const Vector2& other) const {
+        return (*this - other).dot(*this - other);
+    }
+
+    float magnitude() const {
+        return std::sqrt(dot(*this));
+    }
+
+    // The zero vector has no direction, it normalizes to itself instead of NaN.
+    Vector2 normalize() const {
+        float m = magnitude();
+        return m > 0.0f ? *this / m : Vector2(0.0f, 0.0f);
+    }
+
+    float distance(const Vector2& other) const {
+        return (*this - other).magnitude();
+    }
+
+    float angleBetween(const Vector2& other) const {
+        return rad2deg(std::acos(dot(other) / (magnitude() * other.magnitude())));
+    }
 };
 
+// Unit direction vector (cos, sin) of an angle in degrees.
+// Reduces to the nearest quadrant and evaluates short Taylor polynomials on
+// [-45, 45] degrees, accurate to ~3e-7 and independent of the platform libm.
+constexpr Vector2 direction(float degrees) {
+    float q = degrees * (1.0f / 90.0f);
+    long quadrant = (long)(q >= 0.0f ? q + 0.5f : q - 0.5f);
+    float x = deg2rad(degrees - quadrant * 90.0f);
+    float x2 = x * x;
+    float s = x * (1.0f - x2 / 6.0f * (1.0f - x2 / 20.0f * (1.0f - x2 / 42.0f)));
+    float c = 1.0f - x2 / 2.0f * (1.0f - x2 / 12.0f * (1.0f - x2 / 30.0f * (1.0f - x2 / 56.0f)));
+    switch (quadrant & 3) {
+        case 0: return Vector2(c, s);
+        case 1: return Vector2(-s, c);
+        case 2: return Vector2(-c, -s);
+        default: return Vector2(s, -c);
+    }
+}
+
 struct Circle {
     Vector2 center;
     float radius;
 
-    Circle(Vector2 center, float radius);
-    bool contains(Vector2 point) const;
-    bool collides(const Circle& other) const;
+    constexpr Circle(Vector2 center, float radius) : center(center), radius(radius) {}
+
+    constexpr bool contains(Vector2 point) const {
+        return center.distanceSquared(point) <= radius * radius;
+    }
+
+    constexpr bool collides(const Circle& other) const {
+        float reach = radius + other.radius;
+        return center.distanceSquared(other.center) <= reach * reach;
+    }
 };
 
+// Swept test of a circle moving from `from` to `to` against a fixed point:
+// returns the earliest t in [0, 1] at which the center comes within sqrt(reachSq),
+// -1 if it never does. For two moving circles pass the relative motion.
+inline float sweptCircleTOI(Vector2 from, Vector2 to, Vector2 point, float reachSq) {
+    Vector2 f = from - point;
+    Vector2 d = to - from;
+    float c = f.dot(f) - reachSq;
+    if (c <= 0.0f) {
+        return 0.0f; // already touching at the start
+    }
+    float a = d.dot(d);
+    float b = f.dot(d);
+    if (a == 0.0f || b >= 0.0f) {
+        return -1.0f; // standing still or moving away
+    }
+    float disc = b * b - a * c;
+    if (disc < 0.0f) {
+        return -1.0f;
+    }
+    float t = (-b - std::sqrt(disc)) / a;
+    if (t <= 1.0f) {
+        return t;
+    }
+    // t can round past 1 when the contact is exactly at the end of the step
+    return to.distanceSquared(point) <= reachSq ? 1.0f : -1.0f;
+}
+
+// Batched narrowphase: tests one center against n points given as separate
+// x and y columns. hits[i] is 1 when point i is within sqrt(reachSq), 0 otherwise.
+// Returns the number of hits. Uses AVX2 or SSE2 when the CPU has them, the
+// result is identical to calling distanceSquared on every point.
+size_t circleOverlaps(Vector2 center, float reachSq, const float* xs, const float* ys, size_t n, uint8_t* hits);
+
+enum class BorderSide {
+    LEFT = 1,
+    RIGHT = 2,
+    TOP = 3,
+    BOTTOM = 4
+};
+struct RayIntersection {
+    BorderSide side;
+    Vector2 intersectionPoint;
+};
+
+// Where a ray from pos with the given angle (in degrees) leaves the screen
+inline RayIntersection getRayIntersectionBorder(const Vector2& pos, float angle, int SCREEN_WIDTH, int SCREEN_HEIGHT) {
+    Vector2 dir = direction(angle);
+    float dx = dir.x;
+    float dy = dir.y;
+
+    // Initialize t-values to a large number
+    float tLeft = FLT_MAX, tRight = FLT_MAX, tTop = FLT_MAX, tBottom = FLT_MAX;
+
+    // Compute t for left/right borders if possible
+    if (dx < 0)
+        tLeft = (0 - pos.x) / dx;
+    if (dx > 0)
+        tRight = (SCREEN_WIDTH - pos.x) / dx;
+
+    // Compute t for top/bottom borders if possible
+    if (dy < 0)
+        tTop = (0 - pos.y) / dy;
+    if (dy > 0)
+        tBottom = (SCREEN_HEIGHT - pos.y) / dy;
+
+    // Determine the smallest positive t and corresponding side
+    float tMin = FLT_MAX;
+    BorderSide side = BorderSide::LEFT;
+    if (tLeft >= 0 && tLeft < tMin) { tMin = tLeft; side = BorderSide::LEFT; }
+    if (tRight >= 0 && tRight < tMin) { tMin = tRight; side = BorderSide::RIGHT; }
+    if (tTop >= 0 && tTop < tMin) { tMin = tTop; side = BorderSide::TOP; }
+    if (tBottom >= 0 && tBottom < tMin) { tMin = tBottom; side = BorderSide::BOTTOM; }
+
+    // Calculate the intersection point using pos + tMin * (dx, dy)
+    Vector2 intersectionPoint = { pos.x + tMin * dx, pos.y + tMin * dy };
+
+    return { side, intersectionPoint };
+}
+
 #endif
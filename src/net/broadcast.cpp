@@ -0,0 +1,520 @@
+#include "net/broadcast.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+const char UNIX_PREFIX[] = "unix:";
+const uint32_t MAX_RECORD_SIZE = 1 << 24;
+// milliseconds the threads wait on a file descriptor before they check for close()
+const int WAIT_MILLISECONDS = 100;
+// attempts of a writer closing to get its last frames out to a stalled viewer
+const int CLOSE_ATTEMPTS = 10;
+
+static bool unixPath(const std::string& target, std::string& path) {
+    if (target.compare(0, strlen(UNIX_PREFIX), UNIX_PREFIX) != 0) {
+        return false;
+    }
+    path = target.substr(strlen(UNIX_PREFIX));
+    return true;
+}
+
+static bool isFifo(const std::string& path) {
+#ifdef _WIN32
+    return false;
+#else
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISFIFO(info.st_mode);
+#endif
+}
+
+// false after WAIT_MILLISECONDS without fd becoming ready
+static bool waitFor(int fd, bool output) {
+#ifdef _WIN32
+    return true; // files only, always ready
+#else
+    pollfd p = {fd, (short)(output ? POLLOUT : POLLIN), 0};
+    return poll(&p, 1, WAIT_MILLISECONDS) > 0;
+#endif
+}
+
+static void setNonBlocking(int fd) {
+#ifndef _WIN32
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#endif
+}
+
+#ifndef _WIN32
+static bool socketAddress(const std::string& path, sockaddr_un& address) {
+    address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+#endif
+
+// the length of a record written with a placeholder, once its payload is complete
+static void finishRecord(std::vector<uint8_t>& data) {
+    uint32_t length = (uint32_t)(data.size() - sizeof(uint32_t));
+    memcpy(data.data(), &length, sizeof(length));
+}
+
+static void captureFrame(const World& world, StateFrame& frame) {
+    frame.tick = world.tick;
+    frame.entities.clear();
+    for (size_t i = 0; i < world.ships.size(); i++) {
+        frame.entities.push_back(netShip(world, i));
+    }
+    for (size_t i = 0; i < world.bullets.size(); i++) {
+        frame.entities.push_back(netBullet(world, i));
+    }
+    for (size_t i = 0; i < world.lasers.size(); i++) {
+        frame.entities.push_back(netLaser(world, i));
+    }
+    for (size_t i = 0; i < world.mines.size(); i++) {
+        frame.entities.push_back(netMine(world, i));
+    }
+    for (size_t i = 0; i < world.powerups.size(); i++) {
+        frame.entities.push_back(netPowerup(world, i));
+    }
+}
+
+StreamWriter::StreamWriter()
+    : closing(false), fd(-1), reconnects(false), connected(false), head(0), tail(0), lastTick(0), lastPlayers(0),
+      pendingMatch(true), sendMatch(false), sinceKey(STREAM_KEY_INTERVAL), written(0), dropped(0), bytes(0) {
+    match.newMatch = false;
+}
+
+StreamWriter::~StreamWriter() {
+    close();
+}
+
+bool StreamWriter::open(const char* target) {
+    this->target = target;
+    std::string path;
+    if (unixPath(this->target, path)) {
+#ifdef _WIN32
+        return false;
+#else
+        sockaddr_un address;
+        if (!socketAddress(path, address)) {
+            return false;
+        }
+        reconnects = true;
+#endif
+    } else if (isFifo(this->target)) {
+        reconnects = true;
+    } else {
+        // created right away, a bad path is reported to the caller
+        fd = ::open(target, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+        if (fd < 0) {
+            return false;
+        }
+    }
+#ifndef _WIN32
+    // a viewer going away fails a write, it must not end the game
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    closing = false;
+    thread = std::thread(&StreamWriter::run, this);
+    return true;
+}
+
+void StreamWriter::push(const World& world) {
+    if (!thread.joinable()) {
+        return;
+    }
+    // ticks start over with every match, a quickload can also go back in time
+    if (world.tick <= lastTick || world.numPlayers() != lastPlayers) {
+        pendingMatch = true;
+    }
+    lastTick = world.tick;
+    lastPlayers = world.numPlayers();
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == STREAM_QUEUE_FRAMES) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // the entities are sorted by the writer thread, the game only copies them
+    StreamFrame& frame = slots[h % STREAM_QUEUE_FRAMES];
+    frame.newMatch = pendingMatch;
+    if (pendingMatch) {
+        frame.config = world.config;
+        frame.team = world.team;
+    }
+    captureFrame(world, frame.state);
+    pendingMatch = false;
+    head.store(h + 1, std::memory_order_release);
+}
+
+void StreamWriter::close() {
+    if (!thread.joinable()) {
+        return;
+    }
+    closing = true;
+    thread.join();
+}
+
+StreamWriterStats StreamWriter::stats() const {
+    return {written.load(), dropped.load(), bytes.load()};
+}
+
+void StreamWriter::run() {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point nextConnect = Clock::now();
+    while (true) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            if (closing) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        StreamFrame& frame = slots[t % STREAM_QUEUE_FRAMES];
+        if (frame.newMatch) {
+            match.config = frame.config;
+            match.team = frame.team;
+            match.newMatch = sendMatch = true;
+        }
+        // frames go nowhere while there is no viewer, FIFOs and sockets are tried once a second
+        if (!connected && Clock::now() >= nextConnect) {
+            connected = connect();
+            nextConnect = Clock::now() + std::chrono::seconds(1);
+        }
+        if (connected) {
+            write(frame);
+        } else {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        tail.store(t + 1, std::memory_order_release);
+    }
+    disconnect();
+}
+
+bool StreamWriter::connect() {
+    if (fd < 0) {
+        if (!reconnects) {
+            return false; // a file once written is not started over
+        }
+        std::string path;
+#ifndef _WIN32
+        if (unixPath(target, path)) {
+            sockaddr_un address;
+            socketAddress(path, address);
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && ::connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        } else {
+            // fails without a reader instead of waiting for one
+            fd = ::open(target.c_str(), O_WRONLY | O_NONBLOCK);
+        }
+#endif
+        if (fd < 0) {
+            return false;
+        }
+    }
+    setNonBlocking(fd);
+    PacketWriter w;
+    w.value(STREAM_MAGIC);
+    w.value(STREAM_VERSION);
+    if (!send(w.data)) {
+        disconnect();
+        return false;
+    }
+    sendMatch = match.newMatch;
+    sinceKey = STREAM_KEY_INTERVAL;
+    return true;
+}
+
+void StreamWriter::disconnect() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    connected = false;
+}
+
+void StreamWriter::write(StreamFrame& frame) {
+    if (sendMatch) {
+        PacketWriter w;
+        w.value((uint32_t)0);
+        w.value((uint8_t)StreamRecord::MATCH);
+        w.value((uint8_t)match.team.size());
+        w.value(match.config);
+        for (int team : match.team) {
+            w.value((int32_t)team);
+        }
+        finishRecord(w.data);
+        if (!send(w.data)) {
+            disconnect();
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        sendMatch = false;
+        sinceKey = STREAM_KEY_INTERVAL;
+    }
+    std::vector<NetEntity>& entities = frame.state.entities;
+    std::sort(entities.begin(), entities.end(), [](const NetEntity& a, const NetEntity& b) { return a.id < b.id; });
+    bool key = sinceKey >= STREAM_KEY_INTERVAL;
+    static const StateFrame empty = {0, {}};
+    encodeDelta(key ? empty : previous, frame.state, encoded);
+    record.resize(sizeof(uint32_t));
+    record.push_back((uint8_t)(key ? StreamRecord::KEY : StreamRecord::DELTA));
+    record.insert(record.end(), encoded.begin(), encoded.end());
+    finishRecord(record);
+    if (!send(record)) {
+        disconnect();
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    sinceKey = key ? 1 : sinceKey + 1;
+    // the slot gets the old baseline's storage for its next frame
+    std::swap(previous, frame.state);
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool StreamWriter::send(const std::vector<uint8_t>& data) {
+    size_t sent = 0;
+    int attempts = 0;
+    while (sent < data.size()) {
+        if (!waitFor(fd, true)) {
+            if (closing && ++attempts >= CLOSE_ATTEMPTS) {
+                return false;
+            }
+            continue;
+        }
+        ssize_t n = ::write(fd, data.data() + sent, data.size() - sent);
+        if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            return false;
+        }
+        sent += std::max(n, (ssize_t)0);
+    }
+    bytes.fetch_add(data.size(), std::memory_order_relaxed);
+    return true;
+}
+
+StreamReader::StreamReader() : closing(false), fd(-1), listener(-1), reconnects(false), over(false) {}
+
+StreamReader::~StreamReader() {
+    close();
+}
+
+bool StreamReader::open(const char* source) {
+    this->source = source;
+    std::string path;
+    if (unixPath(this->source, path)) {
+#ifdef _WIN32
+        return false;
+#else
+        // the viewer listens, broadcasting games come and go
+        sockaddr_un address;
+        if (!socketAddress(path, address)) {
+            return false;
+        }
+        unlink(path.c_str());
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 1) != 0) {
+            disconnect();
+            return false;
+        }
+        setNonBlocking(listener);
+        reconnects = true;
+#endif
+    } else if (isFifo(this->source)) {
+        reconnects = true;
+    } else {
+        fd = ::open(source, O_RDONLY | O_BINARY);
+        if (fd < 0) {
+            return false;
+        }
+    }
+    closing = false;
+    over = false;
+    thread = std::thread(&StreamReader::run, this);
+    return true;
+}
+
+bool StreamReader::take(StreamFrame& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (frames.empty()) {
+        return false;
+    }
+    out = std::move(frames.front());
+    frames.pop_front();
+    taken.notify_one();
+    return true;
+}
+
+bool StreamReader::ended() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return over && frames.empty();
+}
+
+void StreamReader::close() {
+    if (thread.joinable()) {
+        closing = true;
+        thread.join();
+    }
+    disconnect();
+    if (listener >= 0) {
+#ifndef _WIN32
+        ::close(listener);
+        std::string path;
+        unixPath(source, path);
+        unlink(path.c_str());
+#endif
+        listener = -1;
+    }
+}
+
+void StreamReader::run() {
+    while (!closing) {
+        if (!connect()) {
+            if (!reconnects) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_MILLISECONDS));
+            continue;
+        }
+        readRecords();
+        disconnect();
+        if (!reconnects) {
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    over = true;
+}
+
+bool StreamReader::connect() {
+    if (fd >= 0) {
+        return true;
+    }
+#ifndef _WIN32
+    if (listener >= 0) {
+        if (waitFor(listener, false)) {
+            fd = accept(listener, nullptr, nullptr);
+        }
+    } else if (reconnects) {
+        // opened without a writer, poll waits for one to come
+        fd = ::open(source.c_str(), O_RDONLY | O_NONBLOCK);
+    }
+#endif
+    if (fd < 0) {
+        return false;
+    }
+    setNonBlocking(fd);
+    return true;
+}
+
+void StreamReader::disconnect() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool StreamReader::receive(std::vector<uint8_t>& data, size_t size) {
+    data.resize(size);
+    size_t received = 0;
+    while (received < size) {
+        if (closing) {
+            return false;
+        }
+        if (!waitFor(fd, false)) {
+            continue;
+        }
+        ssize_t n = ::read(fd, data.data() + received, size - received);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+            return false; // the writer is gone
+        }
+        received += std::max(n, (ssize_t)0);
+    }
+    return true;
+}
+
+void StreamReader::readRecords() {
+    std::vector<uint8_t> data;
+    if (!receive(data, sizeof(STREAM_MAGIC) + sizeof(STREAM_VERSION))) {
+        return;
+    }
+    PacketReader header(data);
+    if (header.value<uint32_t>() != STREAM_MAGIC || header.value<uint16_t>() != STREAM_VERSION) {
+        return;
+    }
+    // a DELTA needs the frame before it, a KEY or DELTA the MATCH of the connection
+    StreamFrame frame;
+    frame.newMatch = false;
+    bool matchKnown = false;
+    bool havePrevious = false;
+    StateFrame previous;
+    while (receive(data, sizeof(uint32_t))) {
+        uint32_t length;
+        memcpy(&length, data.data(), sizeof(length));
+        if (length == 0 || length > MAX_RECORD_SIZE || !receive(data, length)) {
+            return;
+        }
+        PacketReader r(data);
+        StreamRecord type = (StreamRecord)r.value<uint8_t>();
+        if (type == StreamRecord::MATCH) {
+            int players = r.value<uint8_t>();
+            frame.config = r.value<SimConfig>();
+            frame.team.resize(players);
+            bool teamsOk = true;
+            for (int& team : frame.team) {
+                team = r.value<int32_t>();
+                teamsOk &= team >= 0 && team < players;
+            }
+            // checked like loadSnapshot does, the viewer builds a World of them and indexes by team
+            if (!r.ok || players == 0 || !teamsOk || frame.config.tickRate <= 0 || frame.config.w <= 0 || frame.config.h <= 0) {
+                return;
+            }
+            frame.config.finalize();
+            frame.newMatch = matchKnown = true;
+            havePrevious = false;
+            continue;
+        }
+        bool key = type == StreamRecord::KEY;
+        if (!matchKnown || (!key && (type != StreamRecord::DELTA || !havePrevious))) {
+            return;
+        }
+        static const StateFrame empty = {0, {}};
+        if (!decodeDelta(key ? empty : previous, r.p, r.remaining(), frame.state)) {
+            return;
+        }
+        previous = frame.state;
+        havePrevious = true;
+
+        // waits for the viewer to take frames, a file is not read faster than it is watched
+        std::unique_lock<std::mutex> lock(mutex);
+        while (frames.size() >= STREAM_BUFFER_FRAMES) {
+            if (closing) {
+                return;
+            }
+            taken.wait_for(lock, std::chrono::milliseconds(WAIT_MILLISECONDS));
+        }
+        frames.push_back(frame);
+        frame.newMatch = false;
+    }
+}
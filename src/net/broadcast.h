@@ -0,0 +1,136 @@
+#ifndef NET_BROADCAST_H
+#define NET_BROADCAST_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "net/state_sync.h"
+
+// Live matches streamed to a viewer in another process, every entity of every
+// tick the writer keeps up with.
+// The stream is the STREAM_MAGIC header, then records of
+//   length u32 (of what follows), type u8, payload
+//   MATCH players u8, SimConfig, team i32 per owner
+//   KEY   encodeDelta against nothing
+//   DELTA encodeDelta against the previous frame of the stream
+// in native byte order. A malformed record ends the connection, a MATCH needs
+// a positive arena and tick rate and teams of its players. Every connection,
+// match and STREAM_KEY_INTERVAL frames start over with a MATCH or a KEY, so a
+// frame never depends on one the viewer may not have.
+// Targets and sources are a path, a regular file or a FIFO, or unix:PATH for
+// a Unix domain socket the viewer listens on. FIFOs and sockets reconnect
+// when the other side goes away, a file is written and read once.
+constexpr uint32_t STREAM_MAGIC = 0x4d525453; // "STRM"
+constexpr uint16_t STREAM_VERSION = 1;
+
+constexpr uint32_t STREAM_QUEUE_FRAMES = 8;    // ticks the writer thread may fall behind before frames are dropped
+constexpr uint32_t STREAM_KEY_INTERVAL = 600;  // frames between two KEY records
+constexpr uint32_t STREAM_BUFFER_FRAMES = 120; // frames the reader decodes ahead of the viewer
+
+enum class StreamRecord : uint8_t {
+    MATCH,
+    KEY,
+    DELTA
+};
+
+// One tick of the stream, and the setup of its match if it is the first one
+struct StreamFrame {
+    bool newMatch;
+    SimConfig config;
+    std::vector<int> team; // per owner
+    StateFrame state;
+};
+
+struct StreamWriterStats {
+    uint32_t frames;  // written
+    uint32_t dropped; // queue full, or nobody to write to
+    uint64_t bytes;
+};
+
+class StreamWriter {
+public:
+    StreamWriter();
+    ~StreamWriter(); // close()
+
+    // starts the writer thread, false if target cannot be written at all
+    bool open(const char* target);
+    // after every world.step of the streamed match, never waits for the writer thread:
+    // the frame is dropped when the queue is full
+    void push(const World& world);
+    // writes what is queued and stops the thread
+    void close();
+
+    StreamWriterStats stats() const;
+
+private:
+    std::string target;
+    std::thread thread;
+    std::atomic<bool> closing;
+    int fd;          // of the writer thread, -1 while not connected
+    bool reconnects; // a FIFO or socket, opened again when the viewer goes away
+    bool connected;  // the header went out on fd
+
+    // single producer, single consumer ring: push fills slots[head], the
+    // writer thread drains slots[tail], each publishes its index with release
+    StreamFrame slots[STREAM_QUEUE_FRAMES];
+    std::atomic<uint32_t> head, tail;
+    uint32_t lastTick;    // of the previous push
+    int lastPlayers;
+    bool pendingMatch;    // the next queued frame starts a match, also after drops
+
+    // of the writer thread
+    StreamFrame match;    // setup of the current match, sent again on reconnects
+    bool sendMatch;       // before the next frame
+    StateFrame previous;  // baseline of the next DELTA
+    uint32_t sinceKey;    // frames written since the last KEY, STREAM_KEY_INTERVAL for none yet
+    std::vector<uint8_t> record;
+    std::vector<uint8_t> encoded;
+
+    std::atomic<uint32_t> written, dropped;
+    std::atomic<uint64_t> bytes;
+
+    void run();
+    bool connect();
+    void disconnect();
+    void write(StreamFrame& frame);
+    bool send(const std::vector<uint8_t>& data);
+};
+
+class StreamReader {
+public:
+    StreamReader();
+    ~StreamReader(); // close()
+
+    // starts reading source in the background, false if it cannot be read at all
+    bool open(const char* source);
+    // the next frame in stream order, false if none is decoded yet
+    bool take(StreamFrame& out);
+    // the stream is over and every frame was taken
+    bool ended();
+    void close();
+
+private:
+    std::string source;
+    std::thread thread;
+    std::atomic<bool> closing;
+    int fd, listener; // of the reader thread
+    bool reconnects;  // a FIFO or socket, waited on again when the writer goes away
+
+    std::mutex mutex;
+    std::condition_variable taken;
+    std::deque<StreamFrame> frames; // at most STREAM_BUFFER_FRAMES
+    bool over;
+
+    void run();
+    bool connect();
+    void disconnect();
+    bool receive(std::vector<uint8_t>& data, size_t size);
+    void readRecords();
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef NET_PACKET_H
+#define NET_PACKET_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Fields of a packet, in native byte order like snapshots.
+
+struct PacketWriter {
+    std::vector<uint8_t> data;
+
+    template <class T> void value(const T& v) {
+        const uint8_t* p = (const uint8_t*)&v;
+        data.insert(data.end(), p, p + sizeof(T));
+    }
+
+    void bytes(const uint8_t* p, size_t size) { data.insert(data.end(), p, p + size); }
+};
+
+// reads past the end return zeros and clear ok
+struct PacketReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+
+    PacketReader(const std::vector<uint8_t>& data) : p(data.data()), end(data.data() + data.size()), ok(true) {}
+
+    template <class T> T value() {
+        T v{};
+        if ((size_t)(end - p) < sizeof(T)) {
+            ok = false;
+            return v;
+        }
+        memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+
+    size_t remaining() const { return end - p; }
+};
+
+#endif
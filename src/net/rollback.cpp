@@ -0,0 +1,314 @@
+#include "net/rollback.h"
+#include "net/packet.h"
+#include "sim/hash.h"
+#include "sim/snapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+enum class NetMessage : uint8_t {
+    HELLO,   // player 1 asks to join
+    WELCOME, // player 0 answers with the seed
+    INPUT
+};
+
+// INPUT after the header:
+//   frame u32, advantage i32, ack u32,
+//   start u32, count u8, count buttons for the frames from start on,
+//   check frame u32 (UINT32_MAX for none), check hash u64
+
+// ticks between two decisions to wait for a peer that runs behind
+const uint32_t TIME_SYNC_INTERVAL = 30;
+const uint32_t MAX_WAIT_TICKS = 8;
+// seconds between two HELLOs while joining
+const float HELLO_INTERVAL = 0.1f;
+
+static void writeHeader(PacketWriter& w, NetMessage type, int player) {
+    w.value(NET_MAGIC);
+    w.value(NET_VERSION);
+    w.value((uint8_t)type);
+    w.value((uint8_t)player);
+}
+
+static bool readHeader(PacketReader& r, NetMessage& type, int& player) {
+    bool valid = r.value<uint32_t>() == NET_MAGIC && r.value<uint16_t>() == NET_VERSION;
+    type = (NetMessage)r.value<uint8_t>();
+    player = r.value<uint8_t>();
+    return r.ok && valid && player < 2;
+}
+
+static void sendWelcome(UdpSocket& socket, const NetAddress& to, uint64_t seed) {
+    PacketWriter w;
+    writeHeader(w, NetMessage::WELCOME, 0);
+    w.value(seed);
+    socket.send(to, w.data.data(), w.data.size());
+}
+
+bool connectPeer(UdpSocket& socket, int localPlayer, NetAddress& peer, uint64_t& seed, float timeout) {
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](float s) { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(s)); };
+    Clock::time_point deadline = Clock::now() + seconds(timeout);
+    Clock::time_point nextHello = Clock::now();
+    std::vector<uint8_t> packet;
+    NetAddress from;
+    while (Clock::now() < deadline) {
+        if (localPlayer == 1 && Clock::now() >= nextHello) {
+            PacketWriter w;
+            writeHeader(w, NetMessage::HELLO, 1);
+            socket.send(peer, w.data.data(), w.data.size());
+            nextHello += seconds(HELLO_INTERVAL);
+        }
+        while (socket.receive(from, packet)) {
+            PacketReader r(packet);
+            NetMessage type;
+            int player;
+            if (!readHeader(r, type, player) || player == localPlayer) {
+                continue;
+            }
+            if (localPlayer == 0 && type == NetMessage::HELLO) {
+                // the session answers HELLOs again in case this WELCOME is lost
+                peer = from;
+                sendWelcome(socket, peer, seed);
+                return true;
+            }
+            if (localPlayer == 1 && type == NetMessage::WELCOME && from == peer) {
+                uint64_t welcomeSeed = r.value<uint64_t>();
+                if (r.ok) {
+                    seed = welcomeSeed;
+                    return true;
+                }
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+RollbackSession::RollbackSession(World& world, UdpSocket& socket, const NetAddress& peer, int localPlayer, uint64_t seed,
+                                 const RollbackConfig& config)
+    : world(world), socket(socket), peer(peer), localPlayer(localPlayer), seed(seed), config(config),
+      currentFrame(0), peerFrame(0), peerAdvantage(0), waitTicks(0), sentSincePoll(false), lastReceived(Clock::now()),
+      desyncFrame(UINT32_MAX), statistics{}
+{
+    // the limits keep every frame a rollback or a resend can reach inside the rings
+    this->config.inputDelay = std::min(config.inputDelay, 8u);
+    this->config.maxPrediction = std::clamp(config.maxPrediction, 1u, 16u);
+    // nobody can press anything for the first inputDelay ticks
+    remoteFrames = this->config.inputDelay;
+    peerAck = this->config.inputDelay;
+    memset(localInputs, 0, sizeof(localInputs));
+    memset(remoteInputs, 0, sizeof(remoteInputs));
+    memset(remoteUsed, 0, sizeof(remoteUsed));
+    for (Checksum& checksum : checksums) {
+        checksum = {UINT32_MAX, 0};
+    }
+}
+
+uint32_t RollbackSession::confirmedFrame() const {
+    return std::min(remoteFrames, currentFrame);
+}
+
+void RollbackSession::confirmedInputs(uint32_t frame, uint8_t* buttons) const {
+    buttons[localPlayer] = localInputs[frame % ROLLBACK_WINDOW];
+    buttons[1 - localPlayer] = remoteInputs[frame % ROLLBACK_WINDOW];
+}
+
+bool RollbackSession::disconnected() const {
+    return Clock::now() - lastReceived > std::chrono::duration<float>(config.timeout);
+}
+
+// Held buttons are predicted to stay held, one-shot presses not to repeat:
+// rotation is held for many ticks in a row while shots are single ticks.
+uint8_t RollbackSession::remoteInput(uint32_t frame) const {
+    if (frame < remoteFrames) {
+        return remoteInputs[frame % ROLLBACK_WINDOW];
+    }
+    return remoteFrames > 0 ? remoteInputs[(remoteFrames - 1) % ROLLBACK_WINDOW] & INPUT_ROTATE : 0;
+}
+
+void RollbackSession::simulate(uint32_t frame) {
+    Clock::time_point start = Clock::now();
+    saveSnapshot(world, states[frame % ROLLBACK_WINDOW]);
+    statistics.saveNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    statistics.saves++;
+    if (frame % CHECK_INTERVAL == 0) {
+        checksums[frame / CHECK_INTERVAL % CHECK_RING] = {frame, hashWorld(world)};
+    }
+
+    uint8_t buttons[2];
+    buttons[localPlayer] = localInputs[frame % ROLLBACK_WINDOW];
+    buttons[1 - localPlayer] = remoteUsed[frame % ROLLBACK_WINDOW] = remoteInput(frame);
+    for (int owner = 0; owner < 2; owner++) {
+        world.applyInput(owner, buttons[owner]);
+    }
+    world.step();
+}
+
+bool RollbackSession::readyToAdvance() {
+    if (waitTicks > 0) {
+        waitTicks--;
+        statistics.stalls++;
+        return false;
+    }
+    if (currentFrame >= remoteFrames + config.maxPrediction) {
+        statistics.stalls++;
+        return false;
+    }
+    return true;
+}
+
+void RollbackSession::advance(uint8_t localButtons) {
+    localInputs[(currentFrame + config.inputDelay) % ROLLBACK_WINDOW] = localButtons;
+    simulate(currentFrame);
+    currentFrame++;
+
+    // Both sides see the other behind by the latency, the difference of the two
+    // views is twice the actual offset. The peer ahead waits for the other one
+    // so neither keeps running into its prediction window.
+    if (currentFrame % TIME_SYNC_INTERVAL == 0) {
+        int advantage = (int)(currentFrame - peerFrame);
+        int offset = (advantage - peerAdvantage) / 2;
+        if (offset >= 1) {
+            waitTicks = std::min((uint32_t)offset, MAX_WAIT_TICKS);
+        }
+    }
+    send();
+    sentSincePoll = true;
+}
+
+void RollbackSession::poll() {
+    uint32_t firstWrong = currentFrame;
+    std::vector<uint8_t> packet;
+    NetAddress from;
+    while (socket.receive(from, packet)) {
+        if (from == peer) {
+            firstWrong = std::min(firstWrong, receive(packet));
+        }
+    }
+    if (firstWrong < currentFrame) {
+        rollback(firstWrong);
+    }
+    // keep the inputs flowing while stalled, the peer may be waiting for them
+    if (!sentSincePoll) {
+        send();
+    }
+    sentSincePoll = false;
+}
+
+uint32_t RollbackSession::receive(const std::vector<uint8_t>& packet) {
+    uint32_t firstWrong = currentFrame;
+    PacketReader r(packet);
+    NetMessage type;
+    int player;
+    if (!readHeader(r, type, player) || player == localPlayer) {
+        return firstWrong;
+    }
+    if (type == NetMessage::HELLO && localPlayer == 0) {
+        sendWelcome(socket, peer, seed);
+        return firstWrong;
+    }
+    if (type != NetMessage::INPUT) {
+        return firstWrong;
+    }
+
+    uint32_t frame = r.value<uint32_t>();
+    int32_t advantage = r.value<int32_t>();
+    uint32_t ack = r.value<uint32_t>();
+    uint32_t start = r.value<uint32_t>();
+    uint8_t count = r.value<uint8_t>();
+    const uint8_t* inputs = r.p;
+    r.p += std::min<size_t>(count, r.end - r.p);
+    uint32_t checkFrame = r.value<uint32_t>();
+    uint64_t checkHash = r.value<uint64_t>();
+    if (!r.ok || r.p != r.end) {
+        return firstWrong;
+    }
+    lastReceived = Clock::now();
+    // packets may arrive out of order, only the newest one tells where the peer is
+    if (frame >= peerFrame) {
+        peerFrame = frame;
+        peerAdvantage = advantage;
+    }
+    peerAck = std::max(peerAck, std::min(ack, currentFrame + config.inputDelay));
+
+    // take the inputs that continue the ones we have, a gap waits for the resend
+    for (uint32_t f = start; f < start + count && f <= remoteFrames; f++) {
+        if (f < remoteFrames) {
+            continue;
+        }
+        if (f >= currentFrame + ROLLBACK_WINDOW / 2) {
+            break; // the peer cannot be that far ahead, the ring would overwrite frames still needed
+        }
+        uint8_t buttons = inputs[f - start];
+        remoteInputs[f % ROLLBACK_WINDOW] = buttons;
+        if (f < currentFrame && remoteUsed[f % ROLLBACK_WINDOW] != buttons) {
+            firstWrong = std::min(firstWrong, f);
+        }
+        remoteFrames++;
+    }
+
+    if (checkFrame != UINT32_MAX) {
+        compareChecksum(checkFrame, checkHash);
+    }
+    return firstWrong;
+}
+
+void RollbackSession::compareChecksum(uint32_t frame, uint64_t hash) {
+    const Checksum& own = checksums[frame / CHECK_INTERVAL % CHECK_RING];
+    // our state at that frame may still be a prediction, the peer sends it again
+    if (own.frame != frame || frame > confirmedFrame()) {
+        return;
+    }
+    if (own.hash != hash && desyncFrame == UINT32_MAX) {
+        desyncFrame = frame;
+    }
+}
+
+void RollbackSession::rollback(uint32_t toFrame) {
+    // events of the ticks run again were reported when they first ran
+    std::vector<SimEvent> reported = std::move(world.events);
+    const std::vector<uint8_t>& state = states[toFrame % ROLLBACK_WINDOW];
+    Clock::time_point start = Clock::now();
+    loadSnapshot(world, state.data(), state.size());
+    statistics.restoreNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    statistics.restores++;
+
+    for (uint32_t frame = toFrame; frame < currentFrame; frame++) {
+        simulate(frame);
+    }
+    world.events = std::move(reported);
+
+    uint32_t ticks = currentFrame - toFrame;
+    statistics.rollbacks++;
+    statistics.resimulated += ticks;
+    statistics.maxRollback = std::max(statistics.maxRollback, ticks);
+}
+
+void RollbackSession::send() {
+    PacketWriter w;
+    writeHeader(w, NetMessage::INPUT, localPlayer);
+    w.value(currentFrame);
+    w.value((int32_t)(currentFrame - peerFrame));
+    w.value(remoteFrames);
+
+    // every input the peer has not acknowledged, the window bounds how far behind that is
+    uint32_t end = currentFrame + config.inputDelay;
+    uint32_t start = std::max(peerAck, end > ROLLBACK_WINDOW ? end - ROLLBACK_WINDOW : 0);
+    w.value(start);
+    w.value((uint8_t)(end - start));
+    for (uint32_t f = start; f < end; f++) {
+        w.value(localInputs[f % ROLLBACK_WINDOW]);
+    }
+
+    // the latest of our checksums that no rollback can change anymore
+    uint32_t checkFrame = confirmedFrame() / CHECK_INTERVAL * CHECK_INTERVAL;
+    const Checksum& check = checksums[checkFrame / CHECK_INTERVAL % CHECK_RING];
+    if (check.frame == checkFrame && checkFrame < currentFrame) {
+        w.value(check.frame);
+        w.value(check.hash);
+    } else {
+        w.value(UINT32_MAX);
+        w.value((uint64_t)0);
+    }
+    socket.send(peer, w.data.data(), w.data.size());
+}
@@ -0,0 +1,116 @@
+#ifndef NET_ROLLBACK_H
+#define NET_ROLLBACK_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "net/udp.h"
+#include "sim/world.h"
+
+// Online 1v1 by exchanging inputs only.
+// Both peers run the whole simulation. A tick whose remote input has not
+// arrived yet runs on a prediction, and the state before every tick is kept as
+// a snapshot. Once the real input arrives and differs from the prediction, the
+// world is restored to the snapshot of that tick and the ticks since are run
+// again, all within the frame that received it.
+//
+// Packets carry every local input the peer has not acknowledged yet, so a lost
+// packet costs nothing but the prediction it would have confirmed earlier.
+constexpr uint32_t NET_MAGIC = 0x4b424c52; // "RLBK"
+constexpr uint16_t NET_VERSION = 1;
+
+// frames of inputs and snapshots kept, more than any rollback can reach back
+constexpr uint32_t ROLLBACK_WINDOW = 64;
+
+struct RollbackConfig {
+    uint32_t inputDelay;    // ticks between a local press and the tick it applies to, at most 8
+    uint32_t maxPrediction; // ticks the simulation may run past the last confirmed remote input, at most 16
+    float timeout;          // seconds without a packet from the peer before it counts as gone
+};
+
+const RollbackConfig DEFAULT_ROLLBACK = {2, 8, 5.0f};
+
+struct RollbackStats {
+    uint32_t rollbacks;
+    uint32_t resimulated;  // ticks run again after a misprediction
+    uint32_t maxRollback;  // ticks of the longest one
+    uint32_t stalls;       // ticks skipped waiting for the peer or to let it catch up
+    uint64_t saveNanos, restoreNanos;
+    uint32_t saves, restores;
+};
+
+// Handshake before a session. Player 0 listens and picks the seed, player 1
+// knows the address of player 0 and learns the seed from it. Returns false if
+// nothing arrived within timeout seconds, call it again to keep waiting.
+bool connectPeer(UdpSocket& socket, int localPlayer, NetAddress& peer, uint64_t& seed, float timeout);
+
+class RollbackSession {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // world is the freshly created match both peers agreed on, seed is the one it was created with
+    RollbackSession(World& world, UdpSocket& socket, const NetAddress& peer, int localPlayer, uint64_t seed,
+                    const RollbackConfig& config);
+
+    // receives the packets of the peer and rolls back to the first mispredicted tick
+    void poll();
+    // false while the prediction window is used up or while waiting for a peer that runs behind,
+    // the caller skips the tick then
+    bool readyToAdvance();
+    // runs the next tick with the buttons the local player pressed for it
+    void advance(uint8_t localButtons);
+
+    uint32_t frame() const { return currentFrame; } // ticks simulated
+    // ticks whose inputs are all known, the state up to there will not change anymore
+    uint32_t confirmedFrame() const;
+    // buttons of both players at a frame below confirmedFrame(), at most ROLLBACK_WINDOW frames back
+    void confirmedInputs(uint32_t frame, uint8_t* buttons) const;
+    bool disconnected() const;
+    bool desynced() const { return desyncFrame != UINT32_MAX; }
+    uint32_t desyncedAt() const { return desyncFrame; }
+    const RollbackStats& stats() const { return statistics; }
+
+private:
+    World& world;
+    UdpSocket& socket;
+    NetAddress peer;
+    int localPlayer;
+    uint64_t seed;
+    RollbackConfig config;
+
+    uint32_t currentFrame;
+    uint32_t remoteFrames;  // remote inputs received without gaps, for frames below this
+    uint32_t peerAck;       // local inputs the peer has, for frames below this
+    uint32_t peerFrame;     // last frame the peer reported
+    int peerAdvantage;      // how far the peer saw itself ahead of us
+    uint32_t waitTicks;     // ticks to skip so the peer catches up
+    bool sentSincePoll;
+    Clock::time_point lastReceived;
+
+    // rings indexed by frame % ROLLBACK_WINDOW
+    uint8_t localInputs[ROLLBACK_WINDOW];
+    uint8_t remoteInputs[ROLLBACK_WINDOW];
+    uint8_t remoteUsed[ROLLBACK_WINDOW]; // remote buttons the simulated tick ran with
+    std::vector<uint8_t> states[ROLLBACK_WINDOW]; // snapshot before the tick
+
+    // hashWorld every CHECK_INTERVAL ticks, compared with the peer once confirmed
+    struct Checksum {
+        uint32_t frame;
+        uint64_t hash;
+    };
+    static constexpr uint32_t CHECK_INTERVAL = 30;
+    static constexpr uint32_t CHECK_RING = 8;
+    Checksum checksums[CHECK_RING];
+    uint32_t desyncFrame;
+
+    RollbackStats statistics;
+
+    uint8_t remoteInput(uint32_t frame) const; // received or predicted
+    void simulate(uint32_t frame);
+    void rollback(uint32_t toFrame);
+    uint32_t receive(const std::vector<uint8_t>& packet); // the first mispredicted frame, currentFrame if none
+    void compareChecksum(uint32_t frame, uint64_t hash);
+    void send();
+};
+
+#endif
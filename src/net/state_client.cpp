@@ -0,0 +1,160 @@
+#include "net/state_client.h"
+#include <algorithm>
+#include <thread>
+
+// seconds between two JOINs while connecting
+const float JOIN_INTERVAL = 0.1f;
+
+StateClient::StateClient(UdpSocket& socket, const NetAddress& server, float timeout)
+    : socket(socket), server(server), timeout(timeout), localOwner(-1), players(0), lastReceived(Clock::now()),
+      newestSeq(UINT32_MAX), latest(0), drawTick(0.0f), epochSeq(0), inputSeq(0), inputs(), statistics() {
+    std::fill(seqs, seqs + SNAPSHOT_HISTORY, UINT32_MAX);
+}
+
+bool StateClient::connect(float timeout) {
+    auto seconds = [](float s) { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(s)); };
+    Clock::time_point deadline = Clock::now() + seconds(timeout);
+    Clock::time_point nextJoin = Clock::now();
+    std::vector<uint8_t> packet;
+    NetAddress from;
+    while (Clock::now() < deadline) {
+        if (Clock::now() >= nextJoin) {
+            PacketWriter w;
+            writeStateHeader(w, StateMessage::JOIN);
+            socket.send(server, w.data.data(), w.data.size());
+            nextJoin += seconds(JOIN_INTERVAL);
+        }
+        while (socket.receive(from, packet)) {
+            PacketReader r(packet);
+            StateMessage type;
+            if (from != server || !readStateHeader(r, type) || type != StateMessage::WELCOME) {
+                continue;
+            }
+            int owner = r.value<int8_t>();
+            int numPlayers = r.value<uint8_t>();
+            if (r.ok) {
+                localOwner = owner;
+                players = numPlayers;
+                lastReceived = Clock::now();
+                return true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+void StateClient::poll() {
+    std::vector<uint8_t> packet;
+    NetAddress from;
+    while (socket.receive(from, packet)) {
+        if (from == server) {
+            receive(packet);
+        }
+    }
+}
+
+void StateClient::receive(const std::vector<uint8_t>& packet) {
+    PacketReader r(packet);
+    StateMessage type;
+    if (!readStateHeader(r, type) || type != StateMessage::SNAPSHOT) {
+        return;
+    }
+    uint32_t seq = r.value<uint32_t>();
+    uint32_t baseSeq = r.value<uint32_t>();
+    if (!r.ok) {
+        return;
+    }
+    lastReceived = Clock::now();
+    statistics.bytesReceived += packet.size();
+    // only newer snapshots, the acked one is always the newest
+    if (newestSeq != UINT32_MAX && seq <= newestSeq) {
+        statistics.dropped++;
+        return;
+    }
+    static const StateFrame empty = {0, {}};
+    const StateFrame* baseline = &empty;
+    if (baseSeq != UINT32_MAX) {
+        if (seqs[baseSeq % SNAPSHOT_HISTORY] != baseSeq) {
+            statistics.dropped++;
+            return;
+        }
+        baseline = &received[baseSeq % SNAPSHOT_HISTORY];
+    }
+    // decoded aside, the slot may hold the baseline
+    StateFrame frame;
+    if (!decodeDelta(*baseline, r.p, r.remaining(), frame)) {
+        statistics.dropped++;
+        return;
+    }
+    uint32_t slot = seq % SNAPSHOT_HISTORY;
+    received[slot] = std::move(frame);
+    seqs[slot] = seq;
+    uint32_t tick = received[slot].tick;
+    if (newestSeq == UINT32_MAX || tick < latest) {
+        // first snapshot, or the server started a new match
+        epochSeq = seq;
+        drawTick = std::max((float)tick - INTERPOLATION_DELAY, 0.0f);
+    }
+    newestSeq = seq;
+    latest = tick;
+    statistics.snapshots++;
+}
+
+void StateClient::sendInput(uint8_t buttons) {
+    inputs[inputSeq % INPUT_REDUNDANCY] = buttons;
+    uint32_t count = std::min(inputSeq + 1, INPUT_REDUNDANCY);
+    PacketWriter w;
+    writeStateHeader(w, StateMessage::INPUT);
+    w.value(newestSeq);
+    w.value(inputSeq);
+    w.value((uint8_t)count);
+    for (uint32_t s = inputSeq + 1 - count; s <= inputSeq; s++) {
+        w.value(inputs[s % INPUT_REDUNDANCY]);
+    }
+    socket.send(server, w.data.data(), w.data.size());
+    inputSeq++;
+}
+
+void StateClient::advance(float seconds, int tickRate) {
+    if (newestSeq == UINT32_MAX) {
+        return;
+    }
+    // never past the newest snapshot, and back to the delay after falling far behind
+    float target = (float)latest - INTERPOLATION_DELAY;
+    drawTick = std::min(drawTick + seconds * tickRate, (float)latest);
+    if (drawTick < target - 2 * SNAPSHOT_INTERVAL) {
+        drawTick = target;
+    }
+}
+
+bool StateClient::sample(StateFrame& out) const {
+    if (newestSeq == UINT32_MAX) {
+        return false;
+    }
+    // the snapshots of this match right before and after the drawn tick
+    const StateFrame* before = nullptr;
+    const StateFrame* after = nullptr;
+    for (uint32_t i = 0; i < SNAPSHOT_HISTORY; i++) {
+        if (seqs[i] == UINT32_MAX || seqs[i] < epochSeq) {
+            continue;
+        }
+        const StateFrame& frame = received[i];
+        if (frame.tick <= drawTick && (before == nullptr || frame.tick > before->tick)) {
+            before = &frame;
+        }
+        if (frame.tick > drawTick && (after == nullptr || frame.tick < after->tick)) {
+            after = &frame;
+        }
+    }
+    if (before == nullptr || after == nullptr) {
+        out = before != nullptr ? *before : *after;
+        return true;
+    }
+    interpolate(*before, *after, (drawTick - before->tick) / (after->tick - before->tick), out);
+    return true;
+}
+
+bool StateClient::disconnected() const {
+    return Clock::now() - lastReceived > std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(timeout));
+}
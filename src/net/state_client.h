@@ -0,0 +1,70 @@
+#ifndef NET_STATE_CLIENT_H
+#define NET_STATE_CLIENT_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "net/state_sync.h"
+#include "net/udp.h"
+
+// Client of a StateServer.
+// Keeps the snapshots it received, acknowledges the newest with every input,
+// and draws the match INTERPOLATION_DELAY ticks behind the newest snapshot,
+// blending the two around that tick so motion stays smooth between snapshots
+// and over a lost one.
+struct StateClientStats {
+    uint64_t bytesReceived;
+    uint32_t snapshots;
+    uint32_t dropped; // snapshots that came too late or whose baseline was gone
+};
+
+class StateClient {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    StateClient(UdpSocket& socket, const NetAddress& server, float timeout = 5.0f);
+
+    // sends JOIN until the server welcomes us, false if that took longer than timeout seconds,
+    // call it again to keep waiting
+    bool connect(float timeout);
+    int owner() const { return localOwner; } // -1 watches
+    int numPlayers() const { return players; }
+
+    // receives snapshots
+    void poll();
+    // once per tick, with the buttons held and pressed during it
+    void sendInput(uint8_t buttons);
+    // moves the drawn tick on by seconds at the given tick rate
+    void advance(float seconds, int tickRate);
+    // the match at the drawn tick, false before the first snapshot
+    bool sample(StateFrame& out) const;
+
+    bool disconnected() const;
+    uint32_t latestTick() const { return latest; }
+    const StateClientStats& stats() const { return statistics; }
+
+private:
+    UdpSocket& socket;
+    NetAddress server;
+    float timeout;
+    int localOwner;
+    int players;
+    Clock::time_point lastReceived;
+
+    // indexed by seq % SNAPSHOT_HISTORY, seqs[i] is UINT32_MAX while empty
+    StateFrame received[SNAPSHOT_HISTORY];
+    uint32_t seqs[SNAPSHOT_HISTORY];
+    uint32_t newestSeq; // UINT32_MAX before the first snapshot
+    uint32_t latest;    // tick of the newest snapshot
+    float drawTick;
+    uint32_t epochSeq;  // first snapshot of the current match, the older ones are not drawn
+
+    uint32_t inputSeq;
+    uint8_t inputs[INPUT_REDUNDANCY]; // indexed by seq % INPUT_REDUNDANCY
+
+    StateClientStats statistics;
+
+    void receive(const std::vector<uint8_t>& packet);
+};
+
+#endif
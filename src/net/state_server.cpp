@@ -0,0 +1,242 @@
+#include "net/state_server.h"
+#include <algorithm>
+#include <cmath>
+
+// cells of the bullet grid, about the reach of a spaceship over a snapshot interval
+const float GRID_CELL_SIZE = 64.0f;
+
+StateServer::StateServer(const World& world, UdpSocket& socket, float timeout)
+    : world(world), socket(socket), timeout(timeout), sinceSnapshot(0), statistics() {}
+
+void StateServer::poll() {
+    Clock::time_point start = Clock::now();
+    std::vector<uint8_t> packet;
+    NetAddress from;
+    while (socket.receive(from, packet)) {
+        receive(from, packet);
+    }
+    Clock::time_point now = Clock::now();
+    auto limit = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(timeout));
+    connected.erase(std::remove_if(connected.begin(), connected.end(),
+                                   [&](const Client& client) { return now - client.lastReceived > limit; }),
+                    connected.end());
+    statistics.netNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+bool StateServer::controlled(int owner) const {
+    return std::any_of(connected.begin(), connected.end(), [&](const Client& client) { return client.owner == owner; });
+}
+
+uint8_t StateServer::takeInput(int owner) {
+    for (Client& client : connected) {
+        if (client.owner == owner) {
+            uint8_t buttons = client.pressed | client.held;
+            client.pressed = 0;
+            return buttons;
+        }
+    }
+    return 0;
+}
+
+void StateServer::receive(const NetAddress& from, const std::vector<uint8_t>& packet) {
+    PacketReader r(packet);
+    StateMessage type;
+    if (!readStateHeader(r, type)) {
+        return;
+    }
+    auto it = std::find_if(connected.begin(), connected.end(), [&](const Client& client) { return client.address == from; });
+    if (type == StateMessage::JOIN) {
+        if (it == connected.end()) {
+            // the lowest owner nobody plays, or a spectator
+            int owner = 0;
+            while (owner < world.numPlayers() && controlled(owner)) {
+                owner++;
+            }
+            connected.emplace_back();
+            it = connected.end() - 1;
+            it->address = from;
+            it->owner = owner < world.numPlayers() ? owner : -1;
+            it->inputSeq = UINT32_MAX;
+            it->pressed = it->held = 0;
+            it->nextSeq = 0;
+            it->ackSeq = UINT32_MAX;
+        }
+        // answered every time, the first WELCOME may be lost
+        it->lastReceived = Clock::now();
+        welcome(*it);
+        return;
+    }
+    if (type != StateMessage::INPUT || it == connected.end()) {
+        return;
+    }
+    uint32_t ack = r.value<uint32_t>();
+    uint32_t seq = r.value<uint32_t>();
+    uint8_t count = r.value<uint8_t>();
+    if (!r.ok || r.remaining() < count || count == 0) {
+        return;
+    }
+    Client& client = *it;
+    client.lastReceived = Clock::now();
+    // an older ack arriving late must not move the baseline back
+    if (ack != UINT32_MAX && ack < client.nextSeq && (client.ackSeq == UINT32_MAX || ack > client.ackSeq)) {
+        client.ackSeq = ack;
+    }
+    if (client.inputSeq != UINT32_MAX && seq <= client.inputSeq) {
+        return;
+    }
+    // presses of every input not seen yet, held buttons from the newest one
+    uint32_t first = seq + 1 - count;
+    for (uint32_t s = first; s <= seq; s++) {
+        uint8_t buttons = r.value<uint8_t>();
+        if (client.inputSeq == UINT32_MAX || s > client.inputSeq) {
+            client.pressed |= buttons & ~INPUT_ROTATE;
+            client.held = buttons & INPUT_ROTATE;
+        }
+    }
+    client.inputSeq = seq;
+}
+
+void StateServer::welcome(const Client& client) {
+    PacketWriter w;
+    writeStateHeader(w, StateMessage::WELCOME);
+    w.value((int8_t)client.owner);
+    w.value((uint8_t)world.numPlayers());
+    socket.send(client.address, w.data.data(), w.data.size());
+}
+
+void StateServer::sendSnapshots() {
+    if (++sinceSnapshot < SNAPSHOT_INTERVAL || connected.empty()) {
+        return;
+    }
+    sinceSnapshot = 0;
+    Clock::time_point start = Clock::now();
+    // in order of relevance, cut at MAX_SNAPSHOT_ENTITIES
+    shared.clear();
+    for (size_t i = 0; i < world.ships.size(); i++) {
+        shared.push_back(netShip(world, i));
+    }
+    for (size_t i = 0; i < world.powerups.size(); i++) {
+        shared.push_back(netPowerup(world, i));
+    }
+    for (size_t i = 0; i < world.mines.size(); i++) {
+        shared.push_back(netMine(world, i));
+    }
+    for (size_t i = 0; i < world.lasers.size(); i++) {
+        shared.push_back(netLaser(world, i));
+    }
+    if (shared.size() > MAX_SNAPSHOT_ENTITIES) {
+        shared.resize(MAX_SNAPSHOT_ENTITIES);
+    }
+    if (shared.size() < MAX_SNAPSHOT_ENTITIES && !world.bullets.empty()) {
+        grid.build(world);
+    }
+    for (Client& client : connected) {
+        sendSnapshot(client);
+    }
+    statistics.netNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+void StateServer::sendSnapshot(Client& client) {
+    uint32_t seq = client.nextSeq++;
+    StateFrame& frame = client.sent[seq % SNAPSHOT_HISTORY];
+    frame.tick = world.tick;
+    frame.entities = shared;
+    size_t room = MAX_SNAPSHOT_ENTITIES - shared.size();
+    if (room > 0 && !world.bullets.empty()) {
+        int active = client.owner >= 0 ? world.activeIndex(client.owner) : -1;
+        Vector2 focus = active >= 0 ? world.ships.transform[active].pos
+                                    : Vector2(world.config.w / 2.0f, world.config.h / 2.0f);
+        grid.nearest(world, focus, room, bulletRows);
+        for (uint32_t row : bulletRows) {
+            frame.entities.push_back(netBullet(world, row));
+        }
+    }
+    std::sort(frame.entities.begin(), frame.entities.end(), [](const NetEntity& a, const NetEntity& b) { return a.id < b.id; });
+
+    // the acked snapshot is still in the history unless the client fell far behind
+    uint32_t baseSeq = client.ackSeq;
+    static const StateFrame empty = {0, {}};
+    const StateFrame* baseline = &empty;
+    if (baseSeq != UINT32_MAX && seq - baseSeq < SNAPSHOT_HISTORY) {
+        baseline = &client.sent[baseSeq % SNAPSHOT_HISTORY];
+    } else {
+        baseSeq = UINT32_MAX;
+        statistics.fullSnapshots++;
+    }
+    encodeDelta(*baseline, frame, encoded);
+
+    PacketWriter w;
+    writeStateHeader(w, StateMessage::SNAPSHOT);
+    w.value(seq);
+    w.value(baseSeq);
+    w.bytes(encoded.data(), encoded.size());
+    socket.send(client.address, w.data.data(), w.data.size());
+    statistics.bytesSent += w.data.size();
+    statistics.snapshots++;
+}
+
+void StateServer::BulletGrid::build(const World& world) {
+    cellSize = GRID_CELL_SIZE;
+    columns = std::max(1, (int)std::ceil(world.config.w / cellSize));
+    rows = std::max(1, (int)std::ceil(world.config.h / cellSize));
+    auto cellOf = [&](Vector2 pos) {
+        int cx = std::clamp((int)(pos.x / cellSize), 0, columns - 1);
+        int cy = std::clamp((int)(pos.y / cellSize), 0, rows - 1);
+        return cy * columns + cx;
+    };
+    // counting sort by cell
+    const BulletTable& bullets = world.bullets;
+    cellStart.assign(columns * rows + 1, 0);
+    for (size_t i = 0; i < bullets.size(); i++) {
+        cellStart[cellOf(bullets.pos[i]) + 1]++;
+    }
+    for (size_t c = 1; c < cellStart.size(); c++) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    order.resize(bullets.size());
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < bullets.size(); i++) {
+        order[fill[cellOf(bullets.pos[i])]++] = (uint32_t)i;
+    }
+}
+
+void StateServer::BulletGrid::nearest(const World& world, Vector2 center, size_t count, std::vector<uint32_t>& out) const {
+    out.clear();
+    int cx = std::clamp((int)(center.x / cellSize), 0, columns - 1);
+    int cy = std::clamp((int)(center.y / cellSize), 0, rows - 1);
+    auto addCell = [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= columns || y >= rows) {
+            return;
+        }
+        int cell = y * columns + x;
+        out.insert(out.end(), order.begin() + cellStart[cell], order.begin() + cellStart[cell + 1]);
+    };
+    // rings of cells around the center until there are enough, then one more:
+    // a bullet in the next ring can still be nearer than one in a ring corner
+    int maxRing = std::max(columns, rows);
+    int lastRing = maxRing;
+    for (int ring = 0; ring <= std::min(lastRing, maxRing); ring++) {
+        if (ring == 0) {
+            addCell(cx, cy);
+        } else {
+            for (int x = cx - ring; x <= cx + ring; x++) {
+                addCell(x, cy - ring);
+                addCell(x, cy + ring);
+            }
+            for (int y = cy - ring + 1; y <= cy + ring - 1; y++) {
+                addCell(cx - ring, y);
+                addCell(cx + ring, y);
+            }
+        }
+        if (lastRing == maxRing && out.size() >= count) {
+            lastRing = ring + 1;
+        }
+    }
+    if (out.size() > count) {
+        const std::vector<Vector2>& pos = world.bullets.pos;
+        std::nth_element(out.begin(), out.begin() + count, out.end(), [&](uint32_t a, uint32_t b) {
+            return pos[a].distanceSquared(center) < pos[b].distanceSquared(center);
+        });
+        out.resize(count);
+    }
+}
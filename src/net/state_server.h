@@ -0,0 +1,85 @@
+#ifndef NET_STATE_SERVER_H
+#define NET_STATE_SERVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "net/state_sync.h"
+#include "net/udp.h"
+
+// Dedicated server of one match.
+// The first clients to join play the owners of the world in order, later ones
+// watch. Each gets a snapshot every SNAPSHOT_INTERVAL ticks with the entities
+// most relevant to it: every ship, powerup, laser and mine, then the bullets
+// nearest to its active spaceship up to MAX_SNAPSHOT_ENTITIES. The snapshot is
+// encoded against the last one the client acknowledged, so what did not
+// change since costs nothing, and neither the packet size nor the work per
+// client grows with the number of bullets in the arena.
+struct StateServerStats {
+    uint64_t bytesSent;     // snapshots to every client
+    uint32_t snapshots;
+    uint32_t fullSnapshots; // sent without a baseline the client had
+    uint64_t netNanos;      // receiving inputs, picking and encoding snapshots
+};
+
+class StateServer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // world is the match to serve, its tables are read after every step
+    StateServer(const World& world, UdpSocket& socket, float timeout = 5.0f);
+
+    // receives joins and inputs, drops clients not heard from within the timeout
+    void poll();
+    bool controlled(int owner) const; // a client plays owner
+    // buttons of the client playing owner for the next tick, presses since the last call are consumed
+    uint8_t takeInput(int owner);
+    // after every world.step, sends the snapshots every SNAPSHOT_INTERVAL calls
+    void sendSnapshots();
+
+    size_t clients() const { return connected.size(); }
+    const StateServerStats& stats() const { return statistics; }
+
+private:
+    struct Client {
+        NetAddress address;
+        int owner; // -1 watches
+        Clock::time_point lastReceived;
+        uint32_t inputSeq; // newest input applied, UINT32_MAX before the first
+        uint8_t pressed;   // one-shot buttons since the last tick
+        uint8_t held;      // buttons of the newest input that act while held
+        uint32_t nextSeq;  // of the next snapshot
+        uint32_t ackSeq;   // newest snapshot the client has, UINT32_MAX for none
+        StateFrame sent[SNAPSHOT_HISTORY]; // indexed by seq % SNAPSHOT_HISTORY
+    };
+
+    // bullets bucketed by arena cell, rebuilt once per snapshot tick
+    struct BulletGrid {
+        float cellSize;
+        int columns, rows;
+        std::vector<uint32_t> cellStart; // per cell, into order, one past the end for the last
+        std::vector<uint32_t> order;     // bullet rows sorted by cell
+
+        void build(const World& world);
+        // rows of up to count bullets nearest to center
+        void nearest(const World& world, Vector2 center, size_t count, std::vector<uint32_t>& out) const;
+    };
+
+    const World& world;
+    UdpSocket& socket;
+    float timeout;
+    std::vector<Client> connected;
+    uint32_t sinceSnapshot; // sendSnapshots calls since the last snapshots went out
+    StateServerStats statistics;
+
+    BulletGrid grid;
+    std::vector<NetEntity> shared; // ships, powerups, lasers and mines, the same for every client
+    std::vector<uint32_t> bulletRows;
+    std::vector<uint8_t> encoded;
+
+    void receive(const NetAddress& from, const std::vector<uint8_t>& packet);
+    void welcome(const Client& client);
+    void sendSnapshot(Client& client);
+};
+
+#endif
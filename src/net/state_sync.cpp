@@ -0,0 +1,437 @@
+#include "net/state_sync.h"
+#include <algorithm>
+#include <cmath>
+
+// changed fields of an entity, NEW sends the kind and every field raw
+enum FieldBits : uint8_t {
+    FIELD_OWNER = 1 << 0,
+    FIELD_VALUE = 1 << 1,
+    FIELD_ACTIVE = 1 << 2,
+    FIELD_POS = 1 << 3,
+    FIELD_ANGLE = 1 << 4,
+    FIELD_TIMER = 1 << 5,
+    FIELD_NEW = 1 << 7
+};
+
+void writeStateHeader(PacketWriter& w, StateMessage type) {
+    w.value(STATE_MAGIC);
+    w.value(STATE_VERSION);
+    w.value((uint8_t)type);
+}
+
+bool readStateHeader(PacketReader& r, StateMessage& type) {
+    bool valid = r.value<uint32_t>() == STATE_MAGIC && r.value<uint16_t>() == STATE_VERSION;
+    type = (StateMessage)r.value<uint8_t>();
+    return r.ok && valid;
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) {
+            return false;
+        }
+        uint8_t byte = *p++;
+        v |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// small differences of either sign as small varints
+static void putSigned(std::vector<uint8_t>& out, int32_t v) {
+    putVarint(out, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static bool getSigned(const uint8_t*& p, const uint8_t* end, int32_t& v) {
+    uint32_t u;
+    if (!getVarint(p, end, u)) {
+        return false;
+    }
+    v = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+    return true;
+}
+
+static void putU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back((uint8_t)v);
+    out.push_back((uint8_t)(v >> 8));
+}
+
+static bool getU16(const uint8_t*& p, const uint8_t* end, uint16_t& v) {
+    if (end - p < 2) {
+        return false;
+    }
+    v = p[0] | (p[1] << 8);
+    p += 2;
+    return true;
+}
+
+static bool getU8(const uint8_t*& p, const uint8_t* end, uint8_t& v) {
+    if (p == end) {
+        return false;
+    }
+    v = *p++;
+    return true;
+}
+
+static uint16_t quantizePosition(float v) {
+    return (uint16_t)std::clamp(std::lround(v * POSITION_SCALE), 0l, 65535l);
+}
+
+static uint16_t quantizeAngle(float degrees) {
+    float a = std::fmod(degrees, 360.0f);
+    if (a < 0.0f) {
+        a += 360.0f;
+    }
+    return (uint16_t)((uint32_t)std::lround(a * ANGLE_SCALE) & 0xffff);
+}
+
+static NetEntity netEntity(int id, EntityKind kind, int owner, Vector2 pos, float angle) {
+    NetEntity e = {};
+    e.id = id;
+    e.kind = kind;
+    e.owner = (uint8_t)owner;
+    e.x = quantizePosition(pos.x);
+    e.y = quantizePosition(pos.y);
+    e.angle = quantizeAngle(angle);
+    return e;
+}
+
+NetEntity netShip(const World& world, size_t row) {
+    const ShipTable& ships = world.ships;
+    NetEntity e = netEntity(ships.id[row], EntityKind::SHIP, ships.owner[row], ships.transform[row].pos, ships.transform[row].angle);
+    e.value = (uint8_t)std::clamp(ships.value[row], 0, 255);
+    e.active = world.activeShip[ships.owner[row]] == ships.id[row];
+    return e;
+}
+
+NetEntity netBullet(const World& world, size_t row) {
+    const BulletTable& bullets = world.bullets;
+    return netEntity(bullets.id[row], EntityKind::BULLET, bullets.owner[row], bullets.pos[row], bullets.angle[row]);
+}
+
+NetEntity netLaser(const World& world, size_t row) {
+    const LaserTable& lasers = world.lasers;
+    return netEntity(lasers.id[row], EntityKind::LASER, lasers.owner[row], lasers.pos[row], lasers.angle[row]);
+}
+
+NetEntity netMine(const World& world, size_t row) {
+    const MineTable& mines = world.mines;
+    NetEntity e = netEntity(mines.id[row], EntityKind::MINE, mines.owner[row], mines.pos[row], 0.0f);
+    MinePhase phase = mines.phase[row];
+    e.value = (uint8_t)phase;
+    if (phase == MinePhase::ACTIVATED) {
+        e.timer = (uint16_t)std::min<uint32_t>(mines.explodeAt[row] - world.tick, 65535);
+    } else if (phase == MinePhase::EXPLODING) {
+        e.timer = (uint16_t)std::min<uint32_t>(mines.spentAt[row] - world.tick, 65535);
+    }
+    return e;
+}
+
+NetEntity netPowerup(const World& world, size_t row) {
+    const PowerupTable& powerups = world.powerups;
+    NetEntity e = netEntity(powerups.id[row], EntityKind::POWERUP, (int)powerups.type[row], powerups.pos[row], 0.0f);
+    e.value = (uint8_t)std::clamp(std::lround(powerups.radius[row]), 0l, 255l);
+    return e;
+}
+
+static uint8_t changedFields(const NetEntity& a, const NetEntity& b) {
+    if (a.kind != b.kind) {
+        return FIELD_NEW;
+    }
+    uint8_t mask = 0;
+    if (a.owner != b.owner) mask |= FIELD_OWNER;
+    if (a.value != b.value) mask |= FIELD_VALUE;
+    if (a.active != b.active) mask |= FIELD_ACTIVE;
+    if (a.x != b.x || a.y != b.y) mask |= FIELD_POS;
+    if (a.angle != b.angle) mask |= FIELD_ANGLE;
+    if (a.timer != b.timer) mask |= FIELD_TIMER;
+    return mask;
+}
+
+static void putEntity(std::vector<uint8_t>& out, uint8_t mask, const NetEntity* base, const NetEntity& e) {
+    out.push_back(mask);
+    if (mask & FIELD_NEW) {
+        out.push_back((uint8_t)e.kind);
+        mask = 0xff;
+    }
+    if (mask & FIELD_OWNER) out.push_back(e.owner);
+    if (mask & FIELD_VALUE) out.push_back(e.value);
+    if (mask & FIELD_ACTIVE) out.push_back(e.active);
+    if (mask & FIELD_POS) {
+        if (base == nullptr) {
+            putU16(out, e.x);
+            putU16(out, e.y);
+        } else {
+            putSigned(out, (int32_t)e.x - base->x);
+            putSigned(out, (int32_t)e.y - base->y);
+        }
+    }
+    if (mask & FIELD_ANGLE) {
+        if (base == nullptr) {
+            putU16(out, e.angle);
+        } else {
+            putSigned(out, (int16_t)(e.angle - base->angle));
+        }
+    }
+    if (mask & FIELD_TIMER) putVarint(out, e.timer);
+}
+
+void encodeDelta(const StateFrame& baseline, const StateFrame& frame, std::vector<uint8_t>& out) {
+    out.clear();
+    putVarint(out, frame.tick);
+    // both lists are sorted by id, one merge finds what was removed and what changed
+    std::vector<int32_t> removed;
+    std::vector<uint8_t> updates;
+    uint32_t updateCount = 0;
+    int32_t lastId = 0;
+    const std::vector<NetEntity>& before = baseline.entities;
+    const std::vector<NetEntity>& after = frame.entities;
+    size_t i = 0, j = 0;
+    while (i < before.size() || j < after.size()) {
+        if (j == after.size() || (i < before.size() && before[i].id < after[j].id)) {
+            removed.push_back(before[i++].id);
+            continue;
+        }
+        const NetEntity& e = after[j++];
+        const NetEntity* base = nullptr;
+        uint8_t mask = FIELD_NEW;
+        if (i < before.size() && before[i].id == e.id) {
+            base = &before[i++];
+            mask = changedFields(*base, e);
+            if (mask == 0) {
+                continue;
+            }
+            if (mask & FIELD_NEW) {
+                base = nullptr;
+            }
+        }
+        putVarint(updates, e.id - lastId);
+        lastId = e.id;
+        putEntity(updates, mask, base, e);
+        updateCount++;
+    }
+
+    putVarint(out, removed.size());
+    int32_t previous = 0;
+    for (int32_t id : removed) {
+        putVarint(out, id - previous);
+        previous = id;
+    }
+    putVarint(out, updateCount);
+    out.insert(out.end(), updates.begin(), updates.end());
+}
+
+bool decodeDelta(const StateFrame& baseline, const uint8_t* data, size_t size, StateFrame& out) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    uint32_t tick, count;
+    if (!getVarint(p, end, tick) || !getVarint(p, end, count)) {
+        return false;
+    }
+    out.tick = tick;
+    // every id takes a byte at least, a larger count is malformed and must not size an allocation
+    if (count > (size_t)(end - p)) {
+        return false;
+    }
+
+    // baseline minus the removed ids
+    std::vector<int32_t> removed(count);
+    int32_t id = 0;
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t delta;
+        if (!getVarint(p, end, delta)) {
+            return false;
+        }
+        id += delta;
+        removed[k] = id;
+    }
+    std::vector<NetEntity> kept;
+    kept.reserve(baseline.entities.size());
+    size_t r = 0;
+    for (const NetEntity& e : baseline.entities) {
+        while (r < removed.size() && removed[r] < e.id) {
+            r++;
+        }
+        if (r == removed.size() || removed[r] != e.id) {
+            kept.push_back(e);
+        }
+    }
+
+    // updates and new entities, merged in id order
+    if (!getVarint(p, end, count) || count > (size_t)(end - p)) {
+        return false;
+    }
+    out.entities.clear();
+    out.entities.reserve(kept.size() + count);
+    size_t k = 0;
+    id = 0;
+    for (uint32_t n = 0; n < count; n++) {
+        uint32_t delta;
+        uint8_t mask;
+        if (!getVarint(p, end, delta) || !getU8(p, end, mask)) {
+            return false;
+        }
+        id += delta;
+        while (k < kept.size() && kept[k].id < id) {
+            out.entities.push_back(kept[k++]);
+        }
+        NetEntity e = {};
+        const NetEntity* base = nullptr;
+        if (k < kept.size() && kept[k].id == id) {
+            e = kept[k++];
+            base = &e;
+        }
+        e.id = id;
+        if (mask & FIELD_NEW) {
+            uint8_t kind;
+            if (!getU8(p, end, kind) || kind > (uint8_t)EntityKind::POWERUP) {
+                return false;
+            }
+            e.kind = (EntityKind)kind;
+            base = nullptr;
+            mask = 0xff;
+        } else if (base == nullptr) {
+            return false; // a change to an entity the baseline does not have
+        }
+        bool ok = true;
+        if (mask & FIELD_OWNER) ok &= getU8(p, end, e.owner);
+        if (mask & FIELD_VALUE) ok &= getU8(p, end, e.value);
+        if (mask & FIELD_ACTIVE) ok &= getU8(p, end, e.active);
+        if (mask & FIELD_POS) {
+            if (base == nullptr) {
+                ok &= getU16(p, end, e.x) && getU16(p, end, e.y);
+            } else {
+                int32_t dx = 0, dy = 0;
+                ok &= getSigned(p, end, dx) && getSigned(p, end, dy);
+                e.x = (uint16_t)(e.x + dx);
+                e.y = (uint16_t)(e.y + dy);
+            }
+        }
+        if (mask & FIELD_ANGLE) {
+            if (base == nullptr) {
+                ok &= getU16(p, end, e.angle);
+            } else {
+                int32_t da = 0;
+                ok &= getSigned(p, end, da);
+                e.angle = (uint16_t)(e.angle + da);
+            }
+        }
+        if (mask & FIELD_TIMER) {
+            uint32_t timer = 0;
+            ok &= getVarint(p, end, timer);
+            e.timer = (uint16_t)timer;
+        }
+        if (!ok) {
+            return false;
+        }
+        out.entities.push_back(e);
+    }
+    out.entities.insert(out.entities.end(), kept.begin() + k, kept.end());
+    return p == end;
+}
+
+void interpolate(const StateFrame& a, const StateFrame& b, float t, StateFrame& out) {
+    out.tick = t < 0.5f ? a.tick : b.tick;
+    out.entities.clear();
+    size_t i = 0, j = 0;
+    while (i < a.entities.size() || j < b.entities.size()) {
+        if (j == b.entities.size() || (i < a.entities.size() && a.entities[i].id < b.entities[j].id)) {
+            if (t < 0.5f) {
+                out.entities.push_back(a.entities[i]);
+            }
+            i++;
+        } else if (i == a.entities.size() || b.entities[j].id < a.entities[i].id) {
+            if (t >= 0.5f) {
+                out.entities.push_back(b.entities[j]);
+            }
+            j++;
+        } else {
+            const NetEntity& from = a.entities[i++];
+            NetEntity e = b.entities[j++];
+            e.x = (uint16_t)std::lround(from.x + ((int32_t)e.x - from.x) * t);
+            e.y = (uint16_t)std::lround(from.y + ((int32_t)e.y - from.y) * t);
+            e.angle = (uint16_t)(from.angle + (int32_t)std::lround((int16_t)(e.angle - from.angle) * t));
+            if (t < 0.5f) {
+                e.value = from.value;
+                e.active = from.active;
+                e.timer = from.timer;
+            }
+            out.entities.push_back(e);
+        }
+    }
+}
+
+template <class Table>
+static size_t addRow(Table& table, int id) {
+    size_t row = table.size();
+    table.forEachColumn([&](auto& column) { column.resize(row + 1); });
+    table.id[row] = id;
+    return row;
+}
+
+void buildView(const StateFrame& frame, World& view) {
+    view.ships.clear();
+    view.bullets.clear();
+    view.lasers.clear();
+    view.mines.clear();
+    view.powerups.clear();
+    std::fill(view.activeShip.begin(), view.activeShip.end(), -1);
+    view.tick = frame.tick;
+    for (const NetEntity& e : frame.entities) {
+        // owners of no player would index past the teams when rendered
+        if (e.kind != EntityKind::POWERUP && e.owner >= view.numPlayers()) {
+            continue;
+        }
+        Vector2 pos(e.x / POSITION_SCALE, e.y / POSITION_SCALE);
+        float angle = e.angle / ANGLE_SCALE;
+        size_t row;
+        switch (e.kind) {
+            case EntityKind::SHIP:
+                row = addRow(view.ships, e.id);
+                view.ships.transform[row].pos = pos;
+                view.ships.transform[row].angle = angle;
+                view.ships.owner[row] = e.owner;
+                view.ships.value[row] = e.value;
+                if (e.active && e.owner < view.activeShip.size()) {
+                    view.activeShip[e.owner] = e.id;
+                }
+                break;
+            case EntityKind::BULLET:
+                row = addRow(view.bullets, e.id);
+                view.bullets.owner[row] = e.owner;
+                view.bullets.pos[row] = pos;
+                view.bullets.angle[row] = angle;
+                break;
+            case EntityKind::LASER:
+                row = addRow(view.lasers, e.id);
+                view.lasers.owner[row] = e.owner;
+                view.lasers.pos[row] = pos;
+                view.lasers.angle[row] = angle;
+                break;
+            case EntityKind::MINE:
+                row = addRow(view.mines, e.id);
+                view.mines.owner[row] = e.owner;
+                view.mines.pos[row] = pos;
+                view.mines.phase[row] = (MinePhase)e.value;
+                view.mines.explodeAt[row] = view.mines.spentAt[row] = frame.tick + e.timer;
+                break;
+            case EntityKind::POWERUP:
+                row = addRow(view.powerups, e.id);
+                view.powerups.pos[row] = pos;
+                view.powerups.radius[row] = e.value;
+                view.powerups.type[row] = (ProjectileType)e.owner;
+                break;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef NET_STATE_SYNC_H
+#define NET_STATE_SYNC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "net/packet.h"
+#include "sim/world.h"
+
+// What a client of the dedicated server sees of the world: the entities it was
+// sent, with positions and angles quantized, enough to draw the match.
+// The server runs the only simulation, clients send it their buttons and draw
+// what the snapshots tell them.
+constexpr uint32_t STATE_MAGIC = 0x54415453; // "STAT"
+constexpr uint16_t STATE_VERSION = 1;
+
+constexpr uint32_t SNAPSHOT_INTERVAL = 3;      // ticks between two snapshots to a client
+constexpr size_t MAX_SNAPSHOT_ENTITIES = 64;   // the most relevant ones, a snapshot stays well below one packet
+constexpr uint32_t SNAPSHOT_HISTORY = 32;      // snapshots kept as baselines, per client and on the client
+constexpr uint32_t INTERPOLATION_DELAY = 2 * SNAPSHOT_INTERVAL; // ticks clients draw behind the newest snapshot
+constexpr uint32_t INPUT_REDUNDANCY = 8;       // ticks of buttons every INPUT repeats
+
+enum class StateMessage : uint8_t {
+    JOIN,     // client asks for a place
+    WELCOME,  // server answers with the owner the client plays
+    INPUT,    // client buttons and the newest snapshot it has
+    SNAPSHOT  // server state, delta-encoded
+};
+
+// Packets after the header:
+//   WELCOME  owner i8 (-1 watches), players u8
+//   INPUT    ack u32 (UINT32_MAX for none), seq u32, count u8, the buttons of seq - count + 1 to seq
+//   SNAPSHOT seq u32, baseline seq u32 (UINT32_MAX for none), encodeDelta
+void writeStateHeader(PacketWriter& w, StateMessage type);
+bool readStateHeader(PacketReader& r, StateMessage& type);
+
+enum class EntityKind : uint8_t {
+    SHIP,
+    BULLET,
+    LASER,
+    MINE,
+    POWERUP
+};
+
+constexpr float POSITION_SCALE = 8.0f;          // quantization steps per pixel, positions up to 8191 px
+constexpr float ANGLE_SCALE = 65536.0f / 360.0f; // quantization steps per degree
+
+struct NetEntity {
+    int32_t id;      // world entity id, unique across kinds
+    EntityKind kind;
+    uint8_t owner;   // powerups: ProjectileType
+    uint8_t value;   // ships: value, up to 255; mines: MinePhase
+    uint8_t active;  // ships: the active spaceship of its owner
+    uint16_t x, y;
+    uint16_t angle;
+    uint16_t timer;  // mines: ticks until the next phase
+};
+
+// Entities sorted by id
+struct StateFrame {
+    uint32_t tick;
+    std::vector<NetEntity> entities;
+};
+
+NetEntity netShip(const World& world, size_t row);
+NetEntity netBullet(const World& world, size_t row);
+NetEntity netLaser(const World& world, size_t row);
+NetEntity netMine(const World& world, size_t row);
+NetEntity netPowerup(const World& world, size_t row);
+
+// Encodes frame against baseline, an empty baseline sends everything.
+// Entities gone from the frame are listed by id, the others only carry the
+// fields that changed, positions and angles as small differences.
+void encodeDelta(const StateFrame& baseline, const StateFrame& frame, std::vector<uint8_t>& out);
+// false if the data is malformed, out is undefined then
+bool decodeDelta(const StateFrame& baseline, const uint8_t* data, size_t size, StateFrame& out);
+
+// Blends two frames at t in [0, 1]. Entities in both move along the shortest
+// way between their two positions and angles, the others are taken from the
+// nearer frame.
+void interpolate(const StateFrame& a, const StateFrame& b, float t, StateFrame& out);
+
+// Replaces the tables of view with the entities of frame, for renderWorld.
+// view keeps its config, ticks and timers are derived from frame.tick.
+// Entities owned by no player of view are dropped.
+void buildView(const StateFrame& frame, World& view);
+
+#endif
@@ -0,0 +1,181 @@
+#include "net/udp.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static bool startNetworking() {
+#ifdef _WIN32
+    static bool started = false;
+    if (!started) {
+        WSADATA data;
+        started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+    return started;
+#else
+    return true;
+#endif
+}
+
+bool NetAddress::parse(const char* text, NetAddress& out) {
+    const char* colon = strrchr(text, ':');
+    if (colon == nullptr || !startNetworking()) {
+        return false;
+    }
+    int port = atoi(colon + 1);
+    if (port <= 0 || port > 65535) {
+        return false;
+    }
+    std::string name(text, colon);
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(name.c_str(), nullptr, &hints, &found) != 0 || found == nullptr) {
+        return false;
+    }
+    out.host = ntohl(((sockaddr_in*)found->ai_addr)->sin_addr.s_addr);
+    out.port = (uint16_t)port;
+    freeaddrinfo(found);
+    return true;
+}
+
+UdpSocket::UdpSocket() : handle(-1), conditions{0.0f, 0.0f, 0.0f} {}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(uint16_t port) {
+    close();
+    if (!startNetworking()) {
+        return false;
+    }
+    handle = (intptr_t)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle < 0) {
+        handle = -1;
+        return false;
+    }
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool ok = ioctlsocket((SOCKET)handle, FIONBIO, &nonBlocking) == 0;
+#else
+    bool ok = fcntl((int)handle, F_SETFL, fcntl((int)handle, F_GETFL) | O_NONBLOCK) == 0;
+#endif
+    if (!ok || bind(handle, (sockaddr*)&address, sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle < 0) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket((SOCKET)handle);
+#else
+    ::close((int)handle);
+#endif
+    handle = -1;
+    delayed.clear();
+}
+
+uint16_t UdpSocket::localPort() const {
+    sockaddr_in address = {};
+    socklen_t size = sizeof(address);
+    if (handle < 0 || getsockname(handle, (sockaddr*)&address, &size) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+void UdpSocket::simulate(const NetConditions& conditions, uint64_t seed) {
+    this->conditions = conditions;
+    rng = Rng(seed);
+}
+
+void UdpSocket::sendNow(const NetAddress& to, const uint8_t* data, size_t size) {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(to.host);
+    address.sin_port = htons(to.port);
+    // a full send buffer drops the packet like the network would
+    sendto(handle, (const char*)data, (int)size, 0, (sockaddr*)&address, sizeof(address));
+}
+
+void UdpSocket::send(const NetAddress& to, const uint8_t* data, size_t size) {
+    if (handle < 0) {
+        return;
+    }
+    flush();
+    if (conditions.loss > 0.0f && rng.below(1000000) < conditions.loss * 1000000.0f) {
+        return;
+    }
+    float delay = conditions.latency;
+    if (conditions.jitter > 0.0f) {
+        delay += conditions.jitter * rng.below(1001) / 1000.0f;
+    }
+    if (delay <= 0.0f) {
+        sendNow(to, data, size);
+        return;
+    }
+    auto due = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(delay));
+    delayed.push_back({due, to, std::vector<uint8_t>(data, data + size)});
+}
+
+void UdpSocket::flush() {
+    if (delayed.empty()) {
+        return;
+    }
+    // packets go out in due order, jitter reorders them as it would on the wire
+    Clock::time_point now = Clock::now();
+    std::vector<Delayed> waiting;
+    std::sort(delayed.begin(), delayed.end(), [](const Delayed& a, const Delayed& b) { return a.due < b.due; });
+    for (Delayed& packet : delayed) {
+        if (packet.due <= now) {
+            sendNow(packet.to, packet.data.data(), packet.data.size());
+        } else {
+            waiting.push_back(std::move(packet));
+        }
+    }
+    delayed.swap(waiting);
+}
+
+bool UdpSocket::receive(NetAddress& from, std::vector<uint8_t>& data) {
+    if (handle < 0) {
+        return false;
+    }
+    flush();
+    // larger than any packet we send, anything longer is cut off and rejected by the parser
+    const int MAX_PACKET = 1500;
+    data.resize(MAX_PACKET);
+    sockaddr_in address = {};
+    socklen_t size = sizeof(address);
+    int received = recvfrom(handle, (char*)data.data(), MAX_PACKET, 0, (sockaddr*)&address, &size);
+    if (received < 0) {
+        data.clear();
+        return false;
+    }
+    data.resize(received);
+    from.host = ntohl(address.sin_addr.s_addr);
+    from.port = ntohs(address.sin_port);
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef NET_UDP_H
+#define NET_UDP_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "sim/rng.h"
+
+// IPv4 address and port of a peer, both in host byte order
+struct NetAddress {
+    uint32_t host;
+    uint16_t port;
+
+    bool operator==(const NetAddress& other) const { return host == other.host && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+
+    // "name:port" or "1.2.3.4:port", false if the name does not resolve
+    static bool parse(const char* text, NetAddress& out);
+};
+
+// Network conditions simulated on outgoing packets, to test over loopback.
+// The defaults, all zero, send every packet right away.
+struct NetConditions {
+    float latency; // seconds every packet is held back
+    float jitter;  // up to this many more seconds, picked per packet, so packets may reorder
+    float loss;    // fraction of packets dropped
+};
+
+// Non-blocking UDP socket.
+// Packets delayed by the simulated conditions are sent by the first send or
+// receive call after they are due.
+class UdpSocket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    UdpSocket();
+    ~UdpSocket();
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // binds to port on every interface, 0 picks a free one
+    bool open(uint16_t port);
+    void close();
+    uint16_t localPort() const;
+    void simulate(const NetConditions& conditions, uint64_t seed);
+
+    void send(const NetAddress& to, const uint8_t* data, size_t size);
+    // the next waiting packet, false if there is none
+    bool receive(NetAddress& from, std::vector<uint8_t>& data);
+
+private:
+    struct Delayed {
+        Clock::time_point due;
+        NetAddress to;
+        std::vector<uint8_t> data;
+    };
+
+    intptr_t handle; // -1 while closed
+    NetConditions conditions;
+    Rng rng;
+    std::vector<Delayed> delayed;
+
+    void sendNow(const NetAddress& to, const uint8_t* data, size_t size);
+    void flush();
+};
+
+#endif
@@ -2,43 +2,37 @@
 #include <iostream>
 #include <algorithm>
 
-Player::Player(int playerNumber)
-    : gameSettings(GameSettings::get()), playerNumber(playerNumber), activeSpaceship(0), lastLeftPressTime(0.0), leftPressCount(0), leftHolding(false)
+Player::Player(int playerNumber, World* world, int keySet)
+    : world(world), owner(playerNumber - 1), gameSettings(GameSettings::get()), playerNumber(playerNumber), lastLeftPressTime(0.0), leftPressCount(0), leftHolding(false), pressed(0), held(0)
 {
-
-    playerSettings = gameSettings->playerSettings[playerNumber - 1];
-    float spawnX = (playerNumber == 1) ? gameSettings->w / 8 : 7 * gameSettings->w / 8;
-    for (int i = 1; i <= gameSettings->numStartSpaceships; i++) {
-        float spawnY = gameSettings->h / (gameSettings->numStartSpaceships + 1) * i;
-        spaceships.push_back(std::make_shared<Spaceship>(playerNumber, spawnX, spawnY));
-    }
-    spaceships[activeSpaceship]->toggleActive();
+    playerSettings = gameSettings->playerSettings[keySet >= 0 ? keySet : playerNumber - 1];
+    world->spawnPlayer(owner);
 }
 
 int Player::pNumber() {
     return playerNumber;
 }
 
-void Player::rotate(float deltaTime) {
-    spaceships[activeSpaceship]->rotate(deltaTime * gameSettings->rotationSpeed);
+void Player::rotate() {
+    held |= INPUT_ROTATE;
 }
 
 void Player::rotateAndBoost() {
-    spaceships[activeSpaceship]->rotate(gameSettings->rotBoostDeg);
-    spaceships[activeSpaceship]->applyBoost(); // Boost for 100 ms
+    pressed |= INPUT_BOOST;
 }
 
 void Player::shoot() {
-    auto projectile = spaceships[activeSpaceship]->fire();
-    if (projectile != nullptr) {
-        projectiles.push_back(projectile);
-    }
+    pressed |= INPUT_SHOOT;
 }
 
 void Player::switchActiveSpaceship() {
-    spaceships[activeSpaceship]->toggleActive();
-    activeSpaceship = (activeSpaceship + 1) % spaceships.size();
-    spaceships[activeSpaceship]->toggleActive();
+    pressed |= INPUT_SWITCH;
+}
+
+uint8_t Player::takeInput() {
+    uint8_t buttons = pressed | held;
+    pressed = 0;
+    return buttons;
 }
 
 void Player::handleEvent(SDL_Event& event) {
@@ -86,140 +80,17 @@ void Player::handleEvent(SDL_Event& event) {
 void Player::update(float deltaTime) {
     // Check if the left key is being held down
     const Uint8* keystate = SDL_GetKeyboardState(NULL);
-    if (keystate[playerSettings.leftBtn]) {
-        spaceships[activeSpaceship]->rotate(-gameSettings->rotationSpeed * deltaTime);
-    }
-
-    for (auto spaceship : spaceships) {
-        spaceship->update(deltaTime);
-    }
-
-    for (auto projectile : projectiles) {
-        projectile->update(deltaTime);
-    }
-
-    // removing spaceships with value <= 0 using destroySpaceship
-    std::vector<int> destroyedSpaceships;
-    for (auto spaceship : spaceships) {
-        if (spaceship->value <= 0) {
-            destroyedSpaceships.push_back(spaceship->id);
-        }
-    }
-
-    for (int id : destroyedSpaceships) {
-        destroySpaceship(id);
-    }
-
-    // removing projectiles that are out of life
-    projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(), [](std::shared_ptr<Projectile> projectile) {
-        return projectile->endOfLife();
-    }), projectiles.end());
+    held = keystate[playerSettings.leftBtn] ? INPUT_ROTATE : 0;
 }
 
-void Player::render(SDL_Renderer* renderer) const {
-    for (auto spaceship : spaceships) {
-        spaceship->render(renderer);
-    }
-
-    for (auto projectile : projectiles) {
-        projectile->render(renderer);
-    }
-}
-
-std::vector<std::shared_ptr<Spaceship>> Player::getSpaceships() const {
-    return spaceships;
-}
-
-void Player::mergeSpaceships(int firstId, int secondId) {
-    // Merge two spaceships
-    std::shared_ptr<Spaceship> first = nullptr;
-    std::shared_ptr<Spaceship> second = nullptr;
-
-
-    // If the merging spaceships are the active one
-    // The new spaceship will be the active one
-    // Else not change the active spaceship
-    int activeId = spaceships[activeSpaceship]->id;
-    for (auto spaceship : spaceships) {
-        if (spaceship->id == firstId) {
-            first = spaceship;
-        } else if (spaceship->id == secondId) {
-            second = spaceship;
-        }
-    }
-
-    if (first == nullptr || second == nullptr) {
-        return;
-    }
-
-    std::shared_ptr<Spaceship> newSpaceship = std::make_shared<Spaceship>(playerNumber, (first->pos.x + second->pos.x) / 2, (first->pos.y + second->pos.y) / 2);
-    newSpaceship->velocity = (first->velocity * first->speed + second->velocity * second->speed).normalize();
-    newSpaceship->speed = (first->speed + second->speed) / 2;
-    newSpaceship->angle = abs(first->angle - second->angle) / 2;
-    newSpaceship->value = first->value + second->value;
-
-    // remove the two old spaceships
-    spaceships.erase(std::remove_if(spaceships.begin(), spaceships.end(), [firstId, secondId](std::shared_ptr<Spaceship> spaceship) {
-        return spaceship->id == firstId || spaceship->id == secondId;
-    }), spaceships.end());
-
-    // add the new spaceship and set it as active
-    spaceships.push_back(newSpaceship);
-    if (activeId == firstId || activeId == secondId) {
-        activeSpaceship = spaceships.size() - 1;
-        spaceships[activeSpaceship]->toggleActive();
-        return;
-    } 
-    for (int i = 0; i < spaceships.size(); i++) {
-        if (spaceships[i]->id == activeId) {
-            activeSpaceship = i;
-            return;
-        }
-    }
-}
-
-void Player::destroySpaceship(int id) {
-    // switch to the next spaceship if the active one is destroyed
-    for (int i = 0; i < spaceships.size(); i++) {
-        if (spaceships[i]->id == id) {
-            int activeBefore = activeSpaceship;
-            if (i < activeBefore) {
-                activeSpaceship--;
-            }
-            spaceships.erase(spaceships.begin() + i);
-            if (activeBefore == i) {
-                if (activeSpaceship == spaceships.size()) {
-                    activeSpaceship = 0;
-                }
-                spaceships[activeSpaceship]->toggleActive();
-            }
-            return;
-        }
-    }
+OwnedRows<ShipTable> Player::getSpaceships() const {
+    return world->ships.ownedBy(owner);
 }
 
 bool Player::hasSpaceship() const {
-    return !spaceships.empty();
+    return world->hasSpaceship(owner);
 }
 
 void Player::splitCurrentSpaceship() {
-    auto spaceship = spaceships[activeSpaceship];
-    if (spaceship->value < 2) {
-        return;
-    }
-    auto newSpaceship = std::make_shared<Spaceship>(playerNumber, spaceship->pos.x, spaceship->pos.y);
-    newSpaceship->velocity = Vector2(0.0, 0.0) - spaceship->velocity;
-    newSpaceship->speed = spaceship->speed / 2;
-    newSpaceship->angle = -spaceship->angle;
-    newSpaceship->value = spaceship->value / 2;
-    newSpaceship->readyForSameSideCollision = false;
-    spaceship->value = spaceship->value - newSpaceship->value;
-    spaceship->speed = (spaceship->speed + spaceship->speed / 2) * 2;
-
-    spaceships.push_back(newSpaceship);
-    return;
-}
-
-std::vector<std::shared_ptr<Projectile>> Player::getProjectiles() const {
-    return projectiles;
+    pressed |= INPUT_SPLIT;
 }
@@ -3,37 +3,35 @@
 
 #include <SDL2/SDL.h>
 
-#include "spaceship.h"
 #include "settings.h"
-#include "projectile.h"
+#include "sim/world.h"
 #include <vector>
-#include <unordered_map>
 #include <memory>
 
 class Agent {
 public:
     virtual void handleEvent(SDL_Event& event) = 0;
     virtual void update(float deltaTime) = 0;
-    virtual void render(SDL_Renderer* renderer) const = 0;
-    virtual std::vector<std::shared_ptr<Spaceship>> getSpaceships() const = 0;
-    virtual std::vector<std::shared_ptr<Projectile>> getProjectiles() const = 0;
-    virtual void mergeSpaceships(int firstId, int secondId) = 0;
-    virtual void destroySpaceship(int id) = 0;
+    virtual OwnedRows<ShipTable> getSpaceships() const = 0;
     virtual bool hasSpaceship() const = 0;
     virtual void splitCurrentSpaceship() = 0;
-    virtual void rotate(float deltaTime) = 0;
+    virtual void rotate() = 0;
     virtual void rotateAndBoost() = 0;
     virtual void shoot() = 0;
     virtual void switchActiveSpaceship() = 0;
     virtual int pNumber() = 0;
+    // buttons for the next simulation tick, presses since the last call are consumed
+    virtual uint8_t takeInput() = 0;
 };
 
+// A player is a view into the world: its spaceships and projectiles are the
+// rows of the world's tables owned by playerNumber - 1.
+// Actions are not applied right away, they are collected as InputButton bits
+// that the game applies on the next tick and records in the match replay.
 class Player : public Agent {
 protected:
-    std::vector<std::shared_ptr<Spaceship>> spaceships;
-    std::vector<std::shared_ptr<Projectile>> projectiles;
-    // std::vector<Bullet> bullets; // for future use, collision detection
-    size_t activeSpaceship;
+    World* world;
+    int owner;
     PlayerSettings playerSettings;
     std::shared_ptr<GameSettings> gameSettings;
     int playerNumber;
@@ -41,23 +39,23 @@ protected:
     Uint32 lastLeftPressTime;
     int leftPressCount;
     bool leftHolding;
+    uint8_t pressed; // buttons pressed since the last tick
+    uint8_t held;    // buttons held down this frame
 
     public:
-    Player(int playerNumber);
+    // keySet picks the controls from the settings, by default those of playerNumber
+    Player(int playerNumber, World* world, int keySet = -1);
     void handleEvent(SDL_Event& event) override;
     void update(float deltaTime) override;
-    void render(SDL_Renderer* renderer) const override;
-    std::vector<std::shared_ptr<Spaceship>> getSpaceships() const override;
-    std::vector<std::shared_ptr<Projectile>> getProjectiles() const override;
-    void mergeSpaceships(int firstId, int secondId) override;
-    void destroySpaceship(int id) override;
+    OwnedRows<ShipTable> getSpaceships() const override;
     bool hasSpaceship() const override;
     void splitCurrentSpaceship() override;
-    void rotate(float deltaTime) override;
+    void rotate() override;
     void rotateAndBoost() override;
     void shoot() override;
     void switchActiveSpaceship() override;
     int pNumber() override;
+    uint8_t takeInput() override;
 };
 
 #endif
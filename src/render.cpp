@@ -0,0 +1,135 @@
+#include "render.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "utils.h"
+
+// spaceship colors by team, without blue, which marks the active spaceships
+static const SDL_Color TEAM_COLORS[] = {
+    {255, 0, 0}, {0, 255, 0}, {255, 255, 0}, {255, 128, 0}, {128, 0, 0}, {0, 128, 0}, {128, 128, 0}, {128, 255, 0}
+};
+
+void renderShip(SDL_Renderer* renderer, const World& world, size_t ship, const GameSettings& settings) {
+    const ShipTable& ships = world.ships;
+    int owner = ships.owner[ship];
+    SDL_Color color = TEAM_COLORS[world.team[owner] % (sizeof(TEAM_COLORS) / sizeof(TEAM_COLORS[0]))];
+    if (world.activeShip[owner] == ships.id[ship]) {
+        color.b = 255;
+    }
+    SDL_Texture* texture = renderTextAsTexture(renderer, settings.sdlSettings->font, std::to_string(ships.value[ship]).c_str(), color);
+
+    const Transform& t = ships.transform[ship];
+    int size = world.config.spaceshipSize;
+    SDL_Rect rect = {static_cast<int>(t.pos.x - size / 2), static_cast<int>(t.pos.y - size / 2), size, size};
+    SDL_RenderCopyEx(renderer, texture, NULL, &rect, t.angle + 90.0f, NULL, SDL_FLIP_NONE);
+    SDL_DestroyTexture(texture);
+}
+
+void renderBullet(SDL_Renderer* renderer, const World& world, size_t bullet) {
+    // draw a rectangle with pos as the center and radius as the width and height
+    Vector2 pos = world.bullets.pos[bullet];
+    float radius = world.config.bulletRadius;
+    SDL_Rect rect = {(int)pos.x - radius / 2, (int)pos.y - radius / 2, (int)radius, (int)radius};
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderFillRect(renderer, &rect);
+}
+
+void renderLaserBeam(SDL_Renderer* renderer, const World& world, size_t laser) {
+    const SimConfig& cfg = world.config;
+    Vector2 pos = world.lasers.pos[laser];
+    float angle = world.lasers.angle[laser];
+    float width = cfg.laserBeamWidth;
+    // draw a line with pos as the start point and angle as the angle
+    SDL_SetRenderDrawColor(renderer, 0x00 , 0xdd, 0xc0, 255);
+
+    // detect if the ray cuts the border of the screen and which
+    RayIntersection res = getRayIntersectionBorder(pos, angle, cfg.w, cfg.h);
+    float reflectAngle = angle;
+    if (res.side == BorderSide::LEFT || res.side == BorderSide::RIGHT) {
+        reflectAngle = 180 - angle;
+    } else if (res.side == BorderSide::TOP || res.side == BorderSide::BOTTOM) {
+        reflectAngle = -angle;
+    }
+    Vector2 reflectPos = res.intersectionPoint;
+    // direct ray
+    for (int dx = -width / 2; dx <= width / 2; dx++) {
+        for (int dy = -width / 2; dy <= width / 2; dy++) {
+            SDL_RenderDrawLine(renderer, pos.x + dx, pos.y + dy, pos.x + 2000 * cos(deg2rad(angle)) + dx, pos.y + 2000 * sin(deg2rad(angle)) + dy);
+        }
+    }
+
+    // reflected ray
+    for (int dx = -width / 2; dx <= width / 2; dx++) {
+        for (int dy = -width / 2; dy <= width / 2; dy++) {
+            SDL_RenderDrawLine(renderer, reflectPos.x + dx, reflectPos.y + dy, reflectPos.x + 2000 * cos(reflectAngle * M_PI / 180) + dx, reflectPos.y + 2000 * sin(reflectAngle * M_PI / 180) + dy);
+        }
+    }
+}
+
+void renderMine(SDL_Renderer* renderer, const World& world, size_t mine) {
+    const SimConfig& cfg = world.config;
+    const MineTable& mines = world.mines;
+    Vector2 pos = mines.pos[mine];
+    MinePhase phase = mines.phase[mine];
+    // draw a circle with pos as the center, shrinking and darkening once activated
+    if (phase != MinePhase::EXPLODING) {
+        int size = cfg.mineSize;
+        if (phase == MinePhase::ARMED) {
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        } else {
+            // shrink
+            float activationDuration = (mines.explodeAt[mine] - world.tick) * cfg.tickDuration;
+            size = cfg.mineSize * activationDuration / cfg.mineActivationDuration;
+            float colorScale = 255.0 * activationDuration / cfg.mineActivationDuration;
+            SDL_SetRenderDrawColor(renderer, std::max(int(colorScale), 0), 0, 0, 255);
+        }
+        Circle mineCollisionShape = {pos, size};
+        drawCircle(renderer, mineCollisionShape);
+    } else {
+        float explosionRadius = cfg.mineExplosionRadius;
+        float explosionTimer = (mines.spentAt[mine] - world.tick) * cfg.tickDuration;
+        float radius = explosionRadius * (1 - std::pow(explosionTimer / cfg.mineExplosionDuration, 4));
+        Circle explosionCollisionShape = {pos, radius};
+        Circle shockWaveCollisionShape = {pos, explosionRadius};
+        SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
+        drawCircle(renderer, shockWaveCollisionShape);
+        SDL_SetRenderDrawColor(renderer, 255, 165, 0, 255);
+        drawCircle(renderer, explosionCollisionShape);
+    }
+}
+
+void renderPowerup(SDL_Renderer* renderer, const World& world, size_t powerup, const GameSettings& settings) {
+    Vector2 pos = world.powerups.pos[powerup];
+    float radius = world.powerups.radius[powerup];
+    ProjectileType type = world.powerups.type[powerup];
+    SDL_Texture* texture = nullptr;
+    if (type == ProjectileType::LASER_BEAM) {
+        texture = settings.sdlSettings->laserPowerup;
+    } else if (type == ProjectileType::MINE) {
+        texture = settings.sdlSettings->minePowerup;
+    } else if (type == ProjectileType::PLUS) {
+        texture = settings.sdlSettings->plusPowerup;
+    }
+    if (texture != nullptr) {
+        SDL_Rect dstRect = {(int)pos.x - radius, (int)pos.y - radius, (int)radius * 2, (int)radius * 2};
+        SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
+    }
+}
+
+void renderWorld(SDL_Renderer* renderer, const World& world, const GameSettings& settings) {
+    for (size_t i = 0; i < world.ships.size(); i++) {
+        renderShip(renderer, world, i, settings);
+    }
+    for (size_t i = 0; i < world.bullets.size(); i++) {
+        renderBullet(renderer, world, i);
+    }
+    for (size_t i = 0; i < world.lasers.size(); i++) {
+        renderLaserBeam(renderer, world, i);
+    }
+    for (size_t i = 0; i < world.mines.size(); i++) {
+        renderMine(renderer, world, i);
+    }
+    for (size_t i = 0; i < world.powerups.size(); i++) {
+        renderPowerup(renderer, world, i, settings);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <SDL2/SDL.h>
+#include "settings.h"
+#include "sim/world.h"
+
+// Draws the simulation state, the world itself knows nothing about SDL.
+void renderShip(SDL_Renderer* renderer, const World& world, size_t ship, const GameSettings& settings);
+void renderBullet(SDL_Renderer* renderer, const World& world, size_t bullet);
+void renderLaserBeam(SDL_Renderer* renderer, const World& world, size_t laser);
+void renderMine(SDL_Renderer* renderer, const World& world, size_t mine);
+void renderPowerup(SDL_Renderer* renderer, const World& world, size_t powerup, const GameSettings& settings);
+void renderWorld(SDL_Renderer* renderer, const World& world, const GameSettings& settings);
+
+#endif
@@ -0,0 +1,269 @@
+#include "rl/obs_grid.h"
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define GRID_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+// Row kernels: cells [x0, x1) of row get max(cell, value) where the distance
+// from the cell center to the shape is within reach. Cell x has its center at
+// x + 0.5, distances are in cells.
+
+static void circleRowScalar(float* row, int x0, int x1, float cx, float dy2, float reachSq, float value) {
+    for (int x = x0; x < x1; x++) {
+        float dx = x + 0.5f - cx;
+        if (dx * dx + dy2 <= reachSq) {
+            row[x] = std::max(row[x], value);
+        }
+    }
+}
+
+// distance to the segment from a along ab, py is the center of the row
+static void segmentRowScalar(float* row, int x0, int x1, float py, Vector2 a, Vector2 ab, float invLengthSq, float reachSq,
+                             float value) {
+    float wy = py - a.y;
+    for (int x = x0; x < x1; x++) {
+        float wx = x + 0.5f - a.x;
+        float t = std::clamp((wx * ab.x + wy * ab.y) * invLengthSq, 0.0f, 1.0f);
+        float ex = wx - t * ab.x;
+        float ey = wy - t * ab.y;
+        if (ex * ex + ey * ey <= reachSq) {
+            row[x] = std::max(row[x], value);
+        }
+    }
+}
+
+#ifdef GRID_X86_DISPATCH
+
+__attribute__((target("sse2")))
+static void circleRowSSE2(float* row, int x0, int x1, float cx, float dy2, float reachSq, float value) {
+    const __m128 step = _mm_set1_ps(4.0f);
+    const __m128 d2 = _mm_set1_ps(dy2);
+    const __m128 r = _mm_set1_ps(reachSq);
+    const __m128 v = _mm_set1_ps(value);
+    __m128 dx = _mm_add_ps(_mm_set1_ps(x0 + 0.5f - cx), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    int x = x0;
+    for (; x + 4 <= x1; x += 4, dx = _mm_add_ps(dx, step)) {
+        __m128 inside = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(dx, dx), d2), r);
+        __m128 cells = _mm_loadu_ps(row + x);
+        _mm_storeu_ps(row + x, _mm_max_ps(cells, _mm_and_ps(inside, v)));
+    }
+    circleRowScalar(row, x, x1, cx, dy2, reachSq, value);
+}
+
+__attribute__((target("sse2")))
+static void segmentRowSSE2(float* row, int x0, int x1, float py, Vector2 a, Vector2 ab, float invLengthSq, float reachSq,
+                           float value) {
+    const __m128 step = _mm_set1_ps(4.0f);
+    const __m128 abx = _mm_set1_ps(ab.x);
+    const __m128 aby = _mm_set1_ps(ab.y);
+    const __m128 wy = _mm_set1_ps(py - a.y);
+    const __m128 wyAby = _mm_mul_ps(wy, aby);
+    const __m128 inv = _mm_set1_ps(invLengthSq);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 r = _mm_set1_ps(reachSq);
+    const __m128 v = _mm_set1_ps(value);
+    __m128 wx = _mm_add_ps(_mm_set1_ps(x0 + 0.5f - a.x), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    int x = x0;
+    for (; x + 4 <= x1; x += 4, wx = _mm_add_ps(wx, step)) {
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(wx, abx), wyAby), inv);
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+        __m128 ex = _mm_sub_ps(wx, _mm_mul_ps(t, abx));
+        __m128 ey = _mm_sub_ps(wy, _mm_mul_ps(t, aby));
+        __m128 inside = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)), r);
+        __m128 cells = _mm_loadu_ps(row + x);
+        _mm_storeu_ps(row + x, _mm_max_ps(cells, _mm_and_ps(inside, v)));
+    }
+    segmentRowScalar(row, x, x1, py, a, ab, invLengthSq, reachSq, value);
+}
+
+__attribute__((target("avx2")))
+static void circleRowAVX2(float* row, int x0, int x1, float cx, float dy2, float reachSq, float value) {
+    const __m256 step = _mm256_set1_ps(8.0f);
+    const __m256 d2 = _mm256_set1_ps(dy2);
+    const __m256 r = _mm256_set1_ps(reachSq);
+    const __m256 v = _mm256_set1_ps(value);
+    __m256 dx = _mm256_add_ps(_mm256_set1_ps(x0 + 0.5f - cx), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+    int x = x0;
+    for (; x + 8 <= x1; x += 8, dx = _mm256_add_ps(dx, step)) {
+        __m256 inside = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), d2), r, _CMP_LE_OQ);
+        __m256 cells = _mm256_loadu_ps(row + x);
+        _mm256_storeu_ps(row + x, _mm256_max_ps(cells, _mm256_and_ps(inside, v)));
+    }
+    circleRowSSE2(row, x, x1, cx, dy2, reachSq, value);
+}
+
+__attribute__((target("avx2")))
+static void segmentRowAVX2(float* row, int x0, int x1, float py, Vector2 a, Vector2 ab, float invLengthSq, float reachSq,
+                           float value) {
+    const __m256 step = _mm256_set1_ps(8.0f);
+    const __m256 abx = _mm256_set1_ps(ab.x);
+    const __m256 aby = _mm256_set1_ps(ab.y);
+    const __m256 wy = _mm256_set1_ps(py - a.y);
+    const __m256 wyAby = _mm256_mul_ps(wy, aby);
+    const __m256 inv = _mm256_set1_ps(invLengthSq);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 r = _mm256_set1_ps(reachSq);
+    const __m256 v = _mm256_set1_ps(value);
+    __m256 wx = _mm256_add_ps(_mm256_set1_ps(x0 + 0.5f - a.x), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+    int x = x0;
+    for (; x + 8 <= x1; x += 8, wx = _mm256_add_ps(wx, step)) {
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(wx, abx), wyAby), inv);
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+        __m256 ex = _mm256_sub_ps(wx, _mm256_mul_ps(t, abx));
+        __m256 ey = _mm256_sub_ps(wy, _mm256_mul_ps(t, aby));
+        __m256 inside = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey)), r, _CMP_LE_OQ);
+        __m256 cells = _mm256_loadu_ps(row + x);
+        _mm256_storeu_ps(row + x, _mm256_max_ps(cells, _mm256_and_ps(inside, v)));
+    }
+    segmentRowSSE2(row, x, x1, py, a, ab, invLengthSq, reachSq, value);
+}
+
+#endif
+
+struct GridKernels {
+    void (*circleRow)(float*, int, int, float, float, float, float);
+    void (*segmentRow)(float*, int, int, float, Vector2, Vector2, float, float, float);
+};
+
+static GridKernels selectGridKernels() {
+#ifdef GRID_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {circleRowAVX2, segmentRowAVX2};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {circleRowSSE2, segmentRowSSE2};
+    }
+#endif
+    return {circleRowScalar, segmentRowScalar};
+}
+
+static const GridKernels& gridKernels() {
+    static const GridKernels kernels = selectGridKernels();
+    return kernels;
+}
+
+namespace {
+
+// one channel of one grid, shapes in arena pixels
+class GridCanvas {
+public:
+    GridCanvas(const GridConfig& config, Vector2 center, Vector2 heading)
+        : n(config.resolution), scale(config.resolution / config.viewSize), center(center), heading(heading),
+          kernels(gridKernels()) {}
+
+    void circle(float* channel, Vector2 pos, float radius, float value) const {
+        Vector2 g = toGrid(pos);
+        float reach = radius * scale + 0.5f;
+        int y0, y1, x0, x1;
+        if (!bounds(g.x - reach, g.x + reach, x0, x1) || !bounds(g.y - reach, g.y + reach, y0, y1)) {
+            return;
+        }
+        for (int y = y0; y < y1; y++) {
+            float dy = y + 0.5f - g.y;
+            kernels.circleRow(channel + y * n, x0, x1, g.x, dy * dy, reach * reach, value);
+        }
+    }
+
+    void segment(float* channel, Vector2 from, Vector2 to, float halfWidth, float value) const {
+        Vector2 a = toGrid(from);
+        Vector2 b = toGrid(to);
+        Vector2 ab(b.x - a.x, b.y - a.y);
+        float lengthSq = ab.x * ab.x + ab.y * ab.y;
+        float reach = halfWidth * scale + 0.5f;
+        int y0, y1, x0, x1;
+        if (!bounds(std::min(a.x, b.x) - reach, std::max(a.x, b.x) + reach, x0, x1)
+            || !bounds(std::min(a.y, b.y) - reach, std::max(a.y, b.y) + reach, y0, y1)) {
+            return;
+        }
+        float invLengthSq = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+        for (int y = y0; y < y1; y++) {
+            kernels.segmentRow(channel + y * n, x0, x1, y + 0.5f, a, ab, invLengthSq, reach * reach, value);
+        }
+    }
+
+private:
+    int n;
+    float scale; // cells per pixel
+    Vector2 center, heading;
+    const GridKernels& kernels;
+
+    Vector2 toGrid(Vector2 pos) const {
+        float dx = pos.x - center.x;
+        float dy = pos.y - center.y;
+        return Vector2((dx * heading.x + dy * heading.y) * scale + n / 2.0f, (dy * heading.x - dx * heading.y) * scale + n / 2.0f);
+    }
+
+    // cells whose centers can be in [lo, hi], false if none of the grid
+    bool bounds(float lo, float hi, int& first, int& end) const {
+        first = std::max(0, (int)std::ceil(lo - 0.5f));
+        end = std::min(n, (int)std::floor(hi - 0.5f) + 1);
+        return first < end;
+    }
+};
+
+}
+
+void renderGrid(const World& world, int owner, const GridConfig& config, float* out) {
+    const size_t cells = (size_t)config.resolution * config.resolution;
+    std::fill(out, out + NUM_GRID_CHANNELS * cells, 0.0f);
+    const SimConfig& cfg = world.config;
+    int active = world.activeIndex(owner);
+    Vector2 center = active >= 0 ? world.ships.transform[active].pos : Vector2(cfg.w / 2.0f, cfg.h / 2.0f);
+    Vector2 heading = config.rotate && active >= 0 ? direction(world.ships.transform[active].angle) : Vector2(1.0f, 0.0f);
+    GridCanvas canvas(config, center, heading);
+    auto channel = [&](GridChannel c) { return out + c * cells; };
+
+    const ShipTable& ships = world.ships;
+    for (size_t i = 0; i < ships.size(); i++) {
+        int other = ships.owner[i];
+        GridChannel c = other == owner ? GRID_OWN_SHIPS : (world.relation(owner, other) & RELATION_HIT) ? GRID_FOE_SHIPS : GRID_ALLY_SHIPS;
+        canvas.circle(channel(c), ships.transform[i].pos, cfg.shipRadius, 1.0f);
+    }
+    const BulletTable& bullets = world.bullets;
+    for (size_t i = 0; i < bullets.size(); i++) {
+        if (world.relation(bullets.owner[i], owner) & RELATION_HIT) {
+            canvas.circle(channel(GRID_BULLETS), bullets.pos[i], cfg.bulletRadius, 1.0f);
+        }
+    }
+    const MineTable& mines = world.mines;
+    for (size_t i = 0; i < mines.size(); i++) {
+        if (!(world.relation(mines.owner[i], owner) & RELATION_HIT) || mines.phase[i] == MinePhase::SPENT) {
+            continue;
+        }
+        // armed and activated mines by the reach of their trigger
+        switch (mines.phase[i]) {
+            case MinePhase::ARMED:
+                canvas.circle(channel(GRID_MINES), mines.pos[i], cfg.mineActiveRadius, 1.0f / 3.0f);
+                break;
+            case MinePhase::ACTIVATED:
+                canvas.circle(channel(GRID_MINES), mines.pos[i], cfg.mineActiveRadius, 2.0f / 3.0f);
+                break;
+            default:
+                canvas.circle(channel(GRID_MINES), mines.pos[i], cfg.mineExplosionRadius, 1.0f);
+                break;
+        }
+    }
+    // like renderLaserBeam: from the ship to the border, then the reflection to the next border
+    const LaserTable& lasers = world.lasers;
+    for (size_t i = 0; i < lasers.size(); i++) {
+        if (!(world.relation(lasers.owner[i], owner) & RELATION_HIT)) {
+            continue;
+        }
+        float angle = lasers.angle[i];
+        RayIntersection hit = getRayIntersectionBorder(lasers.pos[i], angle, cfg.w, cfg.h);
+        float reflectAngle = hit.side == BorderSide::LEFT || hit.side == BorderSide::RIGHT ? 180 - angle : -angle;
+        RayIntersection reflected = getRayIntersectionBorder(hit.intersectionPoint, reflectAngle, cfg.w, cfg.h);
+        canvas.segment(channel(GRID_LASERS), lasers.pos[i], hit.intersectionPoint, cfg.laserBeamWidth / 2, 1.0f);
+        canvas.segment(channel(GRID_LASERS), hit.intersectionPoint, reflected.intersectionPoint, cfg.laserBeamWidth / 2, 1.0f);
+    }
+    const PowerupTable& powerups = world.powerups;
+    for (size_t i = 0; i < powerups.size(); i++) {
+        canvas.circle(channel(GRID_POWERUPS), powerups.pos[i], powerups.radius[i], 1.0f);
+    }
+}
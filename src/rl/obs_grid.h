@@ -0,0 +1,37 @@
+#ifndef RL_OBS_GRID_H
+#define RL_OBS_GRID_H
+
+#include <cstddef>
+#include "sim/world.h"
+
+// Channels of an observation grid, what one owner sees of the arena
+enum GridChannel {
+    GRID_OWN_SHIPS,
+    GRID_ALLY_SHIPS,
+    GRID_FOE_SHIPS,
+    GRID_BULLETS,  // of foes
+    GRID_MINES,    // of foes over their trigger radius, 1/3 armed, 2/3 activated, 1 over the blast while exploding
+    GRID_LASERS,   // beams of foes, up to their reflection off the border
+    GRID_POWERUPS,
+    NUM_GRID_CHANNELS
+};
+
+struct GridConfig {
+    int resolution; // cells along each side, 0 for no grids
+    float viewSize; // pixels across the grid
+    bool rotate;    // the heading of the active spaceship points along +x
+};
+
+// floats of one grid
+constexpr size_t gridSize(const GridConfig& config) {
+    return (size_t)NUM_GRID_CHANNELS * config.resolution * config.resolution;
+}
+
+// Renders the view of owner into out[channel][y][x], centered on its active
+// spaceship, or on the arena without one. A cell is 1 (or the mine phase)
+// where its center is within half a cell of an entity's shape, 0 elsewhere,
+// so entities smaller than a cell still cover the cell they are in.
+// The rows are filled by SIMD kernels picked for the CPU at runtime.
+void renderGrid(const World& world, int owner, const GridConfig& config, float* out);
+
+#endif
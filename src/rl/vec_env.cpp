@@ -0,0 +1,247 @@
+#include "rl/vec_env.h"
+#include <algorithm>
+#include <cmath>
+
+// buttons of every RlAction, like the Agent methods set them
+static const uint8_t ACTION_BUTTONS[NUM_ACTIONS] = {
+    0, INPUT_ROTATE, INPUT_BOOST, INPUT_SHOOT, INPUT_SPLIT, INPUT_SWITCH
+};
+
+// envs stepped by one job, enough to outweigh the cost of queueing it
+const size_t ENVS_PER_JOB = 8;
+
+// the K rows nearest to a point, nearest first
+template <int K>
+struct Nearest {
+    // only the first count are meaningful, the rest are zeroed so the compiler can see it
+    float distanceSq[K] = {};
+    uint32_t row[K] = {};
+    int count = 0;
+
+    void offer(float d, uint32_t r) {
+        if (count == K && d >= distanceSq[K - 1]) {
+            return;
+        }
+        int i = count < K ? count++ : K - 1;
+        for (; i > 0 && distanceSq[i - 1] > d; i--) {
+            distanceSq[i] = distanceSq[i - 1];
+            row[i] = row[i - 1];
+        }
+        distanceSq[i] = d;
+        row[i] = r;
+    }
+};
+
+VecEnv::VecEnv(const VecEnvConfig& config)
+    : config(config), jobs(std::max(config.numThreads, 1) - 1), observations(nullptr), grids(nullptr), rewards(nullptr),
+      dones(nullptr), totalSteps(0) {
+    int teams = config.numTeams > 0 ? config.numTeams : config.numPlayers;
+    for (int owner = 0; owner < config.numPlayers; owner++) {
+        team.push_back(owner * teams / config.numPlayers);
+    }
+    envs.reserve(config.numEnvs);
+    for (int i = 0; i < config.numEnvs; i++) {
+        envs.push_back({World(config.sim, config.numPlayers, 0), 0, (uint32_t)config.sim.ticks(config.maxSeconds),
+                        std::vector<int>(config.numPlayers), -1});
+    }
+}
+
+void VecEnv::bind(float* observations, float* rewards, uint8_t* dones) {
+    this->observations = observations;
+    this->rewards = rewards;
+    this->dones = dones;
+}
+
+void VecEnv::bindGrids(float* grids) {
+    this->grids = grids;
+}
+
+void VecEnv::start(Env& env, uint64_t seed) {
+    env.world = World(config.sim, config.numPlayers, seed);
+    env.world.setTeams(team);
+    for (int owner = 0; owner < config.numPlayers; owner++) {
+        env.world.spawnPlayer(owner);
+        env.value[owner] = config.sim.numStartSpaceships;
+    }
+    env.nextSeed = seed + config.numEnvs;
+}
+
+void VecEnv::reset(const uint64_t* seeds) {
+    parallelFor(&jobs, envs.size(), ENVS_PER_JOB, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            start(envs[i], seeds[i]);
+            envs[i].winner = -1;
+            std::fill(rewards + i * config.numPlayers, rewards + (i + 1) * config.numPlayers, 0.0f);
+            dones[i] = DONE_NONE;
+            observe(i);
+        }
+    });
+}
+
+void VecEnv::step(const uint8_t* actions) {
+    parallelFor(&jobs, envs.size(), ENVS_PER_JOB, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            stepEnv(i, actions + i * config.numPlayers);
+        }
+    });
+    totalSteps++;
+}
+
+void VecEnv::stepEnv(int index, const uint8_t* actions) {
+    Env& env = envs[index];
+    World& world = env.world;
+    const int players = config.numPlayers;
+    for (int owner = 0; owner < players; owner++) {
+        world.applyInput(owner, actions[owner] < NUM_ACTIONS ? ACTION_BUTTONS[actions[owner]] : 0);
+    }
+    world.step();
+    world.events.clear();
+
+    // value gained by every owner since the last step
+    int value[RL_MAX_PLAYERS] = {};
+    for (size_t i = 0; i < world.ships.size(); i++) {
+        value[world.ships.owner[i]] += world.ships.value[i];
+    }
+    float* reward = rewards + index * players;
+    const float scale = 1.0f / config.sim.numStartSpaceships;
+    for (int owner = 0; owner < players; owner++) {
+        float foesGained = 0.0f;
+        int foes = 0;
+        for (int other = 0; other < players; other++) {
+            if (world.relation(owner, other) & RELATION_HIT) {
+                foesGained += value[other] - env.value[other];
+                foes++;
+            }
+        }
+        reward[owner] = (value[owner] - env.value[owner] - (foes > 0 ? foesGained / foes : 0.0f)) * scale;
+    }
+    std::copy(value, value + players, env.value.begin());
+
+    int survivor;
+    int alive = world.teamsAlive(survivor);
+    dones[index] = alive <= 1 ? DONE_TERMINATED : world.tick >= env.maxTicks ? DONE_TRUNCATED : DONE_NONE;
+    if (alive == 1) {
+        for (int owner = 0; owner < players; owner++) {
+            reward[owner] += team[owner] == survivor ? WIN_REWARD : -WIN_REWARD;
+        }
+    }
+    if (dones[index] != DONE_NONE) {
+        env.winner = alive == 1 ? survivor : -1;
+        start(env, env.nextSeed);
+    }
+    observe(index);
+}
+
+void VecEnv::observe(int index) {
+    const World& world = envs[index].world;
+    const SimConfig& sim = world.config;
+    const float invW = 1.0f / sim.w;
+    const float invH = 1.0f / sim.h;
+    const float valueScale = 1.0f / sim.numStartSpaceships;
+    const float episodeFraction = (float)world.tick / envs[index].maxTicks;
+    const ShipTable& ships = world.ships;
+
+    for (int owner = 0; owner < config.numPlayers; owner++) {
+        float* obs = observations + ((size_t)index * config.numPlayers + owner) * OBSERVATION_SIZE;
+        std::fill(obs, obs + OBSERVATION_SIZE, 0.0f);
+        int active = world.activeIndex(owner);
+        Vector2 center = active >= 0 ? ships.transform[active].pos : Vector2(sim.w / 2.0f, sim.h / 2.0f);
+        auto put = [&](float*& out, Vector2 pos) {
+            *out++ = 1.0f;
+            *out++ = (pos.x - center.x) * invW;
+            *out++ = (pos.y - center.y) * invH;
+        };
+
+        Nearest<OBS_SHIPS> foeShips;
+        Nearest<OBS_OWN_SHIPS> ownShips;
+        int totalValue = 0;
+        for (size_t i = 0; i < ships.size(); i++) {
+            float d = ships.transform[i].pos.distanceSquared(center);
+            if (ships.owner[i] == owner) {
+                totalValue += ships.value[i];
+                if ((int)i != active) {
+                    ownShips.offer(d, i);
+                }
+            } else if (world.relation(owner, ships.owner[i]) & RELATION_HIT) {
+                foeShips.offer(d, i);
+            }
+        }
+        Nearest<OBS_BULLETS> bullets;
+        for (size_t i = 0; i < world.bullets.size(); i++) {
+            if (world.relation(world.bullets.owner[i], owner) & RELATION_HIT) {
+                bullets.offer(world.bullets.pos[i].distanceSquared(center), i);
+            }
+        }
+        Nearest<OBS_MINES> mines;
+        for (size_t i = 0; i < world.mines.size(); i++) {
+            if (world.relation(world.mines.owner[i], owner) & RELATION_HIT) {
+                mines.offer(world.mines.pos[i].distanceSquared(center), i);
+            }
+        }
+        Nearest<1> powerup;
+        for (size_t i = 0; i < world.powerups.size(); i++) {
+            powerup.offer(world.powerups.pos[i].distanceSquared(center), i);
+        }
+
+        float* out = obs;
+        if (active >= 0) {
+            float angle = deg2rad(ships.transform[active].angle);
+            const WeaponState& weapon = ships.weapon[active];
+            out[0] = 1.0f;
+            out[1] = center.x * invW;
+            out[2] = center.y * invH;
+            out[3] = std::cos(angle);
+            out[4] = std::sin(angle);
+            out[5] = ships.velocity[active].speed / sim.forceBoost;
+            out[6] = ships.value[active] * valueScale;
+            out[8] = weapon.maxAmmo > 0 ? (float)weapon.ammo / weapon.maxAmmo : 0.0f;
+            out[9] = (float)weapon.type;
+        }
+        out[7] = totalValue * valueScale;
+        out += OBS_SELF_SIZE;
+
+        for (int k = 0; k < OBS_SHIPS; k++, out += 6) {
+            if (k < foeShips.count) {
+                uint32_t i = foeShips.row[k];
+                float* slot = out;
+                put(slot, ships.transform[i].pos);
+                float angle = deg2rad(ships.transform[i].angle);
+                slot[0] = std::cos(angle);
+                slot[1] = std::sin(angle);
+                slot[2] = ships.value[i] * valueScale;
+            }
+        }
+        for (int k = 0; k < OBS_OWN_SHIPS; k++, out += 3) {
+            if (k < ownShips.count) {
+                float* slot = out;
+                put(slot, ships.transform[ownShips.row[k]].pos);
+            }
+        }
+        for (int k = 0; k < OBS_BULLETS; k++, out += 5) {
+            if (k < bullets.count) {
+                uint32_t i = bullets.row[k];
+                float* slot = out;
+                put(slot, world.bullets.pos[i]);
+                float angle = deg2rad(world.bullets.angle[i]);
+                slot[0] = std::cos(angle);
+                slot[1] = std::sin(angle);
+            }
+        }
+        for (int k = 0; k < OBS_MINES; k++, out += 3) {
+            if (k < mines.count) {
+                float* slot = out;
+                put(slot, world.mines.pos[mines.row[k]]);
+            }
+        }
+        if (powerup.count > 0) {
+            float* slot = out;
+            put(slot, world.powerups.pos[powerup.row[0]]);
+        }
+        out += 3;
+        *out = episodeFraction;
+
+        if (config.grid.resolution > 0) {
+            renderGrid(world, owner, config.grid, grids + ((size_t)index * config.numPlayers + owner) * gridSize(config.grid));
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef RL_VEC_ENV_H
+#define RL_VEC_ENV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "sim/world.h"
+#include "sim/job_system.h"
+#include "rl/obs_grid.h"
+
+// Discrete actions of an agent for one tick, the actions of Agent
+enum RlAction : uint8_t {
+    ACTION_NONE,
+    ACTION_ROTATE,
+    ACTION_ROTATE_AND_BOOST,
+    ACTION_SHOOT,
+    ACTION_SPLIT,
+    ACTION_SWITCH,
+    NUM_ACTIONS
+};
+
+// Observation of one agent, floats relative to its active spaceship (the
+// arena center without one), distances in arena widths and heights:
+//   self       has ship, x, y, cos, sin, speed, active value, total value, ammo, weapon
+//   foe ships  OBS_SHIPS nearest, each present, dx, dy, cos, sin, value
+//   own ships  OBS_OWN_SHIPS nearest besides the active one, each present, dx, dy
+//   projectiles OBS_BULLETS nearest foe bullets, each present, dx, dy, cos, sin of their heading
+//   mines      OBS_MINES nearest foe mines, each present, dx, dy
+//   powerup    the nearest, present, dx, dy
+//   time       fraction of the episode played
+// Values are in units of numStartSpaceships, slots without an entity are zero.
+constexpr int OBS_SHIPS = 4;
+constexpr int OBS_OWN_SHIPS = 2;
+constexpr int OBS_BULLETS = 8;
+constexpr int OBS_MINES = 2;
+constexpr int OBS_SELF_SIZE = 10;
+constexpr int OBSERVATION_SIZE = OBS_SELF_SIZE + 6 * OBS_SHIPS + 3 * OBS_OWN_SHIPS + 5 * OBS_BULLETS + 3 * OBS_MINES + 3 + 1;
+
+// Episode end in the dones buffer
+enum RlDone : uint8_t {
+    DONE_NONE,
+    DONE_TERMINATED, // one team is left, or none
+    DONE_TRUNCATED   // cut at maxSeconds
+};
+
+constexpr int RL_MAX_PLAYERS = 16;
+
+struct VecEnvConfig {
+    SimConfig sim;
+    int numEnvs;
+    int numPlayers;   // per world, up to RL_MAX_PLAYERS, every owner is an agent of the caller
+    int numTeams;     // neighbouring owners play together, 0 for every owner on its own
+    float maxSeconds; // of an episode
+    int numThreads;   // including the calling one
+    GridConfig grid;  // observation grids besides the vectors, resolution 0 for none
+};
+
+// Batch of headless matches stepped in lockstep.
+// Agent a = env * numPlayers + owner reads its observation at
+// observations[a * OBSERVATION_SIZE] and its reward at rewards[a], env its
+// end at dones[env]. The buffers belong to the caller and are written in
+// place by reset and step, nothing is copied out afterwards. With
+// config.grid, the agent's observation grid (renderGrid) is at
+// grids[a * gridSize(config.grid)] as well.
+//
+// Rewards are the value an agent's spaceships gained minus the average its
+// foes gained since the last step, in units of numStartSpaceships, plus
+// WIN_REWARD for the team left at the end and minus it for the others.
+// An env that ended is reset right away with its next seed, env + numEnvs
+// past the last one, and the observations of that step are the first of the
+// new episode. The worlds are spread over numThreads, every result depends
+// only on the seeds and actions.
+class VecEnv {
+public:
+    static constexpr float WIN_REWARD = 1.0f;
+
+    explicit VecEnv(const VecEnvConfig& config);
+
+    int numEnvs() const { return config.numEnvs; }
+    int numAgents() const { return config.numEnvs * config.numPlayers; }
+
+    // numAgents() * OBSERVATION_SIZE floats, numAgents() rewards, numEnvs() dones
+    void bind(float* observations, float* rewards, uint8_t* dones);
+    // numAgents() * gridSize(config.grid) floats, needed with a grid resolution
+    void bindGrids(float* grids);
+    // starts env i with seeds[i] and writes the first observations
+    void reset(const uint64_t* seeds);
+    // applies numAgents() RlActions for one tick
+    void step(const uint8_t* actions);
+
+    const World& world(int env) const { return envs[env].world; }
+    // team left when env last ended, -1 if none was or it has not ended yet
+    int winner(int env) const { return envs[env].winner; }
+    uint64_t steps() const { return totalSteps; } // of one env each
+
+private:
+    struct Env {
+        World world;
+        uint64_t nextSeed;
+        uint32_t maxTicks;
+        std::vector<int> value; // per owner at the last step
+        int winner;
+    };
+
+    VecEnvConfig config;
+    std::vector<int> team;
+    JobSystem jobs;
+    std::vector<Env> envs;
+    float* observations;
+    float* grids;
+    float* rewards;
+    uint8_t* dones;
+    uint64_t totalSteps;
+
+    void start(Env& env, uint64_t seed);
+    void stepEnv(int index, const uint8_t* actions);
+    void observe(int index);
+};
+
+#endif
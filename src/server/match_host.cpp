@@ -0,0 +1,158 @@
+#include "server/match_host.h"
+#include <algorithm>
+#include <thread>
+
+// load and lateness are measured over windows of this length
+const double WINDOW_SECONDS = 0.25;
+
+static uint64_t nanos(MatchHost::Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+MatchHost::Match::Match(int id, const SimConfig& config, int numPlayers, uint64_t seed, InputSource inputs)
+    : id(id), world(config, numPlayers, seed), inputs(std::move(inputs)), buttons(numPlayers, 0)
+{
+    for (int owner = 0; owner < numPlayers; owner++) {
+        world.spawnPlayer(owner);
+    }
+}
+
+MatchHost::MatchHost(int numWorkers, HostLimits limits)
+    : jobs(numWorkers), limits(limits), windowStart(Clock::now()), windowBusyStart(0), recentLoad(0.0f), recentLateness(0.0f), refused(0), nextMatchId(0)
+{}
+
+MatchHost::~MatchHost() {
+    draining = true;
+    jobs.wait(ticksInFlight);
+}
+
+int MatchHost::activeMatches() const {
+    int active = 0;
+    for (const auto& match : matches) {
+        active += !match->finished;
+    }
+    return active;
+}
+
+int MatchHost::addMatch(const SimConfig& config, int numPlayers, uint64_t seed, InputSource inputs) {
+    if (activeMatches() >= limits.maxMatches || recentLoad > limits.maxLoad || recentLateness > limits.maxLateness) {
+        refused++;
+        return -1;
+    }
+    int id = nextMatchId++;
+    matches.push_back(std::make_unique<Match>(id, config, numPlayers, seed, std::move(inputs)));
+    matches.back()->nextTickAt = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(config.tickDuration));
+    return id;
+}
+
+void MatchHost::release(Match& match) {
+    match.inFlight.store(true);
+    jobs.submit(ticksInFlight, [this, &match]() { tick(match); }, nanos(match.nextTickAt));
+}
+
+void MatchHost::tick(Match& match) {
+    World& world = match.world;
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(world.config.tickDuration));
+    Clock::time_point start = Clock::now();
+    double late = std::max(std::chrono::duration<double>(start - match.nextTickAt).count(), 0.0);
+    match.latenessSum += late;
+    match.latenessMax = std::max(match.latenessMax, late);
+    match.lateTicks += late > world.config.tickDuration;
+    uint64_t lateness = late / world.config.tickDuration * 1000.0;
+    uint64_t worst = windowLateness.load();
+    while (lateness > worst && !windowLateness.compare_exchange_weak(worst, lateness)) {}
+
+    match.inputs(world, match.buttons.data());
+    for (int owner = 0; owner < world.numPlayers(); owner++) {
+        world.applyInput(owner, match.buttons[owner]);
+    }
+    world.step();
+    world.events.clear();
+    match.ticks++;
+    match.nextTickAt += tickDuration;
+    match.finished = !world.allPlayersAlive();
+
+    Clock::time_point end = Clock::now();
+    busyNanos.fetch_add(nanos(end) - nanos(start));
+    // catch up right away on this worker when the next tick is already due
+    if (!match.finished && !draining.load() && match.nextTickAt <= end) {
+        jobs.submit(ticksInFlight, [this, &match]() { tick(match); }, nanos(match.nextTickAt));
+        return;
+    }
+    match.inFlight.store(false, std::memory_order_release);
+}
+
+void MatchHost::updateWindow(Clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - windowStart).count();
+    if (elapsed < WINDOW_SECONDS) {
+        return;
+    }
+    uint64_t busy = busyNanos.load();
+    recentLoad = (busy - windowBusyStart) * 1e-9 / (elapsed * std::max(jobs.numWorkers(), 1));
+    recentLateness = windowLateness.exchange(0) / 1000.0f;
+    windowBusyStart = busy;
+    windowStart = now;
+}
+
+void MatchHost::run(double seconds) {
+    const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    const Clock::duration maxSleep = std::chrono::milliseconds(1);
+    draining = false;
+    while (true) {
+        Clock::time_point now = Clock::now();
+        if (now >= end) {
+            break;
+        }
+        Clock::time_point wakeAt = std::min(end, now + maxSleep);
+        dropFinished();
+        for (const auto& match : matches) {
+            // finished is written by the tick in flight, only read it once that is over
+            if (match->inFlight.load(std::memory_order_acquire) || match->finished) {
+                continue;
+            }
+            if (match->nextTickAt <= now) {
+                release(*match);
+            } else {
+                wakeAt = std::min(wakeAt, match->nextTickAt);
+            }
+        }
+        updateWindow(now);
+        std::this_thread::sleep_until(wakeAt);
+    }
+    draining = true;
+    jobs.wait(ticksInFlight);
+    dropFinished();
+}
+
+void MatchHost::dropFinished() {
+    // the order of the matches does not matter, the job deadlines decide which tick runs first
+    for (size_t i = 0; i < matches.size();) {
+        // finished is written by the tick in flight, only read it once that is over
+        if (matches[i]->inFlight.load(std::memory_order_acquire) || !matches[i]->finished) {
+            i++;
+            continue;
+        }
+        finishedReports.push_back(reportOf(*matches[i]));
+        matches[i] = std::move(matches.back());
+        matches.pop_back();
+    }
+}
+
+MatchReport MatchHost::reportOf(const Match& match) const {
+    return {match.id, match.ticks, match.finished, match.ticks > 0 ? match.latenessSum / match.ticks : 0.0, match.latenessMax,
+            match.lateTicks};
+}
+
+std::vector<MatchReport> MatchHost::report() const {
+    std::vector<MatchReport> reports;
+    for (const auto& match : matches) {
+        reports.push_back(reportOf(*match));
+    }
+    return reports;
+}
+
+std::vector<MatchReport> MatchHost::takeFinished() {
+    std::vector<MatchReport> reports;
+    reports.swap(finishedReports);
+    return reports;
+}
@@ -0,0 +1,106 @@
+#ifndef SERVER_MATCH_HOST_H
+#define SERVER_MATCH_HOST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "sim/world.h"
+#include "sim/job_system.h"
+
+// Fills in the buttons of every player for the next tick of a match.
+// Called on a worker thread, never concurrently for the same match.
+using InputSource = std::function<void(const World& world, uint8_t* buttons)>;
+
+struct HostLimits {
+    int maxMatches;    // matches running at once
+    float maxLoad;     // busy fraction of the workers above which new matches are refused
+    float maxLateness; // in ticks, refuses new matches while recent ticks started this late
+};
+
+struct MatchReport {
+    int id;
+    uint32_t ticks;
+    bool finished;      // a player has no spaceship left
+    double meanLateness; // seconds between a tick's scheduled start and its actual start
+    double maxLateness;
+    uint32_t lateTicks; // ticks that started more than one tick duration late
+};
+
+// Runs many matches in one process.
+// Every match ticks at its own fixed rate. The host thread releases each due
+// tick as a job on a work-stealing JobSystem with the tick's scheduled time as
+// deadline, so the most overdue tick anywhere runs first. A match that fell
+// behind by several ticks is caught up by its worker back to back. The ticks of
+// one match never overlap, every match runs on one thread at a time.
+//
+// New matches are admitted while the host is under all of its limits: match
+// count, worker load and tick lateness over the last measurement window.
+// A finished match is dropped by the next pass of run over the matches, only
+// its report is kept until takeFinished, so a long-running host holds no more
+// matches than it runs.
+class MatchHost {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    MatchHost(int numWorkers, HostLimits limits);
+    ~MatchHost();
+
+    // the id of the new match, -1 if the host is at one of its limits
+    int addMatch(const SimConfig& config, int numPlayers, uint64_t seed, InputSource inputs);
+    // runs the scheduler on the calling thread, returns once the ticks in flight are done
+    void run(double seconds);
+
+    int activeMatches() const;
+    int hostedMatches() const { return matches.size(); } // running and finished but not dropped yet
+    float load() const { return recentLoad; }             // busy fraction of the workers
+    float lateness() const { return recentLateness; }     // worst tick lateness in ticks
+    int refusedMatches() const { return refused; }
+    // of the matches hosted now
+    std::vector<MatchReport> report() const;
+    // of the matches dropped since the last call
+    std::vector<MatchReport> takeFinished();
+
+private:
+    struct Match {
+        int id;
+        World world;
+        InputSource inputs;
+        std::vector<uint8_t> buttons;
+        Clock::time_point nextTickAt;
+        std::atomic<bool> inFlight{false};
+        bool finished = false;
+        uint32_t ticks = 0;
+        double latenessSum = 0.0, latenessMax = 0.0;
+        uint32_t lateTicks = 0;
+
+        Match(int id, const SimConfig& config, int numPlayers, uint64_t seed, InputSource inputs);
+    };
+
+    JobSystem jobs;
+    JobGroup ticksInFlight;
+    HostLimits limits;
+    std::vector<std::unique_ptr<Match>> matches;
+    std::vector<MatchReport> finishedReports;
+    std::atomic<bool> draining{false};
+
+    // measurement window, updated by the scheduler
+    std::atomic<uint64_t> busyNanos{0};
+    std::atomic<uint64_t> windowLateness{0}; // worst in the current window, in thousandths of a tick
+    Clock::time_point windowStart;
+    uint64_t windowBusyStart;
+    float recentLoad, recentLateness;
+    int refused;
+    int nextMatchId;
+
+    MatchReport reportOf(const Match& match) const;
+    // moves the reports of the finished matches without a tick in flight out and drops them
+    void dropFinished();
+    void release(Match& match);
+    void tick(Match& match);
+    void updateWindow(Clock::time_point now);
+};
+
+#endif
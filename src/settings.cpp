@@ -1,6 +1,8 @@
 #include "settings.h"
+#include "sim/rules.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <algorithm>
 using json = nlohmann::json;
 
 std::shared_ptr<GameSettings> GameSettings::instance = nullptr;
@@ -20,6 +22,7 @@ std::shared_ptr<GameSettings> GameSettings::defaultInstance() {
         .w = 1200,
         .h = 900,
         .fps = 60,
+        .tickRate = 60,
         .backgroundImage = "assets/bg.jpg",
         .laserBeamSound = "assets/laser.mp3",
         .mineSound = "assets/mine.mp3",
@@ -39,6 +42,10 @@ std::shared_ptr<GameSettings> GameSettings::defaultInstance() {
         },
         .numStartSpaceships = 3,
         .doublePressThreshold = 0.2f,
+        .teamMatchPlayers = 8,
+        .teamMatchTeams = 2,
+        .aiThinkMs = 0.0f,
+        .aiFrameMs = 4.0f,
         .powerupSpawnInterval = 2.0f,
         .powerupRadius = 16.0f,
         .spaceshipSize = 32,
@@ -76,6 +83,7 @@ void GameSettings::init(const char* filename) {
         .w = j.value("w", defaultSettings->w),
         .h = j.value("h", defaultSettings->h),
         .fps = j.value("fps", defaultSettings->fps),
+        .tickRate = j.value("tickRate", defaultSettings->tickRate),
         .backgroundImage = j.value("backgroundImage", defaultSettings->backgroundImage),
         .laserBeamSound = j.value("laserBeamSound", defaultSettings->laserBeamSound),
         .mineSound = j.value("mineSound", defaultSettings->mineSound),
@@ -95,6 +103,10 @@ void GameSettings::init(const char* filename) {
         },
         .numStartSpaceships = j.value("numStartSpaceships", defaultSettings->numStartSpaceships),
         .doublePressThreshold = j.value("doublePressThreshold", defaultSettings->doublePressThreshold),
+        .teamMatchPlayers = std::clamp(j.value("teamMatchPlayers", defaultSettings->teamMatchPlayers), 2, 16),
+        .teamMatchTeams = std::clamp(j.value("teamMatchTeams", defaultSettings->teamMatchTeams), 2, 16),
+        .aiThinkMs = std::max(j.value("aiThinkMs", defaultSettings->aiThinkMs), 0.0f),
+        .aiFrameMs = std::max(j.value("aiFrameMs", defaultSettings->aiFrameMs), 0.0f),
         .powerupSpawnInterval = j.value("powerupSpawnInterval", defaultSettings->powerupSpawnInterval),
         .powerupRadius = j.value("powerupRadius", defaultSettings->powerupRadius),
         .spaceshipSize = j.value("spaceshipSize", defaultSettings->spaceshipSize),
@@ -116,6 +128,37 @@ void GameSettings::init(const char* filename) {
     });
 }
 
+SimConfig GameSettings::simConfig() const {
+#ifdef TOURNAMENT_RULES
+    // tournament builds simulate with compile-time rules, config.json only affects the front end
+    return TournamentProfile::config();
+#endif
+    SimConfig config{};
+    config.w = w;
+    config.h = h;
+    config.numStartSpaceships = numStartSpaceships;
+    config.tickRate = tickRate;
+    config.powerupSpawnInterval = powerupSpawnInterval;
+    config.powerupRadius = powerupRadius;
+    config.spaceshipSize = spaceshipSize;
+    config.rotationSpeed = rotationSpeed;
+    config.forceBoost = forceBoost;
+    config.drag = drag;
+    config.rotBoostDeg = rotBoostDeg;
+    config.bulletSpeed = bulletSpeed;
+    config.bulletRadius = bulletRadius;
+    config.bulletLifeTime = bulletLifeTime;
+    config.laserBeamLifeTime = laserBeamLifeTime;
+    config.laserBeamWidth = laserBeamWidth;
+    config.mineActivationDuration = mineActivationDuration;
+    config.mineActiveRadius = mineActiveRadius;
+    config.mineExplosionRadius = mineExplosionRadius;
+    config.mineExplosionDuration = mineExplosionDuration;
+    config.mineSize = mineSize;
+    config.finalize();
+    return config;
+}
+
 GameSettings::~GameSettings() {
     if (sdlSettings != nullptr) {
         delete sdlSettings;
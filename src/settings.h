@@ -7,18 +7,12 @@
 #include <SDL2/SDL_ttf.h>
 #include <memory>
 #include <string>
+#include "sim/config.h"
 
 struct PlayerSettings {
     SDL_Scancode leftBtn, shootBtn, splitBtn, switchBtn;
 };
 
-enum class ProjectileType {
-    BULLET,
-    LASER_BEAM,
-    MINE,
-    PLUS
-};
-
 enum class ForceType {
     Attraction,
     Repulsion
@@ -56,6 +50,7 @@ struct GameSettings {
     std::string title;
     int x, y, w, h;
     int fps;
+    int tickRate; // simulation steps per second, independent of fps
     std::string backgroundImage;
     std::string laserBeamSound, mineSound, bulletSound;
 
@@ -64,6 +59,9 @@ struct GameSettings {
     PlayerSettings playerSettings[2];
     int numStartSpaceships;
     float doublePressThreshold;
+    int teamMatchPlayers, teamMatchTeams; // the Team Match menu entry: owners, split into that many teams
+    float aiThinkMs; // lookahead planning of the AI per decision, 0 for the reactive AI
+    float aiFrameMs; // planning of every AI together per frame
 
     // powerup settings
     float powerupSpawnInterval;
@@ -80,6 +78,7 @@ struct GameSettings {
     SDL_Settings* sdlSettings;
     // WeaponSettings* weaponSettings;
 
+    SimConfig simConfig() const;
     ~GameSettings();
 };
 
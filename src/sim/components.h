@@ -0,0 +1,211 @@
+#ifndef SIM_COMPONENTS_H
+#define SIM_COMPONENTS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math.h"
+#include "sim/config.h"
+
+// Entity-component storage for the simulation.
+// Every entity kind (archetype) owns one table, and every component of that
+// archetype is a contiguous array indexed by the entity's row. Systems walk
+// the arrays linearly instead of chasing shared_ptr graphs.
+// Sizes and durations shared by all entities of an archetype live in SimConfig.
+
+struct Transform {
+    Vector2 pos;
+    float angle; // Rotation angle in degrees
+};
+
+struct Velocity {
+    Vector2 dir;  // Unit direction of travel
+    float speed;  // Magnitude of velocity vector
+};
+
+struct WeaponState {
+    ProjectileType type;
+    float cooldown;   // seconds per reloaded bullet
+    uint32_t reloadAt; // tick of the next reload, 0 while no reload is pending
+    int maxAmmo;
+    int ammo;
+};
+
+enum ShipFlags : uint8_t {
+    SHIP_READY_SAME_SIDE = 1 << 0,     // Used to prevent multiple merges
+    SHIP_READY_OPPOSITE_SIDE = 1 << 1, // Used to prevent multiple collisions
+    SHIP_MERGED = 1 << 2               // Consumed by a merge, removed at the end of the collision pass
+};
+
+enum class MinePhase : uint8_t {
+    ARMED,      // waiting for an enemy to come within activeRadius
+    ACTIVATED,  // counting down to the explosion
+    EXPLODING,
+    SPENT
+};
+
+// Keep the rows whose alive flag is set, preserving their order.
+template <class T>
+void compactColumn(std::vector<T>& column, const std::vector<uint8_t>& alive) {
+    size_t n = 0;
+    for (size_t i = 0; i < column.size(); i++) {
+        if (alive[i]) {
+            column[n++] = column[i];
+        }
+    }
+    column.erase(column.begin() + n, column.end());
+}
+
+// Every table lists its columns in forEachColumn (with a const twin for readers),
+// generic operations (compaction, clearing, hashing) are written against that.
+template <class Table>
+struct TableOps {
+    size_t size() const { return static_cast<const Table*>(this)->id.size(); }
+    bool empty() const { return size() == 0; }
+
+    void compact(const std::vector<uint8_t>& alive) {
+        static_cast<Table*>(this)->forEachColumn([&](auto& column) { compactColumn(column, alive); });
+    }
+
+    void clear() {
+        static_cast<Table*>(this)->forEachColumn([](auto& column) { column.clear(); });
+    }
+
+    // row of the entity with the given id, -1 if it does not exist.
+    // Rows are only ever appended with fresh ids and compaction keeps their
+    // order, so the id column is sorted.
+    int find(int entityId) const {
+        const auto& ids = static_cast<const Table*>(this)->id;
+        auto it = std::lower_bound(ids.begin(), ids.end(), entityId);
+        if (it == ids.end() || *it != entityId) {
+            return -1;
+        }
+        return static_cast<int>(it - ids.begin());
+    }
+};
+
+// Rows of a table that belong to one owner, in table order.
+template <class Table>
+class OwnedRows {
+private:
+    const Table* table;
+    int owner;
+public:
+    class iterator {
+    private:
+        const Table* table;
+        int owner;
+        size_t row;
+        void skip() {
+            while (row < table->size() && table->owner[row] != owner) {
+                row++;
+            }
+        }
+    public:
+        iterator(const Table* table, int owner, size_t row) : table(table), owner(owner), row(row) { skip(); }
+        size_t operator*() const { return row; }
+        iterator& operator++() { row++; skip(); return *this; }
+        bool operator!=(const iterator& other) const { return row != other.row; }
+    };
+
+    OwnedRows(const Table* table, int owner) : table(table), owner(owner) {}
+    iterator begin() const { return iterator(table, owner, 0); }
+    iterator end() const { return iterator(table, owner, table->size()); }
+};
+
+struct ShipTable : TableOps<ShipTable> {
+    std::vector<int> id;
+    std::vector<Transform> transform;
+    std::vector<Vector2> prevPos; // center before the last movement step, swept by the collision tests
+    std::vector<Velocity> velocity;
+    std::vector<int> owner;
+    std::vector<int> value;
+    std::vector<WeaponState> weapon;
+    std::vector<uint8_t> flags;
+
+    template <class F>
+    void forEachColumn(F&& f) {
+        f(id); f(transform); f(prevPos); f(velocity); f(owner); f(value); f(weapon); f(flags);
+    }
+    template <class F>
+    void forEachColumn(F&& f) const {
+        f(id); f(transform); f(prevPos); f(velocity); f(owner); f(value); f(weapon); f(flags);
+    }
+
+    OwnedRows<ShipTable> ownedBy(int player) const { return OwnedRows<ShipTable>(this, player); }
+};
+
+struct BulletTable : TableOps<BulletTable> {
+    std::vector<int> id;
+    std::vector<int> owner;
+    std::vector<Vector2> pos;
+    std::vector<Vector2> prevPos; // position before the last movement step
+    std::vector<float> angle;
+    std::vector<float> speed;
+    std::vector<uint32_t> expiresAt; // tick at which the bullet disappears
+    std::vector<uint8_t> eol;
+
+    template <class F>
+    void forEachColumn(F&& f) {
+        f(id); f(owner); f(pos); f(prevPos); f(angle); f(speed); f(expiresAt); f(eol);
+    }
+    template <class F>
+    void forEachColumn(F&& f) const {
+        f(id); f(owner); f(pos); f(prevPos); f(angle); f(speed); f(expiresAt); f(eol);
+    }
+};
+
+struct LaserTable : TableOps<LaserTable> {
+    std::vector<int> id;
+    std::vector<int> owner;
+    std::vector<Vector2> pos;
+    std::vector<float> angle;
+    std::vector<uint32_t> expiresAt;
+
+    template <class F>
+    void forEachColumn(F&& f) {
+        f(id); f(owner); f(pos); f(angle); f(expiresAt);
+    }
+    template <class F>
+    void forEachColumn(F&& f) const {
+        f(id); f(owner); f(pos); f(angle); f(expiresAt);
+    }
+};
+
+struct MineTable : TableOps<MineTable> {
+    std::vector<int> id;
+    std::vector<int> owner;
+    std::vector<Vector2> pos;
+    std::vector<MinePhase> phase;
+    std::vector<uint32_t> explodeAt; // tick at which an activated mine explodes
+    std::vector<uint32_t> spentAt;   // tick at which the explosion is over
+
+    template <class F>
+    void forEachColumn(F&& f) {
+        f(id); f(owner); f(pos); f(phase); f(explodeAt); f(spentAt);
+    }
+    template <class F>
+    void forEachColumn(F&& f) const {
+        f(id); f(owner); f(pos); f(phase); f(explodeAt); f(spentAt);
+    }
+};
+
+struct PowerupTable : TableOps<PowerupTable> {
+    std::vector<int> id;
+    std::vector<Vector2> pos;
+    std::vector<float> radius;
+    std::vector<ProjectileType> type;
+    std::vector<uint8_t> acquired;
+
+    template <class F>
+    void forEachColumn(F&& f) {
+        f(id); f(pos); f(radius); f(type); f(acquired);
+    }
+    template <class F>
+    void forEachColumn(F&& f) const {
+        f(id); f(pos); f(radius); f(type); f(acquired);
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SIM_CONFIG_H
+#define SIM_CONFIG_H
+
+enum class ProjectileType {
+    BULLET,
+    LASER_BEAM,
+    MINE,
+    PLUS
+};
+
+// Gameplay constants of one match.
+// Built once from GameSettings when the match starts and never modified
+// afterwards, so systems can take it by const reference and several
+// simulations can share it across threads.
+struct SimConfig {
+    // arena
+    int w, h;
+    int numStartSpaceships;
+    int tickRate; // simulation steps per second
+
+    // powerup settings
+    float powerupSpawnInterval;
+    float powerupRadius;
+
+    // spaceship settings
+    int spaceshipSize;
+    float rotationSpeed, forceBoost, drag, rotBoostDeg;
+
+    // projectile settings
+    float bulletSpeed, bulletRadius, bulletLifeTime;
+    float laserBeamLifeTime, laserBeamWidth;
+    float mineActivationDuration, mineActiveRadius, mineExplosionRadius, mineExplosionDuration, mineSize;
+
+    // derived constants, filled in by finalize()
+    float tickDuration;          // seconds per simulation step
+    int powerupSpawnTicks, bulletLifeTicks, laserBeamLifeTicks, mineActivationTicks, mineExplosionTicks;
+    float shipRadius;            // spaceshipSize / 2, every spaceship has the same collision circle
+    float shipMinX, shipMaxX, shipMinY, shipMaxY; // clamp range of spaceship centers
+    float bulletHalfSize;        // bullets bounce once their center is this close to the border
+    float bulletMinX, bulletMaxX, bulletMinY, bulletMaxY;
+    float laserHitDistance;      // max distance from the beam axis to a spaceship center
+    float shipShipRadiusSq;      // (2 * shipRadius)^2
+    float shipBulletRadiusSq;    // (shipRadius + bulletRadius)^2
+    float mineTriggerRadiusSq;   // (shipRadius + mineActiveRadius)^2
+    float mineExplosionRadiusSq; // mineExplosionRadius^2
+    float mineBlastRadiusSq;     // (shipRadius + mineExplosionRadius)^2
+
+    // whole ticks closest to a duration in seconds, at least one
+    constexpr int ticks(float seconds) const {
+        int n = (int)(seconds * tickRate + 0.5f);
+        return n > 0 ? n : 1;
+    }
+
+    constexpr void finalize() {
+        tickDuration = 1.0f / tickRate;
+        powerupSpawnTicks = ticks(powerupSpawnInterval);
+        bulletLifeTicks = ticks(bulletLifeTime);
+        laserBeamLifeTicks = ticks(laserBeamLifeTime);
+        mineActivationTicks = ticks(mineActivationDuration);
+        mineExplosionTicks = ticks(mineExplosionDuration);
+
+        shipRadius = spaceshipSize / 2;
+        shipMinX = shipRadius;
+        shipMaxX = w - shipRadius;
+        shipMinY = shipRadius;
+        shipMaxY = h - shipRadius;
+
+        bulletHalfSize = bulletRadius / 2;
+        bulletMinX = bulletHalfSize;
+        bulletMaxX = w - bulletHalfSize;
+        bulletMinY = bulletHalfSize;
+        bulletMaxY = h - bulletHalfSize;
+
+        laserHitDistance = shipRadius + laserBeamWidth / 2;
+
+        shipShipRadiusSq = (2 * shipRadius) * (2 * shipRadius);
+        shipBulletRadiusSq = (shipRadius + bulletRadius) * (shipRadius + bulletRadius);
+        mineTriggerRadiusSq = (shipRadius + mineActiveRadius) * (shipRadius + mineActiveRadius);
+        mineExplosionRadiusSq = mineExplosionRadius * mineExplosionRadius;
+        mineBlastRadiusSq = (shipRadius + mineExplosionRadius) * (shipRadius + mineExplosionRadius);
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "sim/hash.h"
+#include "sim/world.h"
+
+template <class Table>
+static void hashTable(StateHasher& hasher, const Table& table) {
+    table.forEachColumn([&](const auto& column) { hasher.add(column); });
+}
+
+template <class Table>
+static void hashRows(const Table& table, char name, std::vector<EntityHash>& out) {
+    for (size_t row = 0; row < table.size(); row++) {
+        StateHasher hasher;
+        table.forEachColumn([&](const auto& column) { hasher.addValue(column[row]); });
+        out.push_back({name, table.id[row], hasher.digest()});
+    }
+}
+
+uint64_t hashWorld(const World& world) {
+    StateHasher hasher(world.seed);
+    hasher.addValue(world.tick);
+    hasher.addValue(world.nextId);
+    hasher.addValue(world.powerupSpawnAt);
+    hasher.addValue(world.spawnRng);
+    hasher.add(world.activeShip);
+    hasher.add(world.team);
+    hasher.add(world.relations);
+    hashTable(hasher, world.ships);
+    hashTable(hasher, world.bullets);
+    hashTable(hasher, world.lasers);
+    hashTable(hasher, world.mines);
+    hashTable(hasher, world.powerups);
+    return hasher.digest();
+}
+
+void hashEntities(const World& world, std::vector<EntityHash>& out) {
+    hashRows(world.ships, 'S', out);
+    hashRows(world.bullets, 'B', out);
+    hashRows(world.lasers, 'L', out);
+    hashRows(world.mines, 'M', out);
+    hashRows(world.powerups, 'P', out);
+}
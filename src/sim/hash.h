@@ -0,0 +1,73 @@
+#ifndef SIM_HASH_H
+#define SIM_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+struct World;
+
+// Streaming 64-bit hash, fed column by column. Not cryptographic, only meant
+// to notice when two simulations that should be identical are not.
+class StateHasher {
+private:
+    uint64_t h;
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        return x ^ (x >> 33);
+    }
+public:
+    explicit StateHasher(uint64_t seed = 0) : h(seed ^ 0x243f6a8885a308d3ull) {}
+
+    void add(const void* data, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (; size >= 8; p += 8, size -= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            h = (h ^ mix(word)) * 0x9e3779b97f4a7c15ull;
+        }
+        uint64_t tail = 0;
+        if (size > 0) {
+            std::memcpy(&tail, p, size);
+        }
+        h = (h ^ mix(tail ^ ((uint64_t)size << 56))) * 0x9e3779b97f4a7c15ull;
+    }
+
+    // columns are hashed as raw bytes, component structs must not have padding
+    template <class T>
+    void add(const std::vector<T>& column) {
+        uint64_t n = column.size();
+        add(&n, sizeof(n));
+        add(column.data(), n * sizeof(T));
+    }
+
+    template <class T>
+    void addValue(const T& value) {
+        add(&value, sizeof(T));
+    }
+
+    uint64_t digest() const { return mix(h); }
+};
+
+// Hash of one entity (a row of one of the world's tables)
+struct EntityHash {
+    char table; // 'S'hip, 'B'ullet, 'L'aser, 'M'ine, 'P'owerup
+    int id;
+    uint64_t hash;
+};
+
+// Everything that influences future ticks: all tables, active spaceships,
+// teams and their relations, tick, timers' deadlines (they live in the
+// tables), rng state and id counter.
+// Events and the timer wheel's internal layout are left out.
+uint64_t hashWorld(const World& world);
+
+// Per-entity hashes in table order, to tell which entity two worlds disagree on
+void hashEntities(const World& world, std::vector<EntityHash>& out);
+
+#endif
@@ -0,0 +1,102 @@
+#include "sim/job_system.h"
+#include <algorithm>
+
+// the pool and worker index of the current thread, -1 outside the workers
+static thread_local const JobSystem* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+// std heaps put the largest element on top, so "less" means "runs later"
+bool JobSystem::runsLater(const Job& a, const Job& b) {
+    return a.deadline != b.deadline ? a.deadline > b.deadline : a.order > b.order;
+}
+
+JobSystem::JobSystem(int numWorkers) : stopping(false) {
+    for (int i = 0; i < std::max(numWorkers, 1); i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(JobGroup& group, std::function<void()> run, uint64_t deadline) {
+    group.remaining.fetch_add(1);
+    uint64_t order = submitted.fetch_add(1);
+    int target = currentPool == this ? currentWorker : (int)(order % queues.size());
+    Queue& queue = *queues[target];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.heap.push_back({deadline, order, &group, std::move(run)});
+        std::push_heap(queue.heap.begin(), queue.heap.end(), runsLater);
+    }
+    queued.fetch_add(1);
+    // a worker going to sleep counts itself before checking queued, one of the two sees the other
+    if (sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+bool JobSystem::pop(Queue& queue, Job& job) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.heap.empty()) {
+        return false;
+    }
+    std::pop_heap(queue.heap.begin(), queue.heap.end(), runsLater);
+    job = std::move(queue.heap.back());
+    queue.heap.pop_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::runOne(int self) {
+    Job job;
+    bool found = self >= 0 && pop(*queues[self], job);
+    // steal, starting from the next worker so thieves spread over the victims
+    for (size_t i = 1; !found && i <= queues.size(); i++) {
+        found = pop(*queues[(self + i) % queues.size()], job);
+    }
+    if (!found) {
+        return false;
+    }
+    job.run();
+    job.group->remaining.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::wait(JobGroup& group) {
+    int self = currentPool == this ? currentWorker : -1;
+    while (group.remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(int index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.fetch_add(1);
+        wake.wait(lock, [&]() { return stopping || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef SIM_JOB_SYSTEM_H
+#define SIM_JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Jobs that are waited on together
+struct JobGroup {
+    std::atomic<int> remaining{0};
+};
+
+// Work-stealing thread pool.
+// Every worker owns a queue ordered by deadline and runs its earliest job
+// first. Once its queue is empty it steals the earliest job of another
+// worker, so an overdue job never sits behind later ones while a worker idles.
+// A thread waiting on a group runs queued jobs instead of blocking, which
+// also makes a pool without workers run everything on the waiting thread.
+class JobSystem {
+public:
+    static constexpr uint64_t NO_DEADLINE = UINT64_MAX;
+
+    explicit JobSystem(int numWorkers);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int numWorkers() const { return workers.size(); }
+
+    // Jobs submitted by a worker go to its own queue, others are spread
+    // round-robin. Equal deadlines run in submission order on one queue.
+    void submit(JobGroup& group, std::function<void()> job, uint64_t deadline = NO_DEADLINE);
+    // runs queued jobs until every job of the group is done
+    void wait(JobGroup& group);
+
+private:
+    struct Job {
+        uint64_t deadline;
+        uint64_t order;
+        JobGroup* group;
+        std::function<void()> run;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Job> heap; // earliest (deadline, order) on top
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; // one per worker, at least one
+    std::vector<std::thread> workers;
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<int> queued{0};
+    std::atomic<int> sleeping{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    static bool runsLater(const Job& a, const Job& b); // heap order
+    bool pop(Queue& queue, Job& job);
+    bool runOne(int self); // own queue first, then steal; self is -1 outside the workers
+    void workerLoop(int index);
+};
+
+// Runs fn(begin, end) over consecutive chunks of [0, count), on the workers and
+// the calling thread. Chunks grow with count to about four per thread and are
+// never smaller than minChunk; a range that fits in one chunk runs inline, as
+// does everything when jobs is null. Chunks must only write to their own rows,
+// anything shared is collected per chunk and merged in row order afterwards.
+template <class Fn>
+void parallelFor(JobSystem* jobs, size_t count, size_t minChunk, Fn&& fn) {
+    size_t slices = jobs != nullptr ? 4 * (jobs->numWorkers() + 1) : 1;
+    size_t chunk = std::max(minChunk, (count + slices - 1) / slices);
+    if (jobs == nullptr || count <= chunk) {
+        if (count > 0) {
+            fn((size_t)0, count);
+        }
+        return;
+    }
+    JobGroup group;
+    for (size_t begin = chunk; begin < count; begin += chunk) {
+        size_t end = std::min(begin + chunk, count);
+        jobs->submit(group, [&fn, begin, end]() { fn(begin, end); });
+    }
+    fn((size_t)0, chunk);
+    jobs->wait(group);
+}
+
+#endif
@@ -0,0 +1,208 @@
+#include "sim/replay.h"
+#include "sim/snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// InputButton uses the low 5 bits, the owner is packed above them
+const int BUTTON_BITS = 5;
+const uint8_t BUTTON_MASK = (1 << BUTTON_BITS) - 1;
+
+static void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) {
+            return false;
+        }
+        uint8_t byte = *p++;
+        v |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Replay::begin(const World& world) {
+    saveSnapshot(world, start);
+    numPlayers = world.numPlayers();
+    inputs.clear();
+}
+
+void Replay::record(const uint8_t* buttons) {
+    inputs.insert(inputs.end(), buttons, buttons + numPlayers);
+}
+
+void encodeReplay(const Replay& replay, std::vector<uint8_t>& out) {
+    ReplayHeader header{REPLAY_MAGIC, REPLAY_VERSION, (uint16_t)replay.numPlayers, replay.length(), (uint32_t)replay.start.size()};
+    out.resize(sizeof(header));
+    std::memcpy(out.data(), &header, sizeof(header));
+    out.insert(out.end(), replay.start.begin(), replay.start.end());
+
+    std::vector<uint8_t> held(replay.numPlayers, 0);
+    uint32_t lastChange = 0;
+    for (uint32_t tick = 0; tick < replay.length(); tick++) {
+        const uint8_t* buttons = replay.inputsAt(tick);
+        for (int owner = 0; owner < replay.numPlayers; owner++) {
+            if (buttons[owner] == held[owner]) {
+                continue;
+            }
+            putVarint(out, tick - lastChange);
+            putVarint(out, (uint32_t)owner << BUTTON_BITS | buttons[owner]);
+            held[owner] = buttons[owner];
+            lastChange = tick;
+        }
+    }
+}
+
+bool decodeReplay(Replay& replay, const uint8_t* data, size_t size) {
+    ReplayHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION || header.numPlayers == 0
+        || header.snapshotSize > size - sizeof(header) || (size_t)header.length * header.numPlayers > REPLAY_MAX_INPUTS) {
+        return false;
+    }
+    // the start snapshot has to be of as many players, which it holds numPlayers^2 relations of
+    SnapshotHeader snapshot;
+    if (header.snapshotSize < sizeof(snapshot)) {
+        return false;
+    }
+    std::memcpy(&snapshot, data + sizeof(header), sizeof(snapshot));
+    if (snapshot.numPlayers != header.numPlayers || snapshot.size != header.snapshotSize) {
+        return false;
+    }
+    const uint8_t* p = data + sizeof(header) + header.snapshotSize;
+    const uint8_t* end = data + size;
+    const int numPlayers = header.numPlayers;
+
+    // the changes are checked before anything is allocated for them
+    const uint8_t* changes = p;
+    uint32_t at = 0;
+    while (p < end) {
+        uint32_t delta, packed;
+        if (!getVarint(p, end, delta) || !getVarint(p, end, packed)) {
+            return false;
+        }
+        at += delta;
+        if (at < delta || at >= header.length || (packed >> BUTTON_BITS) >= (uint32_t)numPlayers) {
+            return false;
+        }
+    }
+
+    // every tick repeats the buttons held on the previous one until a change
+    std::vector<uint8_t> start(data + sizeof(header), changes);
+    std::vector<uint8_t> inputs((size_t)header.length * numPlayers);
+    std::vector<uint8_t> held(numPlayers, 0);
+    uint32_t filled = 0;
+    at = 0;
+    for (p = changes; p < end;) {
+        uint32_t delta, packed;
+        getVarint(p, end, delta);
+        getVarint(p, end, packed);
+        at += delta;
+        uint32_t owner = packed >> BUTTON_BITS;
+        for (; filled < at; filled++) {
+            std::copy(held.begin(), held.end(), inputs.begin() + (size_t)filled * numPlayers);
+        }
+        held[owner] = packed & BUTTON_MASK;
+    }
+    for (; filled < header.length; filled++) {
+        std::copy(held.begin(), held.end(), inputs.begin() + (size_t)filled * numPlayers);
+    }
+
+    replay.start = std::move(start);
+    replay.numPlayers = numPlayers;
+    replay.inputs = std::move(inputs);
+    return true;
+}
+
+bool saveReplayFile(const Replay& replay, const char* path) {
+    std::vector<uint8_t> data;
+    encodeReplay(replay, data);
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+bool loadReplayFile(Replay& replay, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(f);
+    return decodeReplay(replay, data.data(), data.size());
+}
+
+ReplayPlayer::ReplayPlayer() : startTick(0), keyframeInterval(1), world(SimConfig{}, 1, 0) {}
+
+bool ReplayPlayer::open(const Replay& recorded, uint32_t interval) {
+    World start = world;
+    if (!loadSnapshot(start, recorded.start.data(), recorded.start.size()) || start.numPlayers() != recorded.numPlayers) {
+        return false;
+    }
+    replay = recorded;
+    keyframeInterval = interval > 0 ? interval : (uint32_t)start.config.ticks(1.0f);
+    startTick = start.tick;
+    world = std::move(start);
+
+    keyframes.clear();
+    keyframes.push_back(replay.start);
+    while (stepForward()) {
+        if (tick() % keyframeInterval == 0) {
+            keyframes.emplace_back();
+            saveSnapshot(world, keyframes.back());
+        }
+    }
+    seek(0);
+    return true;
+}
+
+void ReplayPlayer::advance() {
+    const uint8_t* buttons = replay.inputsAt(tick());
+    for (int owner = 0; owner < replay.numPlayers; owner++) {
+        world.applyInput(owner, buttons[owner]);
+    }
+    world.step();
+    world.events.clear();
+}
+
+bool ReplayPlayer::stepForward() {
+    if (tick() >= length()) {
+        return false;
+    }
+    advance();
+    return true;
+}
+
+void ReplayPlayer::seek(uint32_t target) {
+    target = std::min(target, length());
+    // keep going from the current position when no keyframe is closer
+    if (target < tick() || target / keyframeInterval > tick() / keyframeInterval) {
+        const std::vector<uint8_t>& keyframe = keyframes[std::min<size_t>(target / keyframeInterval, keyframes.size() - 1)];
+        loadSnapshot(world, keyframe.data(), keyframe.size());
+    }
+    while (tick() < target) {
+        advance();
+    }
+}
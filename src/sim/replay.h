@@ -0,0 +1,102 @@
+#ifndef SIM_REPLAY_H
+#define SIM_REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "sim/world.h"
+#include "sim/snapshot.h"
+
+// A recorded match: the snapshot it started from and the buttons every player
+// held on every tick. Replaying the inputs from the snapshot reproduces the
+// match exactly, the simulation being deterministic.
+//
+// File layout: ReplayHeader, the start snapshot, then the inputs as a list of
+// changes. Each change is a varint of the ticks since the previous change and
+// a varint of (owner << 5 | buttons). Buttons held over several ticks cost
+// nothing, so a whole match is a few KB.
+constexpr uint32_t REPLAY_MAGIC = 0x594c5052; // "RPLY"
+constexpr uint16_t REPLAY_VERSION = 1;
+// most input bytes (ticks * players) a replay decodes to, over 150 hours of a
+// 1v1 at 60 ticks per second; the sparse encoding says little about the
+// decoded size, so a header is not trusted beyond this
+constexpr size_t REPLAY_MAX_INPUTS = (size_t)1 << 26;
+
+struct ReplayHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t numPlayers;
+    uint32_t length;       // ticks
+    uint32_t snapshotSize; // bytes of the start snapshot following the header
+};
+
+struct Replay {
+    std::vector<uint8_t> start;  // snapshot of the world before the first tick
+    int numPlayers = 0;
+    std::vector<uint8_t> inputs; // numPlayers InputButton bytes per tick
+
+    uint32_t length() const { return numPlayers > 0 ? inputs.size() / numPlayers : 0; }
+    const uint8_t* inputsAt(uint32_t tick) const { return &inputs[tick * numPlayers]; }
+
+    void begin(const World& world);      // drops what was recorded and starts over from world
+    void record(const uint8_t* buttons); // buttons of every player for the next tick
+};
+
+void encodeReplay(const Replay& replay, std::vector<uint8_t>& out);
+// false if the data is truncated or malformed or decodes to more than
+// REPLAY_MAX_INPUTS; of the start snapshot only the player count and size are
+// checked, the rest when it is restored
+bool decodeReplay(Replay& replay, const uint8_t* data, size_t size);
+
+bool saveReplayFile(const Replay& replay, const char* path);
+bool loadReplayFile(Replay& replay, const char* path);
+
+// Plays the whole replay into world from its start snapshot, without keyframes.
+// onTick(world) runs after every tick while world.events holds the tick's events.
+// Returns false if the start snapshot cannot be restored by this build.
+template <class OnTick>
+bool playReplay(const Replay& replay, World& world, OnTick&& onTick) {
+    if (!loadSnapshot(world, replay.start.data(), replay.start.size()) || world.numPlayers() != replay.numPlayers) {
+        return false;
+    }
+    for (uint32_t tick = 0; tick < replay.length(); tick++) {
+        const uint8_t* buttons = replay.inputsAt(tick);
+        for (int owner = 0; owner < replay.numPlayers; owner++) {
+            world.applyInput(owner, buttons[owner]);
+        }
+        world.step();
+        onTick(world);
+        world.events.clear();
+    }
+    return true;
+}
+
+// Plays a replay back with random access.
+// Opening it re-simulates the whole match once, headless, keeping a snapshot
+// every keyframeInterval ticks. Seeking restores the last keyframe at or
+// before the target and fast-forwards from there, so a seek anywhere never
+// simulates more than one interval. Events are dropped, playback is silent.
+class ReplayPlayer {
+private:
+    Replay replay;
+    uint32_t startTick;
+    uint32_t keyframeInterval;
+    std::vector<std::vector<uint8_t>> keyframes; // keyframes[i] is the world after i * keyframeInterval ticks
+
+    void advance(); // plays the inputs of the current tick
+public:
+    World world;
+
+    ReplayPlayer();
+    // false if the start snapshot cannot be restored by this build; a
+    // keyframeInterval of 0 keeps one per second at the tick rate the replay
+    // was recorded at
+    bool open(const Replay& replay, uint32_t keyframeInterval = 0);
+
+    uint32_t tick() const { return world.tick - startTick; } // ticks played since the start
+    uint32_t length() const { return replay.length(); }
+    bool stepForward(); // false once the end is reached
+    void seek(uint32_t tick);
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SIM_RNG_H
+#define SIM_RNG_H
+
+#include <cstdint>
+
+// Streams derived from one match seed, so adding a consumer never shifts the others
+enum RngStream : uint64_t {
+    RNG_STREAM_SPAWN = 1,
+    RNG_STREAM_SCRIPT = 2, // scripted inputs of the tools/ programs
+    RNG_STREAM_AI = 0x100,     // + owner
+    RNG_STREAM_PLANNER = 0x200 // + owner, rollouts of the AI planner
+};
+
+// xoshiro128** generator, small enough to copy around with the state it belongs to.
+// Every simulation owns its generators instead of sharing the process-global rand(),
+// so matches with the same seed play out identically on any thread.
+class Rng {
+private:
+    uint32_t s[4];
+
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+public:
+    // the same (seed, stream) pair always gives the same sequence
+    explicit Rng(uint64_t seed = 0, uint64_t stream = 0) {
+        uint64_t x = seed ^ (stream * 0xd1342543de82ef95ull);
+        uint64_t a = splitmix64(x), b = splitmix64(x);
+        s[0] = (uint32_t)a;
+        s[1] = (uint32_t)(a >> 32);
+        s[2] = (uint32_t)b;
+        s[3] = (uint32_t)(b >> 32);
+    }
+
+    uint32_t next() {
+        uint32_t result = rotl(s[1] * 5, 7) * 9;
+        uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    // uniform integer in [0, n), n > 0
+    uint32_t below(uint32_t n) {
+        // Lemire's multiply-shift with rejection of the biased low range
+        uint64_t m = (uint64_t)next() * n;
+        uint32_t low = (uint32_t)m;
+        if (low < n) {
+            uint32_t threshold = -n % n;
+            while (low < threshold) {
+                m = (uint64_t)next() * n;
+                low = (uint32_t)m;
+            }
+        }
+        return (uint32_t)(m >> 32);
+    }
+
+    // uniform float in [0, 1)
+    float uniform() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+#endif
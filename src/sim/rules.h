@@ -0,0 +1,53 @@
+#ifndef SIM_RULES_H
+#define SIM_RULES_H
+
+#include "sim/config.h"
+
+// Rules policies select where the systems read their constants from.
+// Every policy exposes a `cfg` member, systems only ever touch rules.cfg.
+
+// Runtime-configurable rules, read from the match's SimConfig.
+struct ConfigRules {
+    const SimConfig& cfg;
+};
+
+// Compile-time rules, Profile::config() is evaluated by the compiler and every
+// constant it holds is folded into the instantiated systems.
+template <class Profile>
+struct StaticRules {
+    static constexpr SimConfig cfg = Profile::config();
+};
+
+// Fixed rules used in tournament builds, they match the shipped config.json.
+struct TournamentProfile {
+    static constexpr SimConfig config() {
+        SimConfig c{};
+        c.w = 1200;
+        c.h = 900;
+        c.numStartSpaceships = 3;
+        c.tickRate = 60;
+        c.powerupSpawnInterval = 5.0f;
+        c.powerupRadius = 16.0f;
+        c.spaceshipSize = 32;
+        c.rotationSpeed = 270.0f;
+        c.forceBoost = 300.0f;
+        c.drag = 0.99f;
+        c.rotBoostDeg = -75.0f;
+        c.bulletSpeed = 500.0f;
+        c.bulletRadius = 8.0f;
+        c.bulletLifeTime = 2.0f;
+        c.laserBeamLifeTime = 0.1f;
+        c.laserBeamWidth = 6.0f;
+        c.mineActivationDuration = 1.0f;
+        c.mineActiveRadius = 100.0f;
+        c.mineExplosionRadius = 150.0f;
+        c.mineExplosionDuration = 0.2f;
+        c.mineSize = 10.0f;
+        c.finalize();
+        return c;
+    }
+};
+
+using TournamentRules = StaticRules<TournamentProfile>;
+
+#endif
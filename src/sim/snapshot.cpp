@@ -0,0 +1,303 @@
+#include "sim/snapshot.h"
+#include "sim/world.h"
+#include "sim/hash.h"
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+template <class T>
+using ColumnValue = typename std::decay<T>::type::value_type;
+
+struct SnapshotWriter {
+    std::vector<uint8_t>& out;
+
+    void bytes(const void* data, size_t size) {
+        size_t at = out.size();
+        out.resize(at + size);
+        if (size > 0) {
+            std::memcpy(out.data() + at, data, size);
+        }
+    }
+
+    template <class T>
+    void value(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values are copied as raw bytes");
+        bytes(&v, sizeof(T));
+    }
+
+    template <class T>
+    void column(const std::vector<T>& c) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot columns are copied as raw bytes");
+        bytes(c.data(), c.size() * sizeof(T));
+    }
+
+    template <class Table>
+    void table(const Table& t) {
+        value((uint32_t)t.size());
+        t.forEachColumn([&](const auto& c) { column(c); });
+    }
+};
+
+// Bounds are checked once up front by snapshotSizeOk, reads never overrun.
+struct SnapshotReader {
+    const uint8_t* p;
+
+    void bytes(void* data, size_t size) {
+        if (size > 0) {
+            std::memcpy(data, p, size);
+        }
+        p += size;
+    }
+
+    template <class T>
+    void value(T& v) {
+        bytes(&v, sizeof(T));
+    }
+
+    template <class T>
+    void column(std::vector<T>& c, size_t rows) {
+        c.resize(rows);
+        bytes(c.data(), rows * sizeof(T));
+    }
+
+    template <class Table>
+    void table(Table& t) {
+        uint32_t rows;
+        value(rows);
+        t.forEachColumn([&](auto& c) { column(c, rows); });
+    }
+};
+
+template <class Table>
+static size_t rowBytes() {
+    size_t bytes = 0;
+    Table().forEachColumn([&](const auto& c) { bytes += sizeof(ColumnValue<decltype(c)>); });
+    return bytes;
+}
+
+template <class Table>
+static void addLayout(StateHasher& hasher) {
+    Table().forEachColumn([&](const auto& c) { hasher.addValue((uint32_t)sizeof(ColumnValue<decltype(c)>)); });
+    hasher.addValue((uint32_t)0); // table separator
+}
+
+uint32_t snapshotLayout() {
+    StateHasher hasher(SNAPSHOT_VERSION);
+    hasher.addValue((uint32_t)sizeof(SimConfig));
+    hasher.addValue((uint32_t)sizeof(Rng));
+    addLayout<ShipTable>(hasher);
+    addLayout<BulletTable>(hasher);
+    addLayout<LaserTable>(hasher);
+    addLayout<MineTable>(hasher);
+    addLayout<PowerupTable>(hasher);
+    return (uint32_t)hasher.digest();
+}
+
+// bytes of everything between the header and the first table
+static size_t fixedBytes(int numPlayers) {
+    return sizeof(SimConfig) + sizeof(uint64_t) + sizeof(Rng) + 3 * sizeof(uint32_t) + sizeof(int)
+        + sizeof(uint64_t) + 2 * numPlayers * sizeof(int) + numPlayers * numPlayers;
+}
+
+void saveSnapshot(const World& world, std::vector<uint8_t>& out) {
+    out.clear();
+    SnapshotWriter w{out};
+    SnapshotHeader header{SNAPSHOT_MAGIC, SNAPSHOT_VERSION, (uint16_t)world.numPlayers(), snapshotLayout(), 0};
+    w.value(header);
+
+    w.value(world.config);
+    w.value(world.seed);
+    w.value(world.spawnRng);
+    w.value(world.tick);
+    w.value(world.powerupSpawnAt);
+    w.value(world.hashInterval);
+    w.value(world.nextId);
+    w.value(world.stateHash);
+    w.column(world.activeShip);
+    w.column(world.team);
+    w.column(world.relations);
+
+    w.table(world.ships);
+    w.table(world.bullets);
+    w.table(world.lasers);
+    w.table(world.mines);
+    w.table(world.powerups);
+
+    header.size = out.size();
+    std::memcpy(out.data(), &header, sizeof(header));
+}
+
+// walks the row counts to make sure every table fits in exactly size bytes
+static bool snapshotSizeOk(const uint8_t* data, size_t size, const SnapshotHeader& header) {
+    size_t at = sizeof(SnapshotHeader) + fixedBytes(header.numPlayers);
+    const size_t tableRowBytes[] = {
+        rowBytes<ShipTable>(), rowBytes<BulletTable>(), rowBytes<LaserTable>(), rowBytes<MineTable>(), rowBytes<PowerupTable>()
+    };
+    for (size_t bytesPerRow : tableRowBytes) {
+        uint32_t rows;
+        if (at + sizeof(rows) > size) {
+            return false;
+        }
+        std::memcpy(&rows, data + at, sizeof(rows));
+        at += sizeof(rows);
+        if (rows > (size - at) / bytesPerRow) {
+            return false;
+        }
+        at += rows * bytesPerRow;
+    }
+    return at == size;
+}
+
+// bytes per row of the columns before column in table, which is stored at
+// the table's row count + rows * this
+template <class Table, class T>
+static size_t columnOffset(const std::vector<T> Table::*column) {
+    Table t;
+    size_t bytes = 0, offset = 0;
+    t.forEachColumn([&](const auto& c) {
+        if ((const void*)&c == (const void*)&(t.*column)) {
+            offset = bytes;
+        }
+        bytes += sizeof(ColumnValue<decltype(c)>);
+    });
+    return offset;
+}
+
+template <class Table>
+static size_t tableBytes(const uint8_t* data, size_t at) {
+    uint32_t rows;
+    std::memcpy(&rows, data + at, sizeof(rows));
+    return sizeof(rows) + rows * rowBytes<Table>();
+}
+
+// ok holds for every value of the column of the table at data + at
+template <class Table, class T, class Ok>
+static bool columnOk(const uint8_t* data, size_t at, const std::vector<T> Table::*column, Ok ok) {
+    uint32_t rows;
+    std::memcpy(&rows, data + at, sizeof(rows));
+    const uint8_t* values = data + at + sizeof(rows) + rows * columnOffset(column);
+    for (uint32_t i = 0; i < rows; i++) {
+        T v;
+        std::memcpy(&v, values + i * sizeof(v), sizeof(v));
+        if (!ok(v)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// every int of the column of the table at data + at is in [0, end)
+template <class Table>
+static bool columnInRange(const uint8_t* data, size_t at, const std::vector<int> Table::*column, int end) {
+    return columnOk(data, at, column, [end](int v) { return v >= 0 && v < end; });
+}
+
+static bool projectileTypeOk(ProjectileType type) {
+    return (int)type >= (int)ProjectileType::BULLET && (int)type <= (int)ProjectileType::PLUS;
+}
+
+// the values later used as indices or divisors, on a snapshot of the right size:
+// a positive arena and tick rate, owners and teams of existing players, and
+// enum values that name an enumerator
+static bool snapshotValuesOk(const uint8_t* data, const SnapshotHeader& header) {
+    const int players = header.numPlayers;
+    size_t at = sizeof(SnapshotHeader);
+    SimConfig config;
+    std::memcpy(&config, data + at, sizeof(config));
+    if (config.tickRate <= 0 || config.w <= 0 || config.h <= 0) {
+        return false;
+    }
+    at += fixedBytes(players) - players * players - players * sizeof(int);
+    for (int owner = 0; owner < players; owner++) {
+        int team;
+        std::memcpy(&team, data + at + owner * sizeof(team), sizeof(team));
+        if (team < 0 || team >= players) {
+            return false;
+        }
+    }
+    at += players * sizeof(int) + players * players;
+
+    if (!columnInRange(data, at, &ShipTable::owner, players) ||
+        !columnOk(data, at, &ShipTable::weapon, [](const WeaponState& w) { return projectileTypeOk(w.type); })) {
+        return false;
+    }
+    at += tableBytes<ShipTable>(data, at);
+    if (!columnInRange(data, at, &BulletTable::owner, players)) {
+        return false;
+    }
+    at += tableBytes<BulletTable>(data, at);
+    if (!columnInRange(data, at, &LaserTable::owner, players)) {
+        return false;
+    }
+    at += tableBytes<LaserTable>(data, at);
+    if (!columnInRange(data, at, &MineTable::owner, players) ||
+        !columnOk(data, at, &MineTable::phase, [](MinePhase p) { return (int)p <= (int)MinePhase::SPENT; })) {
+        return false;
+    }
+    at += tableBytes<MineTable>(data, at);
+    return columnOk(data, at, &PowerupTable::type, projectileTypeOk);
+}
+
+bool loadSnapshot(World& world, const uint8_t* data, size_t size) {
+    SnapshotHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.layout != snapshotLayout()
+        || header.size != size || !snapshotSizeOk(data, size, header) || !snapshotValuesOk(data, header)) {
+        return false;
+    }
+
+    SnapshotReader r{data + sizeof(header)};
+    r.value(world.config);
+    // the derived fields follow from the others, they are not trusted from the data
+    world.config.finalize();
+    r.value(world.seed);
+    r.value(world.spawnRng);
+    r.value(world.tick);
+    r.value(world.powerupSpawnAt);
+    r.value(world.hashInterval);
+    r.value(world.nextId);
+    r.value(world.stateHash);
+    r.column(world.activeShip, header.numPlayers);
+    r.column(world.team, header.numPlayers);
+    r.column(world.relations, header.numPlayers * header.numPlayers);
+
+    r.table(world.ships);
+    r.table(world.bullets);
+    r.table(world.lasers);
+    r.table(world.mines);
+    r.table(world.powerups);
+
+    world.events.clear();
+    world.rebuildTimers();
+    return true;
+}
+
+bool saveSnapshotFile(const World& world, const char* path) {
+    std::vector<uint8_t> data;
+    saveSnapshot(world, data);
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+bool loadSnapshotFile(World& world, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(f);
+    return loadSnapshot(world, data.data(), data.size());
+}
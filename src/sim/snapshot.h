@@ -0,0 +1,44 @@
+#ifndef SIM_SNAPSHOT_H
+#define SIM_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct World;
+
+// Binary snapshot of a whole world: config, seed and rng, tick, every table,
+// the active spaceships and the teams. Columns are stored as raw arrays in native byte
+// order (little-endian on every platform we ship), so saving and restoring
+// are a few memcpy per table. The timer wheel is not stored, it is rebuilt
+// from the deadlines kept in the components.
+//
+// Layout: SnapshotHeader, SimConfig, world fields, then per table a row count
+// followed by each column in forEachColumn order.
+constexpr uint32_t SNAPSHOT_MAGIC = 0x50414e53; // "SNAP"
+constexpr uint16_t SNAPSHOT_VERSION = 2;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t numPlayers;
+    uint32_t layout; // fingerprint of the component layouts, see snapshotLayout()
+    uint32_t size;   // total bytes including this header
+};
+
+// changes whenever a column is added, removed or resized,
+// reordering columns of the same size needs a SNAPSHOT_VERSION bump
+uint32_t snapshotLayout();
+
+void saveSnapshot(const World& world, std::vector<uint8_t>& out);
+// Replaces the whole state of world. Returns false, leaving world untouched,
+// if the data is truncated, was written by a different version or layout, or
+// holds owners or teams of no player, a non-positive arena or tick rate, or a
+// mine phase or projectile type out of its enum. The derived fields of the
+// config are recomputed rather than loaded.
+bool loadSnapshot(World& world, const uint8_t* data, size_t size);
+
+bool saveSnapshotFile(const World& world, const char* path);
+bool loadSnapshotFile(World& world, const char* path);
+
+#endif
@@ -0,0 +1,561 @@
+#include "sim/systems.h"
+#include "sim/rules.h"
+#include "sim/job_system.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+// Ship centers at the end of the last movement step, split into x and y columns
+// for the batched circle kernels. Since ships may have moved up to maxTravel
+// during that step, the kernels only serve as a broadphase for the swept tests:
+// callers widen the reach by the travel of both sides.
+// Read only once built, every narrowphase chunk passes its own hits buffer.
+struct ShipCenters {
+    std::vector<float> x, y;
+    float maxTravel;
+
+    explicit ShipCenters(const ShipTable& ships) : x(ships.size()), y(ships.size()), maxTravel(0.0f) {
+        for (size_t i = 0; i < ships.size(); i++) {
+            x[i] = ships.transform[i].pos.x;
+            y[i] = ships.transform[i].pos.y;
+            maxTravel = std::max(maxTravel, ships.transform[i].pos.distance(ships.prevPos[i]));
+        }
+    }
+
+    // ships from row `first` on within `reach` of center, marked in hits[first..]
+    size_t overlaps(Vector2 center, float reach, uint8_t* hits, size_t first = 0) const {
+        return circleOverlaps(center, reach * reach, x.data() + first, y.data() + first, x.size() - first, hits + first);
+    }
+};
+
+// A pair of rows touching at time of impact toi (fraction of the last step).
+// Contacts are resolved earliest first, ties in row order. Tests without a
+// time of impact leave it at 0 and resolve in row order.
+struct Contact {
+    float toi;
+    uint32_t a, b;
+
+    bool operator<(const Contact& other) const {
+        if (toi != other.toi) return toi < other.toi;
+        if (a != other.a) return a < other.a;
+        return b < other.b;
+    }
+};
+
+// rows per narrowphase chunk, each row tests against every ship the broadphase returns
+const size_t BULLET_CONTACT_CHUNK = 64;
+const size_t LASER_CONTACT_CHUNK = 256; // per ship, against every laser
+const size_t MINE_CONTACT_CHUNK = 16;
+const size_t SHIP_CONTACT_CHUNK = 64;
+const size_t POWERUP_CONTACT_CHUNK = 16;
+
+// Runs narrowphase(begin, end, hits, found) over chunks of [0, count) on the
+// job system of the world. A chunk only reads the world: it appends what it
+// finds to its own buffer, with its own scratch for the broadphase hits. The
+// buffers are merged and sorted, and T is totally ordered, so the result is
+// the same for any number of threads and callers resolve it serially.
+template <class T, class Fn>
+static std::vector<T> gather(const World& world, size_t count, size_t minChunk, Fn&& narrowphase) {
+    std::vector<T> merged;
+    std::mutex mutex;
+    parallelFor(world.jobs, count, minChunk, [&](size_t begin, size_t end) {
+        std::vector<uint8_t> hits(world.ships.size());
+        std::vector<T> found;
+        narrowphase(begin, end, hits.data(), found);
+        std::lock_guard<std::mutex> lock(mutex);
+        merged.insert(merged.end(), found.begin(), found.end());
+    });
+    std::sort(merged.begin(), merged.end());
+    return merged;
+}
+
+// Time of impact of ship s sweeping past a fixed point, -1 if it stays out of reach
+static float shipTOI(const ShipTable& ships, size_t s, Vector2 point, float reachSq) {
+    return sweptCircleTOI(ships.prevPos[s], ships.transform[s].pos, point, reachSq);
+}
+
+// Time of impact of two ships, both sweeping over the last step
+static float shipShipTOI(const ShipTable& ships, size_t i, size_t j, float reachSq) {
+    return sweptCircleTOI(ships.prevPos[i] - ships.prevPos[j], ships.transform[i].pos - ships.transform[j].pos, Vector2(0.0f, 0.0f), reachSq);
+}
+
+template <class Rules>
+bool laserHits(const World& world, const Rules& rules, size_t laser, Vector2 shipPos) {
+    const SimConfig& cfg = rules.cfg;
+    // beam collision is a straight line with width (rectangle)
+    // The beam will go out of the screen, so we need to check if the spaceship is within the beam's path
+    // Distance from the center of shape to the line with pos as the origin and angle as the angle
+    Vector2 pos = world.lasers.pos[laser];
+    float angle = world.lasers.angle[laser];
+    Vector2 dir = direction(angle);
+    float distance = std::abs((shipPos.x - pos.x) * dir.y - (shipPos.y - pos.y) * dir.x);
+    if (distance <= cfg.laserHitDistance) {
+        return true;
+    }
+
+    // reflected ray
+    RayIntersection res = getRayIntersectionBorder(pos, angle, cfg.w, cfg.h);
+    float reflectAngle = angle;
+    if (res.side == BorderSide::LEFT || res.side == BorderSide::RIGHT) {
+        reflectAngle = 180 - angle;
+    } else if (res.side == BorderSide::TOP || res.side == BorderSide::BOTTOM) {
+        reflectAngle = -angle;
+    }
+    Vector2 reflectPos = res.intersectionPoint;
+    Vector2 reflectDir = direction(reflectAngle);
+
+    distance = std::abs((shipPos.x - reflectPos.x) * reflectDir.y - (shipPos.y - reflectPos.y) * reflectDir.x);
+    return distance <= cfg.laserHitDistance;
+}
+
+template <class Rules>
+static void handleProjectileCollision(World& world, const Rules& rules) {
+    const SimConfig& cfg = rules.cfg;
+    ShipTable& ships = world.ships;
+    BulletTable& bullets = world.bullets;
+    ShipCenters centers(ships);
+
+    // A bullet is used up by the first enemy spaceship on its path,
+    // spaceships it reaches at that same instant are hit as well.
+    const float bulletReach = cfg.shipRadius + cfg.bulletRadius;
+    std::vector<Contact> contacts = gather<Contact>(world, bullets.size(), BULLET_CONTACT_CHUNK,
+        [&](size_t begin, size_t end, uint8_t* hits, std::vector<Contact>& found) {
+            for (size_t b = begin; b < end; b++) {
+                Vector2 from = bullets.prevPos[b], to = bullets.pos[b];
+                float reach = bulletReach + centers.maxTravel + from.distance(to);
+                if (centers.overlaps(to, reach, hits) == 0) {
+                    continue;
+                }
+                for (size_t s = 0; s < ships.size(); s++) {
+                    if (!hits[s] || !(world.relation(bullets.owner[b], ships.owner[s]) & RELATION_HIT)) {
+                        continue;
+                    }
+                    // bullet motion relative to the spaceship
+                    float toi = sweptCircleTOI(from - ships.prevPos[s], to - ships.transform[s].pos, Vector2(0.0f, 0.0f), cfg.shipBulletRadiusSq);
+                    if (toi >= 0.0f) {
+                        found.push_back({toi, (uint32_t)b, (uint32_t)s});
+                    }
+                }
+            }
+        });
+    std::vector<float> usedAt(bullets.size(), 2.0f);
+    for (const Contact& c : contacts) {
+        if (usedAt[c.a] < c.toi) {
+            continue;
+        }
+        usedAt[c.a] = c.toi;
+        ships.value[c.b]--;
+        world.events.push_back({SimEventType::SHIP_HIT, bullets.owner[c.a], ships.id[c.b], (int)ProjectileType::BULLET});
+        // invalidate the projectile
+        bullets.eol[c.a] = true;
+    }
+
+    // a spaceship is destroyed by the first laser beam crossing it
+    const LaserTable& lasers = world.lasers;
+    if (!lasers.empty()) {
+        contacts = gather<Contact>(world, ships.size(), LASER_CONTACT_CHUNK,
+            [&](size_t begin, size_t end, uint8_t*, std::vector<Contact>& found) {
+                for (size_t s = begin; s < end; s++) {
+                    for (size_t l = 0; ships.value[s] > 0 && l < lasers.size(); l++) {
+                        if ((world.relation(lasers.owner[l], ships.owner[s]) & RELATION_HIT) && laserHits(world, rules, l, ships.transform[s].pos)) {
+                            found.push_back({0.0f, (uint32_t)l, (uint32_t)s});
+                            break;
+                        }
+                    }
+                }
+            });
+        for (const Contact& c : contacts) {
+            ships.value[c.b] = 0;
+            world.events.push_back({SimEventType::SHIP_HIT, lasers.owner[c.a], ships.id[c.b], (int)ProjectileType::LASER_BEAM});
+        }
+    }
+
+    // mines are activated by the enemies of their owner,
+    // but a mine of any player will kill all spaceships in range if exploded
+    MineTable& mines = world.mines;
+    const float triggerRadiusSq = std::min(cfg.mineTriggerRadiusSq, cfg.mineExplosionRadiusSq);
+    const float triggerReach = std::sqrt(triggerRadiusSq) + centers.maxTravel;
+    const float blastReach = cfg.shipRadius + cfg.mineExplosionRadius + centers.maxTravel;
+    if (mines.empty()) {
+        return;
+    }
+    // triggers as (-1, mine, 0) ahead of blast hits as (0, mine, ship), each in mine
+    // order. The two touch different state, only their own order matters.
+    contacts = gather<Contact>(world, mines.size(), MINE_CONTACT_CHUNK,
+        [&](size_t begin, size_t end, uint8_t* hits, std::vector<Contact>& found) {
+            for (size_t m = begin; m < end; m++) {
+                if (mines.phase[m] == MinePhase::ARMED) {
+                    if (centers.overlaps(mines.pos[m], triggerReach, hits) == 0) {
+                        continue;
+                    }
+                    for (size_t s = 0; s < ships.size(); s++) {
+                        if (hits[s] && (world.relation(mines.owner[m], ships.owner[s]) & RELATION_HIT) && shipTOI(ships, s, mines.pos[m], triggerRadiusSq) >= 0.0f) {
+                            found.push_back({-1.0f, (uint32_t)m, 0});
+                            break;
+                        }
+                    }
+                } else if (mines.phase[m] == MinePhase::EXPLODING) {
+                    if (centers.overlaps(mines.pos[m], blastReach, hits) == 0) {
+                        continue;
+                    }
+                    for (size_t s = 0; s < ships.size(); s++) {
+                        if (hits[s] && ships.value[s] > 0 && shipTOI(ships, s, mines.pos[m], cfg.mineBlastRadiusSq) >= 0.0f) {
+                            found.push_back({0.0f, (uint32_t)m, (uint32_t)s});
+                        }
+                    }
+                }
+            }
+        });
+    for (const Contact& c : contacts) {
+        size_t m = c.a, s = c.b;
+        if (c.toi < 0.0f) {
+            mines.phase[m] = MinePhase::ACTIVATED;
+            mines.explodeAt[m] = world.tick + cfg.mineActivationTicks;
+            world.timers.schedule(mines.explodeAt[m], TimerKind::MINE_EXPLODE, mines.id[m]);
+        } else if (ships.value[s] > 0) {
+            // an earlier blast of this tick may have taken the spaceship already
+            ships.value[s] = 0;
+            world.events.push_back({SimEventType::SHIP_HIT, mines.owner[m], ships.id[s], (int)ProjectileType::MINE});
+        }
+    }
+}
+
+// Pairs of spaceships whose owners have relation bit in common that touched
+// during the last step, earliest first. The relation is one lookup per pair
+// the broadphase found, whatever the number of players.
+static std::vector<Contact> shipContacts(const World& world, float reachSq, uint8_t relation) {
+    const ShipTable& ships = world.ships;
+    ShipCenters centers(ships);
+    const float reach = std::sqrt(reachSq);
+    return gather<Contact>(world, ships.size(), SHIP_CONTACT_CHUNK,
+        [&](size_t begin, size_t end, uint8_t* hits, std::vector<Contact>& found) {
+            for (size_t i = begin; i < end; i++) {
+                float travel = ships.transform[i].pos.distance(ships.prevPos[i]);
+                if (centers.overlaps(ships.transform[i].pos, reach + travel + centers.maxTravel, hits, i + 1) == 0) {
+                    continue;
+                }
+                for (size_t j = i + 1; j < ships.size(); j++) {
+                    if (!hits[j] || !(world.relation(ships.owner[i], ships.owner[j]) & relation)) {
+                        continue;
+                    }
+                    float toi = shipShipTOI(ships, i, j, reachSq);
+                    if (toi >= 0.0f) {
+                        found.push_back({toi, (uint32_t)i, (uint32_t)j});
+                    }
+                }
+            }
+        });
+}
+
+template <class Rules>
+static void handleAdversarialCollision(World& world, const Rules& rules) {
+    const SimConfig& cfg = rules.cfg;
+    ShipTable& ships = world.ships;
+    size_t n = ships.size();
+    std::vector<int> collisionCnt(n, 0);
+
+    for (const Contact& c : shipContacts(world, cfg.shipShipRadiusSq, RELATION_RAM)) {
+        size_t i = c.a, j = c.b;
+        collisionCnt[i]++;
+        collisionCnt[j]++;
+        if ((ships.flags[i] & SHIP_READY_OPPOSITE_SIDE) && (ships.flags[j] & SHIP_READY_OPPOSITE_SIDE)) {
+            Vector2 p1 = ships.transform[i].pos, p2 = ships.transform[j].pos;
+            Velocity& v1 = ships.velocity[i];
+            Velocity& v2 = ships.velocity[j];
+            ships.value[i]--;
+            ships.value[j]--;
+            v1.dir = (v1.dir + (p1 - p2) * v1.speed).normalize();
+            v2.dir = (v2.dir + (p2 - p1) * v2.speed).normalize();
+            v1.speed = (v1.speed + v2.speed) / 2;
+            v2.speed = v1.speed;
+            ships.flags[i] &= ~SHIP_READY_OPPOSITE_SIDE;
+            ships.flags[j] &= ~SHIP_READY_OPPOSITE_SIDE;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (collisionCnt[i] == 0) {
+            ships.flags[i] |= SHIP_READY_OPPOSITE_SIDE;
+        }
+    }
+}
+
+template <class Rules>
+static void handleMergeCollision(World& world, const Rules& rules) {
+    const SimConfig& cfg = rules.cfg;
+    ShipTable& ships = world.ships;
+    // merged spaceships are appended to the table, only the rows present before the pass take part
+    size_t n = ships.size();
+    std::vector<int> collisionCnt(n, 0);
+
+    for (const Contact& c : shipContacts(world, cfg.shipShipRadiusSq, RELATION_MERGE)) {
+        size_t i = c.a, j = c.b;
+        if (ships.owner[i] != ships.owner[j]) {
+            continue;
+        }
+        collisionCnt[i]++;
+        collisionCnt[j]++;
+        uint8_t flags = ships.flags[i] & ships.flags[j];
+        if ((flags & SHIP_READY_SAME_SIDE) && !((ships.flags[i] | ships.flags[j]) & SHIP_MERGED)) {
+            world.mergeSpaceships(i, j);
+        }
+    }
+
+    std::vector<uint8_t> alive(ships.size());
+    for (size_t i = 0; i < ships.size(); i++) {
+        if (i < n && collisionCnt[i] == 0) {
+            ships.flags[i] |= SHIP_READY_SAME_SIDE;
+        }
+        alive[i] = !(ships.flags[i] & SHIP_MERGED);
+    }
+    if (ships.size() != n) {
+        ships.compact(alive);
+    }
+}
+
+static void pickUpPowerup(World& world, size_t ship, ProjectileType type) {
+    if (type == ProjectileType::PLUS) {
+        world.ships.value[ship]++;
+    } else if (type == ProjectileType::LASER_BEAM || type == ProjectileType::MINE) {
+        world.ships.weapon[ship].type = type;
+    }
+}
+
+template <class Rules>
+static void handlePowerupCollision(World& world, const Rules& rules) {
+    const SimConfig& cfg = rules.cfg;
+    PowerupTable& powerups = world.powerups;
+    if (powerups.empty()) {
+        return;
+    }
+
+    // the first spaceship to reach a powerup during the step takes it,
+    // found as (0, powerup, ship) and handed out in powerup order
+    ShipCenters centers(world.ships);
+    std::vector<Contact> pickups = gather<Contact>(world, powerups.size(), POWERUP_CONTACT_CHUNK,
+        [&](size_t begin, size_t end, uint8_t* hits, std::vector<Contact>& found) {
+            for (size_t p = begin; p < end; p++) {
+                float reach = powerups.radius[p] + cfg.shipRadius;
+                if (centers.overlaps(powerups.pos[p], reach + centers.maxTravel, hits) == 0) {
+                    continue;
+                }
+                int first = -1;
+                float firstTOI = 2.0f;
+                for (size_t s = 0; s < world.ships.size(); s++) {
+                    if (!hits[s]) {
+                        continue;
+                    }
+                    float toi = shipTOI(world.ships, s, powerups.pos[p], reach * reach);
+                    if (toi >= 0.0f && toi < firstTOI) {
+                        first = s;
+                        firstTOI = toi;
+                    }
+                }
+                if (first >= 0) {
+                    found.push_back({0.0f, (uint32_t)p, (uint32_t)first});
+                }
+            }
+        });
+
+    std::vector<uint8_t> alive(powerups.size());
+    for (size_t p = 0; p < powerups.size(); p++) {
+        alive[p] = !powerups.acquired[p];
+    }
+    for (const Contact& c : pickups) {
+        size_t p = c.a, ship = c.b;
+        powerups.acquired[p] = true;
+        pickUpPowerup(world, ship, powerups.type[p]);
+        world.events.push_back({SimEventType::POWERUP_PICKED, world.ships.owner[ship], world.ships.id[ship], (int)powerups.type[p]});
+        alive[p] = false;
+    }
+    powerups.compact(alive);
+}
+
+template <class Rules>
+void collisionSystem(World& world, const Rules& rules) {
+    handleProjectileCollision(world, rules);
+    handleAdversarialCollision(world, rules);
+    handleMergeCollision(world, rules);
+    handlePowerupCollision(world, rules);
+}
+
+// rows per parallelFor chunk below which the job overhead outweighs the work
+const size_t SHIP_CHUNK = 1024;
+const size_t BULLET_CHUNK = 512;
+
+// every row only reads and writes itself, so chunks can run in any order
+template <class Rules>
+void movementSystem(World& world, const Rules& rules, float deltaTime) {
+    const SimConfig& cfg = rules.cfg;
+    ShipTable& ships = world.ships;
+    parallelFor(world.jobs, ships.size(), SHIP_CHUNK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Vector2& pos = ships.transform[i].pos;
+            Velocity& v = ships.velocity[i];
+            ships.prevPos[i] = pos;
+            // Update position using velocity
+            pos += v.dir * v.speed * deltaTime;
+            // Apply drag to simulate friction
+            v.speed *= cfg.drag;
+            // clamp
+            if (pos.x < cfg.shipMinX) pos.x = cfg.shipMinX;
+            if (pos.y < cfg.shipMinY) pos.y = cfg.shipMinY;
+            if (pos.x >= cfg.shipMaxX) pos.x = cfg.shipMaxX;
+            if (pos.y >= cfg.shipMaxY) pos.y = cfg.shipMaxY;
+        }
+    });
+
+    BulletTable& bullets = world.bullets;
+    parallelFor(world.jobs, bullets.size(), BULLET_CHUNK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Vector2& pos = bullets.pos[i];
+            float& angle = bullets.angle[i];
+            bullets.prevPos[i] = pos;
+            Vector2 dir = direction(angle);
+            pos.x += bullets.speed[i] * dir.x * deltaTime;
+            pos.y += bullets.speed[i] * dir.y * deltaTime;
+
+            if (pos.x < cfg.bulletMinX || pos.x > cfg.bulletMaxX) {
+                angle = 180 - angle;
+            }
+            if (pos.y < cfg.bulletMinY || pos.y > cfg.bulletMaxY) {
+                angle = -angle;
+            }
+            // clamp the position to the screen
+            pos.x = std::clamp(pos.x, cfg.bulletMinX, cfg.bulletMaxX);
+            pos.y = std::clamp(pos.y, cfg.bulletMinY, cfg.bulletMaxY);
+        }
+    });
+}
+
+static void reloadWeapon(World& world, int shipId) {
+    int i = world.ships.find(shipId);
+    if (i < 0 || world.ships.weapon[i].reloadAt != world.tick) {
+        return; // stale, the spaceship is gone
+    }
+    WeaponState& weapon = world.ships.weapon[i];
+    weapon.reloadAt = 0;
+    // holding a powerup pauses the reload, shooting it schedules the next one
+    if (weapon.type == ProjectileType::BULLET) {
+        weapon.ammo = std::min(weapon.ammo + 1, weapon.maxAmmo);
+        world.scheduleReload(i);
+    }
+}
+
+static void spawnPowerup(World& world, const SimConfig& cfg) {
+    float x = world.spawnRng.below(cfg.w);
+    float y = world.spawnRng.below(cfg.h);
+
+    // random laser beam, mine or plus
+    int r = world.spawnRng.below(3);
+    ProjectileType pw[]{ProjectileType::LASER_BEAM, ProjectileType::MINE, ProjectileType::PLUS};
+    PowerupTable& powerups = world.powerups;
+    powerups.id.push_back(world.nextId++);
+    powerups.pos.push_back(Vector2(x, y));
+    powerups.radius.push_back(10.0f);
+    powerups.type.push_back(pw[r]);
+    powerups.acquired.push_back(false);
+}
+
+template <class Rules>
+void timerSystem(World& world, const Rules& rules) {
+    const SimConfig& cfg = rules.cfg;
+    std::vector<Timer> fired;
+    world.timers.advance(fired);
+    world.tick = world.timers.currentTick();
+    const uint32_t now = world.tick;
+
+    // a fired timer whose deadline no longer matches the component belongs to
+    // an entity that was removed or rescheduled in the meantime
+    BulletTable& bullets = world.bullets;
+    LaserTable& lasers = world.lasers;
+    MineTable& mines = world.mines;
+    std::vector<uint8_t> lasersAlive, minesAlive;
+    for (const Timer& timer : fired) {
+        switch (timer.kind) {
+            case TimerKind::BULLET_EXPIRE: {
+                int i = bullets.find(timer.entity);
+                if (i >= 0 && bullets.expiresAt[i] == now) {
+                    bullets.eol[i] = true;
+                }
+                break;
+            }
+            case TimerKind::LASER_EXPIRE: {
+                int i = lasers.find(timer.entity);
+                if (i >= 0 && lasers.expiresAt[i] == now) {
+                    lasersAlive.resize(lasers.size(), 1);
+                    lasersAlive[i] = 0;
+                }
+                break;
+            }
+            case TimerKind::MINE_EXPLODE: {
+                int i = mines.find(timer.entity);
+                if (i >= 0 && mines.phase[i] == MinePhase::ACTIVATED && mines.explodeAt[i] == now) {
+                    mines.phase[i] = MinePhase::EXPLODING;
+                    mines.spentAt[i] = now + cfg.mineExplosionTicks;
+                    world.timers.schedule(mines.spentAt[i], TimerKind::MINE_SPENT, mines.id[i]);
+                    world.events.push_back({SimEventType::MINE_EXPLODED, mines.owner[i], mines.id[i]});
+                }
+                break;
+            }
+            case TimerKind::MINE_SPENT: {
+                int i = mines.find(timer.entity);
+                if (i >= 0 && mines.phase[i] == MinePhase::EXPLODING && mines.spentAt[i] == now) {
+                    mines.phase[i] = MinePhase::SPENT;
+                    minesAlive.resize(mines.size(), 1);
+                    minesAlive[i] = 0;
+                }
+                break;
+            }
+            case TimerKind::WEAPON_RELOAD:
+                reloadWeapon(world, timer.entity);
+                break;
+            case TimerKind::POWERUP_SPAWN:
+                if (world.powerupSpawnAt == now) {
+                    spawnPowerup(world, cfg);
+                    world.powerupSpawnAt = now + cfg.powerupSpawnTicks;
+                    world.timers.schedule(world.powerupSpawnAt, TimerKind::POWERUP_SPAWN, -1);
+                }
+                break;
+        }
+    }
+
+    // expired entities are removed in one pass per table
+    if (!lasersAlive.empty()) {
+        lasers.compact(lasersAlive);
+    }
+    if (!minesAlive.empty()) {
+        mines.compact(minesAlive);
+    }
+}
+
+void lifetimeSystem(World& world) {
+    BulletTable& bullets = world.bullets;
+    std::vector<uint8_t> alive(bullets.size());
+    bool anyRemoved = false;
+    for (size_t i = 0; i < bullets.size(); i++) {
+        alive[i] = !bullets.eol[i];
+        anyRemoved |= !alive[i];
+    }
+    if (anyRemoved) {
+        bullets.compact(alive);
+    }
+
+    world.removeDestroyedSpaceships();
+}
+
+template <class Rules>
+void simulate(World& world, const Rules& rules) {
+    bool running = world.allPlayersAlive();
+    collisionSystem(world, rules);
+    if (running) {
+        movementSystem(world, rules, rules.cfg.tickDuration);
+    }
+    timerSystem(world, rules);
+    if (running) {
+        lifetimeSystem(world);
+    }
+}
+
+template void simulate<ConfigRules>(World& world, const ConfigRules& rules);
+template void simulate<TournamentRules>(World& world, const TournamentRules& rules);
@@ -0,0 +1,27 @@
+#ifndef SIM_SYSTEMS_H
+#define SIM_SYSTEMS_H
+
+#include "sim/world.h"
+
+// Systems run over whole component arrays of the world, in the order simulate calls them.
+// Those reading constants are templates over a rules policy (see sim/rules.h) so the same
+// code can read them from a runtime SimConfig or have them folded at compile time.
+
+// projectile hits, ship vs ship bounces and merges, powerup pickups
+template <class Rules> void collisionSystem(World& world, const Rules& rules);
+// integrates ship and bullet positions, bounces bullets off the arena border
+template <class Rules> void movementSystem(World& world, const Rules& rules, float deltaTime);
+// advances the timer wheel by one tick: expires projectiles, advances mine phases,
+// reloads weapons and spawns powerups, only touching the entities whose timer fired
+template <class Rules> void timerSystem(World& world, const Rules& rules);
+// removes used up bullets and destroyed ships, reads no constants
+void lifetimeSystem(World& world);
+
+// narrowphase test of a spaceship centered at shipPos against one laser beam,
+// circle tests (bullets, mines, ships, powerups) go through the batched circleOverlaps
+template <class Rules> bool laserHits(const World& world, const Rules& rules, size_t laser, Vector2 shipPos);
+
+// One simulation tick of rules.cfg.tickDuration. Instantiated for ConfigRules and TournamentRules.
+template <class Rules> void simulate(World& world, const Rules& rules);
+
+#endif
@@ -0,0 +1,62 @@
+#include "sim/timer_wheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel() : now(0) {}
+
+void TimerWheel::insert(const Timer& timer) {
+    uint32_t delta = timer.deadline - now;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1u << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    uint32_t slot = (timer.deadline >> (SLOT_BITS * level)) & (SLOTS - 1);
+    slots[level][slot].push_back(timer);
+}
+
+void TimerWheel::cascade(int level) {
+    uint32_t slot = (now >> (SLOT_BITS * level)) & (SLOTS - 1);
+    std::vector<Timer> timers;
+    timers.swap(slots[level][slot]);
+    for (const Timer& timer : timers) {
+        insert(timer);
+    }
+}
+
+void TimerWheel::schedule(uint32_t deadline, TimerKind kind, int entity) {
+    // the wheel spans 64^LEVELS ticks (over 3 days at 60 ticks per second)
+    const uint32_t range = (1u << (SLOT_BITS * LEVELS)) - 1;
+    if (deadline <= now) {
+        deadline = now + 1;
+    } else if (deadline - now > range) {
+        deadline = now + range;
+    }
+    insert({deadline, kind, entity});
+}
+
+void TimerWheel::advance(std::vector<Timer>& fired) {
+    now++;
+    // cascade from the top so timers moved down a level can cascade again this tick
+    for (int level = LEVELS - 1; level > 0; level--) {
+        if ((now & ((1u << (SLOT_BITS * level)) - 1)) == 0) {
+            cascade(level);
+        }
+    }
+
+    std::vector<Timer>& due = slots[0][now & (SLOTS - 1)];
+    size_t first = fired.size();
+    fired.insert(fired.end(), due.begin(), due.end());
+    due.clear();
+    std::sort(fired.begin() + first, fired.end(), [](const Timer& a, const Timer& b) {
+        if (a.kind != b.kind) return a.kind < b.kind;
+        return a.entity < b.entity;
+    });
+}
+
+void TimerWheel::reset(uint32_t tick) {
+    for (auto& level : slots) {
+        for (auto& slot : level) {
+            slot.clear();
+        }
+    }
+    now = tick;
+}
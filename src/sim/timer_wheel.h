@@ -0,0 +1,57 @@
+#ifndef SIM_TIMER_WHEEL_H
+#define SIM_TIMER_WHEEL_H
+
+#include <cstdint>
+#include <vector>
+
+enum class TimerKind : uint8_t {
+    BULLET_EXPIRE,
+    LASER_EXPIRE,
+    MINE_EXPLODE,   // activation countdown is over
+    MINE_SPENT,     // explosion is over
+    WEAPON_RELOAD,  // entity is the spaceship
+    POWERUP_SPAWN   // entity is -1
+};
+
+struct Timer {
+    uint32_t deadline; // tick at which it fires
+    TimerKind kind;
+    int entity;
+};
+
+// Hierarchical timer wheel over simulation ticks.
+// Level 0 holds timers due within the next 64 ticks, one slot per tick; each
+// further level covers 64 times the range of the one below with coarser slots.
+// Whenever level 0 wraps around, the next slot of the level above is cascaded
+// down, so a timer is touched at most once per level instead of once per tick.
+//
+// Timers cannot be cancelled. The deadline is also stored in the entity's
+// components, and a fired timer whose deadline no longer matches is stale.
+class TimerWheel {
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+
+    uint32_t now;
+    std::vector<Timer> slots[LEVELS][SLOTS];
+
+    void insert(const Timer& timer);
+    void cascade(int level);
+public:
+    TimerWheel();
+
+    uint32_t currentTick() const { return now; }
+
+    // deadlines at or before the current tick fire on the next advance
+    void schedule(uint32_t deadline, TimerKind kind, int entity);
+
+    // moves one tick forward and appends the timers due at it to fired,
+    // sorted by kind then entity so handlers run in a fixed order
+    void advance(std::vector<Timer>& fired);
+
+    // drops every timer and restarts the wheel at the given tick
+    void reset(uint32_t tick);
+};
+
+#endif
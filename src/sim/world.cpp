@@ -0,0 +1,362 @@
+#include "sim/world.h"
+#include "sim/systems.h"
+#include "sim/rules.h"
+#include "sim/hash.h"
+#include <algorithm>
+#include <cmath>
+
+World::World(const SimConfig& config, int numPlayers, uint64_t seed)
+    : config(config), seed(seed), spawnRng(seed, RNG_STREAM_SPAWN), activeShip(numPlayers, -1), team(numPlayers), tick(0), powerupSpawnAt(config.powerupSpawnTicks), nextId(0),
+      hashInterval(0), stateHash(0), jobs(nullptr)
+{
+    timers.schedule(powerupSpawnAt, TimerKind::POWERUP_SPAWN, -1);
+    // free for all
+    for (int owner = 0; owner < numPlayers; owner++) {
+        team[owner] = owner;
+    }
+    setTeams(team);
+}
+
+int World::numPlayers() const {
+    return activeShip.size();
+}
+
+int World::numTeams() const {
+    return team.empty() ? 0 : *std::max_element(team.begin(), team.end()) + 1;
+}
+
+void World::setTeams(const std::vector<int>& teams) {
+    int n = numPlayers();
+    team = teams;
+    relations.resize(n * n);
+    for (int a = 0; a < n; a++) {
+        for (int b = 0; b < n; b++) {
+            relations[a * n + b] = a == b ? RELATION_SELF : team[a] == team[b] ? RELATION_ALLY : RELATION_FOE;
+        }
+    }
+}
+
+int World::teamsAlive(int& lowest) const {
+    std::vector<uint8_t> alive(numTeams(), 0);
+    for (int owner : ships.owner) {
+        alive[team[owner]] = 1;
+    }
+    lowest = -1;
+    int count = 0;
+    for (int t = (int)alive.size() - 1; t >= 0; t--) {
+        if (alive[t]) {
+            lowest = t;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Owners line up in columns from the left to the right edge, two players
+// start at an eighth of the width from either side.
+void World::spawnPlayer(int owner) {
+    float spawnX = numPlayers() > 1 ? config.w / 8 + 3 * config.w / 4 * owner / (numPlayers() - 1) : config.w / 2;
+    for (int i = 1; i <= config.numStartSpaceships; i++) {
+        float spawnY = config.h / (config.numStartSpaceships + 1) * i;
+        spawnShip(owner, Vector2(spawnX, spawnY));
+    }
+    activeShip[owner] = ships.id[ships.size() - config.numStartSpaceships];
+}
+
+size_t World::spawnShip(int owner, Vector2 pos) {
+    ships.id.push_back(nextId++);
+    ships.transform.push_back({pos, 0.0f});
+    ships.prevPos.push_back(pos);
+    ships.velocity.push_back({Vector2(1.0, 0.0), 0.0f});
+    ships.owner.push_back(owner);
+    ships.value.push_back(1);
+    ships.weapon.push_back({ProjectileType::BULLET, 1.0f, 0, 2, 2});
+    ships.flags.push_back(SHIP_READY_SAME_SIDE | SHIP_READY_OPPOSITE_SIDE);
+    return ships.size() - 1;
+}
+
+bool World::hasSpaceship(int owner) const {
+    for (int o : ships.owner) {
+        if (o == owner) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool World::allPlayersAlive() const {
+    for (int owner = 0; owner < numPlayers(); owner++) {
+        if (activeShip[owner] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int World::activeIndex(int owner) const {
+    if (activeShip[owner] < 0) {
+        return -1;
+    }
+    return ships.find(activeShip[owner]);
+}
+
+Circle World::shipCollisionShape(size_t row) const {
+    return Circle(ships.transform[row].pos, config.shipRadius);
+}
+
+void World::rotate(int owner, float degrees) {
+    int i = activeIndex(owner);
+    if (i < 0) {
+        return;
+    }
+    Transform& t = ships.transform[i];
+    Velocity& v = ships.velocity[i];
+    t.angle += degrees;
+    if (t.angle >= 360.0f) {
+        t.angle -= 360.0f;
+    } else if (t.angle < 0.0f) {
+        t.angle += 360.0f;
+    }
+    // update the velocity vector to match the new angle
+    v.dir = (direction(t.angle) * v.dir.magnitude()).normalize();
+}
+
+void World::rotateAndBoost(int owner) {
+    rotate(owner, config.rotBoostDeg);
+    int i = activeIndex(owner);
+    if (i < 0) {
+        return;
+    }
+    Velocity& v = ships.velocity[i];
+    v.speed = config.forceBoost;
+    v.dir += direction(ships.transform[i].angle) * config.forceBoost;
+    v.dir = v.dir.normalize();
+}
+
+void World::shoot(int owner) {
+    int i = activeIndex(owner);
+    if (i < 0) {
+        return;
+    }
+    WeaponState& weapon = ships.weapon[i];
+    Vector2 pos = ships.transform[i].pos;
+    float angle = ships.transform[i].angle;
+    int id = nextId;
+    switch (weapon.type) {
+        case ProjectileType::BULLET:
+            if (weapon.ammo <= 0) {
+                return;
+            }
+            weapon.ammo--;
+            scheduleReload(i);
+            bullets.id.push_back(nextId++);
+            bullets.owner.push_back(owner);
+            bullets.pos.push_back(pos);
+            bullets.prevPos.push_back(pos);
+            bullets.angle.push_back(angle);
+            bullets.speed.push_back(config.bulletSpeed);
+            bullets.expiresAt.push_back(tick + config.bulletLifeTicks);
+            bullets.eol.push_back(false);
+            timers.schedule(bullets.expiresAt.back(), TimerKind::BULLET_EXPIRE, id);
+            events.push_back({SimEventType::BULLET_FIRED, owner, id});
+            break;
+        case ProjectileType::LASER_BEAM:
+            weapon.type = ProjectileType::BULLET;
+            scheduleReload(i);
+            lasers.id.push_back(nextId++);
+            lasers.owner.push_back(owner);
+            lasers.pos.push_back(pos);
+            lasers.angle.push_back(angle);
+            lasers.expiresAt.push_back(tick + config.laserBeamLifeTicks);
+            timers.schedule(lasers.expiresAt.back(), TimerKind::LASER_EXPIRE, id);
+            events.push_back({SimEventType::LASER_FIRED, owner, id});
+            break;
+        case ProjectileType::MINE:
+            weapon.type = ProjectileType::BULLET;
+            scheduleReload(i);
+            mines.id.push_back(nextId++);
+            mines.owner.push_back(owner);
+            mines.pos.push_back(pos);
+            mines.phase.push_back(MinePhase::ARMED);
+            // scheduled once the mine is activated and once it explodes
+            mines.explodeAt.push_back(0);
+            mines.spentAt.push_back(0);
+            events.push_back({SimEventType::MINE_PLACED, owner, id});
+            break;
+        default:
+            break;
+    }
+}
+
+void World::splitCurrentSpaceship(int owner) {
+    int i = activeIndex(owner);
+    if (i < 0 || ships.value[i] < 2) {
+        return;
+    }
+    Transform t = ships.transform[i];
+    Velocity v = ships.velocity[i];
+    size_t n = spawnShip(owner, t.pos);
+    ships.velocity[n] = {Vector2(0.0, 0.0) - v.dir, v.speed / 2};
+    ships.transform[n].angle = -t.angle;
+    ships.value[n] = ships.value[i] / 2;
+    ships.flags[n] &= ~SHIP_READY_SAME_SIDE;
+    ships.value[i] = ships.value[i] - ships.value[n];
+    ships.velocity[i].speed = (v.speed + v.speed / 2) * 2;
+    events.push_back({SimEventType::SHIP_SPLIT, owner, ships.id[n]});
+}
+
+void World::switchActiveSpaceship(int owner) {
+    int i = activeIndex(owner);
+    if (i < 0) {
+        return;
+    }
+    // next spaceship of the same owner in table order, wrapping around
+    int first = -1;
+    for (size_t j = 0; j < ships.size(); j++) {
+        if (ships.owner[j] != owner) {
+            continue;
+        }
+        if (first < 0) {
+            first = j;
+        }
+        if ((int)j > i) {
+            activeShip[owner] = ships.id[j];
+            return;
+        }
+    }
+    activeShip[owner] = ships.id[first];
+}
+
+void World::mergeSpaceships(size_t first, size_t second) {
+    int owner = ships.owner[first];
+    Transform a = ships.transform[first], b = ships.transform[second];
+    Velocity va = ships.velocity[first], vb = ships.velocity[second];
+    int value = ships.value[first] + ships.value[second];
+    int firstId = ships.id[first], secondId = ships.id[second];
+    ships.flags[first] |= SHIP_MERGED;
+    ships.flags[second] |= SHIP_MERGED;
+
+    size_t n = spawnShip(owner, Vector2((a.pos.x + b.pos.x) / 2, (a.pos.y + b.pos.y) / 2));
+    ships.velocity[n] = {(va.dir * va.speed + vb.dir * vb.speed).normalize(), (va.speed + vb.speed) / 2};
+    ships.transform[n].angle = std::abs(a.angle - b.angle) / 2;
+    ships.value[n] = value;
+    events.push_back({SimEventType::SHIPS_MERGED, owner, ships.id[n]});
+
+    // If the merging spaceships are the active one
+    // The new spaceship will be the active one
+    if (activeShip[owner] == firstId || activeShip[owner] == secondId) {
+        activeShip[owner] = ships.id[n];
+    }
+}
+
+void World::applyInput(int owner, uint8_t buttons) {
+    if (buttons & INPUT_ROTATE) {
+        rotate(owner, -config.rotationSpeed * config.tickDuration);
+    }
+    if (buttons & INPUT_BOOST) {
+        rotateAndBoost(owner);
+    }
+    if (buttons & INPUT_SHOOT) {
+        shoot(owner);
+    }
+    if (buttons & INPUT_SPLIT) {
+        splitCurrentSpaceship(owner);
+    }
+    if (buttons & INPUT_SWITCH) {
+        switchActiveSpaceship(owner);
+    }
+}
+
+// Reloads run only while the gun is missing ammo, a full or unused gun has no timer.
+void World::scheduleReload(size_t row) {
+    WeaponState& weapon = ships.weapon[row];
+    if (weapon.reloadAt != 0 || weapon.type != ProjectileType::BULLET || weapon.ammo >= weapon.maxAmmo) {
+        return;
+    }
+    weapon.reloadAt = tick + config.ticks(weapon.cooldown);
+    timers.schedule(weapon.reloadAt, TimerKind::WEAPON_RELOAD, ships.id[row]);
+}
+
+void World::rebuildTimers() {
+    timers.reset(tick);
+    for (size_t i = 0; i < bullets.size(); i++) {
+        timers.schedule(bullets.expiresAt[i], TimerKind::BULLET_EXPIRE, bullets.id[i]);
+    }
+    for (size_t i = 0; i < lasers.size(); i++) {
+        timers.schedule(lasers.expiresAt[i], TimerKind::LASER_EXPIRE, lasers.id[i]);
+    }
+    for (size_t i = 0; i < mines.size(); i++) {
+        if (mines.phase[i] == MinePhase::ACTIVATED) {
+            timers.schedule(mines.explodeAt[i], TimerKind::MINE_EXPLODE, mines.id[i]);
+        } else if (mines.phase[i] == MinePhase::EXPLODING) {
+            timers.schedule(mines.spentAt[i], TimerKind::MINE_SPENT, mines.id[i]);
+        }
+    }
+    for (size_t i = 0; i < ships.size(); i++) {
+        if (ships.weapon[i].reloadAt != 0) {
+            timers.schedule(ships.weapon[i].reloadAt, TimerKind::WEAPON_RELOAD, ships.id[i]);
+        }
+    }
+    timers.schedule(powerupSpawnAt, TimerKind::POWERUP_SPAWN, -1);
+}
+
+void World::removeDestroyedSpaceships() {
+    std::vector<uint8_t> alive(ships.size());
+    bool anyDestroyed = false;
+    for (size_t i = 0; i < ships.size(); i++) {
+        alive[i] = ships.value[i] > 0;
+        anyDestroyed |= !alive[i];
+    }
+    if (!anyDestroyed) {
+        return;
+    }
+    for (size_t i = 0; i < ships.size(); i++) {
+        if (!alive[i]) {
+            events.push_back({SimEventType::SHIP_DESTROYED, ships.owner[i], ships.id[i]});
+        }
+    }
+
+    // switch to the next spaceship if the active one is destroyed,
+    // one pass over the table finds it for every owner at once
+    const int n = numPlayers();
+    std::vector<int> active(n), first(n, -1), next(n, -1);
+    bool anyLost = false;
+    for (int owner = 0; owner < n; owner++) {
+        active[owner] = activeIndex(owner);
+        anyLost |= active[owner] >= 0 && !alive[active[owner]];
+    }
+    if (anyLost) {
+        for (size_t j = 0; j < ships.size(); j++) {
+            int owner = ships.owner[j];
+            if (!alive[j]) {
+                continue;
+            }
+            if (first[owner] < 0) {
+                first[owner] = j;
+            }
+            if (next[owner] < 0 && (int)j > active[owner]) {
+                next[owner] = j;
+            }
+        }
+    }
+    for (int owner = 0; owner < n; owner++) {
+        if (active[owner] < 0 || alive[active[owner]]) {
+            continue;
+        }
+        int chosen = next[owner] >= 0 ? next[owner] : first[owner];
+        activeShip[owner] = chosen >= 0 ? ships.id[chosen] : -1;
+    }
+
+    ships.compact(alive);
+}
+
+void World::step() {
+#ifdef TOURNAMENT_RULES
+    simulate(*this, TournamentRules{});
+#else
+    simulate(*this, ConfigRules{config});
+#endif
+    if (hashInterval != 0 && tick % hashInterval == 0) {
+        stateHash = hashWorld(*this);
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef SIM_WORLD_H
+#define SIM_WORLD_H
+
+#include <vector>
+#include "math.h"
+#include "sim/config.h"
+#include "sim/components.h"
+#include "sim/timer_wheel.h"
+#include "sim/rng.h"
+
+enum class SimEventType {
+    BULLET_FIRED,
+    LASER_FIRED,
+    MINE_PLACED,
+    MINE_EXPLODED,
+    SHIP_HIT,       // owner is the attacker, detail the ProjectileType of the weapon
+    SHIP_DESTROYED,
+    SHIPS_MERGED,   // entity is the new spaceship
+    SHIP_SPLIT,     // entity is the spaceship split off
+    POWERUP_PICKED  // entity is the spaceship, detail the ProjectileType of the powerup
+};
+
+class JobSystem;
+
+// Buttons held by a player during one tick, a match is fully determined by
+// its seed and the sequence of inputs of every player.
+enum InputButton : uint8_t {
+    INPUT_ROTATE = 1 << 0,
+    INPUT_BOOST = 1 << 1,
+    INPUT_SHOOT = 1 << 2,
+    INPUT_SPLIT = 1 << 3,
+    INPUT_SWITCH = 1 << 4
+};
+
+// What the spaceships and projectiles of one owner do to those of another,
+// looked up in World::relations. Every owner is its own team unless
+// World::setTeams groups them.
+enum Relation : uint8_t {
+    RELATION_MERGE = 1 << 0, // touching spaceships merge, only between spaceships of one owner
+    RELATION_RAM = 1 << 1,   // touching spaceships bounce off each other and both lose a point
+    RELATION_HIT = 1 << 2    // bullets, laser beams and mine triggers hurt the other's spaceships
+};
+
+const uint8_t RELATION_SELF = RELATION_MERGE;
+const uint8_t RELATION_ALLY = 0; // allies pass through each other
+const uint8_t RELATION_FOE = RELATION_RAM | RELATION_HIT;
+
+struct SimEvent {
+    SimEventType type;
+    int owner;
+    int entity;
+    int detail = 0;
+};
+
+// The whole simulation state of a match.
+// Players are identified by their owner index (0-based), every action below
+// is applied to the owner's active spaceship.
+struct World {
+    SimConfig config; // fixed for the whole match
+    uint64_t seed;    // every random choice of the match derives from it
+    Rng spawnRng;     // powerup placement and type
+
+    ShipTable ships;
+    BulletTable bullets;
+    LaserTable lasers;
+    MineTable mines;
+    PowerupTable powerups;
+
+    std::vector<int> activeShip; // entity id of the active spaceship per owner, -1 if none
+    std::vector<int> team;       // per owner
+    std::vector<uint8_t> relations; // Relation bits of owner a towards owner b at a * numPlayers() + b
+    std::vector<SimEvent> events; // produced by the simulation, consumed by the front end
+    uint32_t tick;                // simulation steps taken, each lasts config.tickDuration
+    uint32_t powerupSpawnAt;      // tick of the next powerup spawn
+    TimerWheel timers;            // deadlines stored in the components above
+    int nextId;
+
+    uint32_t hashInterval; // stateHash is refreshed every hashInterval ticks, 0 disables it
+    uint64_t stateHash;    // hashWorld() at the last multiple of hashInterval
+
+    JobSystem* jobs; // spreads per-entity work over its threads, null runs everything on the caller
+
+    World(const SimConfig& config, int numPlayers, uint64_t seed);
+
+    int numPlayers() const;
+    int numTeams() const;
+    // puts owner i in team teams[i] and derives the relations, teams are numbered from 0 without gaps
+    void setTeams(const std::vector<int>& teams);
+    uint8_t relation(int a, int b) const { return relations[a * activeShip.size() + b]; }
+    // teams with spaceships left, and the first of them in lowest
+    int teamsAlive(int& lowest) const;
+    void spawnPlayer(int owner);
+    size_t spawnShip(int owner, Vector2 pos);
+    bool hasSpaceship(int owner) const;
+    bool allPlayersAlive() const;
+    int activeIndex(int owner) const; // row of the owner's active spaceship, -1 if none
+    Circle shipCollisionShape(size_t row) const;
+    Rng rngStream(uint64_t stream) const { return Rng(seed, stream); } // see RngStream
+
+    // agent actions
+    void rotate(int owner, float degrees);
+    void rotateAndBoost(int owner);
+    void shoot(int owner);
+    void splitCurrentSpaceship(int owner);
+    void switchActiveSpaceship(int owner);
+    void mergeSpaceships(size_t first, size_t second);
+    void applyInput(int owner, uint8_t buttons); // InputButton bits, for one tick
+
+    void scheduleReload(size_t row);
+    void rebuildTimers(); // reschedules every deadline stored in the components, after a restore
+    void removeDestroyedSpaceships();
+    void step(); // advances the simulation by one tick
+};
+
+#endif
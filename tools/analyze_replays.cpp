@@ -0,0 +1,392 @@
+// Replay analyzer: re-simulates recorded matches headless and collects balance
+// stats per match: hit rates per weapon, merges and splits, pickups, deaths,
+// time-to-kill and mine effectiveness.
+//   analyze_replays [--threads J] [--csv FILE] [--bin FILE] PATH...
+// A PATH is a replay file or a directory searched for *.replay files. Files are
+// memory-mapped and handed out to a pool of worker threads one at a time.
+//
+// The summary is columnar, one column per stat and one row per match. --csv
+// writes it as text with the file names, --bin as "RSUM", the column and row
+// counts, then per column a 32-byte zero-padded name and one uint32 per match.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "sim/world.h"
+#include "sim/replay.h"
+
+enum Column {
+    COL_TICKS,
+    COL_TICK_RATE,
+    COL_WINNER, // player number, 0 if no single player has spaceships left
+    COL_BULLETS_FIRED,
+    COL_BULLET_HITS,
+    COL_LASERS_FIRED,
+    COL_LASER_HITS,
+    COL_MINES_PLACED,
+    COL_MINES_EXPLODED,
+    COL_MINE_HITS,
+    COL_MERGES,
+    COL_SPLITS,
+    COL_PICKUPS_PLUS,
+    COL_PICKUPS_LASER,
+    COL_PICKUPS_MINE,
+    COL_DEATHS,
+    COL_KILL_TICKS,  // sum over destroyed spaceships of the ticks from their first hit
+    COL_TIMED_KILLS, // destroyed spaceships that were hit before, COL_KILL_TICKS / COL_TIMED_KILLS is the time-to-kill
+    NUM_COLUMNS
+};
+
+static const char* COLUMN_NAMES[NUM_COLUMNS] = {
+    "ticks", "tick_rate", "winner", "bullets_fired", "bullet_hits", "lasers_fired", "laser_hits", "mines_placed", "mines_exploded",
+    "mine_hits", "merges", "splits", "pickups_plus", "pickups_laser", "pickups_mine", "deaths", "kill_ticks", "timed_kills"
+};
+
+// Stats of one match, fed by one hook per kind of event
+struct MatchStats {
+    uint32_t row[NUM_COLUMNS] = {};
+    std::unordered_map<int, uint32_t> firstHitAt; // spaceship id -> tick
+
+    void onFired(SimEventType type) {
+        if (type == SimEventType::BULLET_FIRED) row[COL_BULLETS_FIRED]++;
+        else if (type == SimEventType::LASER_FIRED) row[COL_LASERS_FIRED]++;
+        else if (type == SimEventType::MINE_PLACED) row[COL_MINES_PLACED]++;
+        else if (type == SimEventType::MINE_EXPLODED) row[COL_MINES_EXPLODED]++;
+    }
+
+    void onHit(const World& world, const SimEvent& e) {
+        switch ((ProjectileType)e.detail) {
+            case ProjectileType::BULLET: row[COL_BULLET_HITS]++; break;
+            case ProjectileType::LASER_BEAM: row[COL_LASER_HITS]++; break;
+            case ProjectileType::MINE: row[COL_MINE_HITS]++; break;
+            default: break;
+        }
+        firstHitAt.emplace(e.entity, world.tick);
+    }
+
+    void onDeath(const World& world, const SimEvent& e) {
+        row[COL_DEATHS]++;
+        auto hit = firstHitAt.find(e.entity);
+        if (hit != firstHitAt.end()) {
+            row[COL_KILL_TICKS] += world.tick - hit->second;
+            row[COL_TIMED_KILLS]++;
+            firstHitAt.erase(hit);
+        }
+    }
+
+    void onMerge(const SimEvent&) { row[COL_MERGES]++; }
+    void onSplit(const SimEvent&) { row[COL_SPLITS]++; }
+
+    void onPickup(const SimEvent& e) {
+        switch ((ProjectileType)e.detail) {
+            case ProjectileType::PLUS: row[COL_PICKUPS_PLUS]++; break;
+            case ProjectileType::LASER_BEAM: row[COL_PICKUPS_LASER]++; break;
+            case ProjectileType::MINE: row[COL_PICKUPS_MINE]++; break;
+            default: break;
+        }
+    }
+
+    void onTick(const World& world) {
+        for (const SimEvent& e : world.events) {
+            switch (e.type) {
+                case SimEventType::SHIP_HIT: onHit(world, e); break;
+                case SimEventType::SHIP_DESTROYED: onDeath(world, e); break;
+                case SimEventType::SHIPS_MERGED: onMerge(e); break;
+                case SimEventType::SHIP_SPLIT: onSplit(e); break;
+                case SimEventType::POWERUP_PICKED: onPickup(e); break;
+                default: onFired(e.type); break;
+            }
+        }
+    }
+
+    void onEnd(const World& world) {
+        row[COL_TICKS] = world.tick;
+        row[COL_TICK_RATE] = world.config.tickRate;
+        int alive = 0;
+        for (int owner = 0; owner < world.numPlayers(); owner++) {
+            if (world.hasSpaceship(owner)) {
+                alive++;
+                row[COL_WINNER] = owner + 1;
+            }
+        }
+        if (alive != 1) {
+            row[COL_WINNER] = 0;
+        }
+    }
+};
+
+// Read-only view of a whole file, mapped where the platform allows it
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+
+    bool open(const char* path) {
+        FILE* f = fopen(path, "rb");
+        if (f == nullptr) {
+            return false;
+        }
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+        }
+        fclose(f);
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+    }
+#else
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = st.st_size;
+        if (size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                return false;
+            }
+            madvise(p, size, MADV_SEQUENTIAL);
+            data = (const uint8_t*)p;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap((void*)data, size);
+        }
+    }
+#endif
+};
+
+struct Summary {
+    std::vector<std::string> files;
+    std::vector<uint32_t> columns[NUM_COLUMNS];
+    std::vector<uint8_t> ok;
+};
+
+static bool analyze(const char* path, World& world, uint32_t* row) {
+    MappedFile file;
+    Replay replay;
+    if (!file.open(path) || !decodeReplay(replay, file.data, file.size)) {
+        return false;
+    }
+    MatchStats stats;
+    if (!playReplay(replay, world, [&](const World& w) { stats.onTick(w); })) {
+        return false;
+    }
+    stats.onEnd(world);
+    std::copy(stats.row, stats.row + NUM_COLUMNS, row);
+    return true;
+}
+
+static void analyzeAll(Summary& summary, int threads) {
+    size_t n = summary.files.size();
+    for (auto& column : summary.columns) {
+        column.assign(n, 0);
+    }
+    summary.ok.assign(n, 0);
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        World world(SimConfig{}, 1, 0); // reused, every replay restores its own start
+        uint32_t row[NUM_COLUMNS];
+        for (size_t i = next++; i < n; i = next++) {
+            if (!analyze(summary.files[i].c_str(), world, row)) {
+                continue;
+            }
+            for (int c = 0; c < NUM_COLUMNS; c++) {
+                summary.columns[c][i] = row[c];
+            }
+            summary.ok[i] = 1;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+}
+
+static bool writeCsv(const char* path, const Summary& summary) {
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) {
+        return false;
+    }
+    fprintf(f, "file");
+    for (const char* name : COLUMN_NAMES) {
+        fprintf(f, ",%s", name);
+    }
+    fputc('\n', f);
+    for (size_t i = 0; i < summary.files.size(); i++) {
+        if (!summary.ok[i]) {
+            continue;
+        }
+        fprintf(f, "%s", summary.files[i].c_str());
+        for (const auto& column : summary.columns) {
+            fprintf(f, ",%u", column[i]);
+        }
+        fputc('\n', f);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool writeBinary(const char* path, const Summary& summary) {
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    uint32_t rows = std::count(summary.ok.begin(), summary.ok.end(), 1);
+    uint32_t header[] = {0x4d555352, NUM_COLUMNS, rows}; // "RSUM"
+    fwrite(header, sizeof(header), 1, f);
+    std::vector<uint32_t> values;
+    for (int c = 0; c < NUM_COLUMNS; c++) {
+        char name[32] = {};
+        strncpy(name, COLUMN_NAMES[c], sizeof(name) - 1);
+        fwrite(name, sizeof(name), 1, f);
+        values.clear();
+        for (size_t i = 0; i < summary.files.size(); i++) {
+            if (summary.ok[i]) {
+                values.push_back(summary.columns[c][i]);
+            }
+        }
+        fwrite(values.data(), sizeof(uint32_t), values.size(), f);
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+static uint64_t total(const Summary& summary, Column c) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < summary.files.size(); i++) {
+        sum += summary.ok[i] ? summary.columns[c][i] : 0;
+    }
+    return sum;
+}
+
+static double ratio(uint64_t a, uint64_t b) {
+    return b > 0 ? (double)a / b : 0.0;
+}
+
+static double minutesPlayed(const Summary& summary) {
+    double seconds = 0.0;
+    for (size_t i = 0; i < summary.files.size(); i++) {
+        if (summary.ok[i] && summary.columns[COL_TICK_RATE][i] > 0) {
+            seconds += (double)summary.columns[COL_TICKS][i] / summary.columns[COL_TICK_RATE][i];
+        }
+    }
+    return seconds / 60.0;
+}
+
+static void printTotals(const Summary& summary) {
+    printf("bullet hit rate %.3f (%llu / %llu)\n", ratio(total(summary, COL_BULLET_HITS), total(summary, COL_BULLETS_FIRED)),
+           (unsigned long long)total(summary, COL_BULLET_HITS), (unsigned long long)total(summary, COL_BULLETS_FIRED));
+    printf("laser hits per beam %.3f (%llu / %llu)\n", ratio(total(summary, COL_LASER_HITS), total(summary, COL_LASERS_FIRED)),
+           (unsigned long long)total(summary, COL_LASER_HITS), (unsigned long long)total(summary, COL_LASERS_FIRED));
+    printf("mine kills per mine placed %.3f, %.3f per explosion (%llu mines, %llu exploded)\n",
+           ratio(total(summary, COL_MINE_HITS), total(summary, COL_MINES_PLACED)),
+           ratio(total(summary, COL_MINE_HITS), total(summary, COL_MINES_EXPLODED)),
+           (unsigned long long)total(summary, COL_MINES_PLACED), (unsigned long long)total(summary, COL_MINES_EXPLODED));
+    double minutes = std::max(minutesPlayed(summary), 1e-9);
+    printf("per minute: %.2f merges, %.2f splits, %.2f pickups, %.2f deaths\n",
+           total(summary, COL_MERGES) / minutes, total(summary, COL_SPLITS) / minutes,
+           (total(summary, COL_PICKUPS_PLUS) + total(summary, COL_PICKUPS_LASER) + total(summary, COL_PICKUPS_MINE)) / minutes,
+           total(summary, COL_DEATHS) / minutes);
+    printf("time-to-kill %.1f ticks over %llu kills\n", ratio(total(summary, COL_KILL_TICKS), total(summary, COL_TIMED_KILLS)),
+           (unsigned long long)total(summary, COL_TIMED_KILLS));
+}
+
+static void addPath(const char* path, std::vector<std::string>& files) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(path, ec)) {
+        files.push_back(path);
+        return;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : fs::recursive_directory_iterator(path, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".replay") {
+            found.push_back(entry.path().string());
+        }
+    }
+    // directory order is arbitrary, keep the summary rows stable
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+}
+
+int main(int argc, char** argv) {
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    const char* csvPath = nullptr;
+    const char* binPath = nullptr;
+    Summary summary;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--csv") && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (!strcmp(argv[i], "--bin") && i + 1 < argc) {
+            binPath = argv[++i];
+        } else if (argv[i][0] != '-') {
+            addPath(argv[i], summary.files);
+        } else {
+            summary.files.clear();
+            break;
+        }
+    }
+    if (summary.files.empty()) {
+        fprintf(stderr, "usage: %s [--threads J] [--csv FILE] [--bin FILE] PATH...\n", argv[0]);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    analyzeAll(summary, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t analyzed = std::count(summary.ok.begin(), summary.ok.end(), 1);
+    for (size_t i = 0; i < summary.files.size(); i++) {
+        if (!summary.ok[i]) {
+            fprintf(stderr, "%s: not a replay of this build, skipped\n", summary.files[i].c_str());
+        }
+    }
+    printf("%zu matches, %.1f minutes of play, in %.3f s on %d threads: %.1f matches/s, %.0f ticks/s\n", analyzed,
+           minutesPlayed(summary), seconds, threads, analyzed / seconds, total(summary, COL_TICKS) / seconds);
+    printTotals(summary);
+
+    if (csvPath != nullptr && !writeCsv(csvPath, summary)) {
+        fprintf(stderr, "could not write %s\n", csvPath);
+        return 2;
+    }
+    if (binPath != nullptr && !writeBinary(binPath, summary)) {
+        fprintf(stderr, "could not write %s\n", binPath);
+        return 2;
+    }
+    return analyzed == summary.files.size() ? 0 : 1;
+}
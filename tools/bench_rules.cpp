@@ -0,0 +1,90 @@
+// Compares one simulation step with runtime-configured rules against the
+// compile-time tournament profile on the same scripted scenario.
+//   bench_rules [shipsPerPlayer] [ticks] [repetitions] [threads]
+// Both variants run alternately and the best time of each is reported.
+// With threads > 0 the runtime rules also run on a job system with that many
+// workers, which must end in the same state as the single-threaded runs.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "sim/world.h"
+#include "sim/systems.h"
+#include "sim/rules.h"
+#include "sim/hash.h"
+#include "sim/job_system.h"
+
+static World makeScenario(const SimConfig& config, int shipsPerPlayer) {
+    // each player fills a grid on its half of the arena, spaced so no two ships start in contact
+    World world(config, 2, 42);
+    const int columns = 12;
+    int rows = (shipsPerPlayer + columns - 1) / columns;
+    float columnStep = (config.w / 2.0f - config.spaceshipSize) / columns;
+    float rowStep = (config.h - config.spaceshipSize) / (float)rows;
+    for (int owner = 0; owner < 2; owner++) {
+        for (int i = 0; i < shipsPerPlayer; i++) {
+            float x = owner * config.w / 2.0f + config.spaceshipSize + (i % columns) * columnStep;
+            float y = config.spaceshipSize + (i / columns) * rowStep;
+            world.spawnShip(owner, Vector2(x, y));
+        }
+        world.activeShip[owner] = world.ships.id[owner * shipsPerPlayer];
+    }
+    return world;
+}
+
+template <class Rules>
+static double run(World& world, const Rules& rules, int ticks) {
+    const float deltaTime = world.config.tickDuration;
+    int tick = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (; tick < ticks && world.allPlayersAlive(); tick++) {
+        for (int owner = 0; owner < 2; owner++) {
+            world.rotate(owner, world.config.rotationSpeed * deltaTime);
+            if (tick % 7 == owner) {
+                world.rotateAndBoost(owner);
+            }
+            world.shoot(owner);
+            world.switchActiveSpaceship(owner);
+        }
+        simulate(world, rules);
+        world.events.clear();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / std::max(tick, 1);
+}
+
+int main(int argc, char* argv[]) {
+    int shipsPerPlayer = argc > 1 ? atoi(argv[1]) : 200;
+    int ticks = argc > 2 ? atoi(argv[2]) : 2000;
+    int repetitions = argc > 3 ? atoi(argv[3]) : 5;
+    int threads = argc > 4 ? atoi(argv[4]) : 0;
+    const SimConfig config = TournamentProfile::config();
+    JobSystem jobs(threads);
+
+    double runtimeNs = 1e300, staticNs = 1e300, parallelNs = 1e300;
+    bool identical = true;
+    for (int i = 0; i < repetitions; i++) {
+        World runtimeWorld = makeScenario(config, shipsPerPlayer);
+        runtimeNs = std::min(runtimeNs, run(runtimeWorld, ConfigRules{runtimeWorld.config}, ticks));
+
+        World staticWorld = makeScenario(config, shipsPerPlayer);
+        staticNs = std::min(staticNs, run(staticWorld, TournamentRules{}, ticks));
+        identical &= hashWorld(runtimeWorld) == hashWorld(staticWorld);
+
+        if (threads > 0) {
+            World parallelWorld = makeScenario(config, shipsPerPlayer);
+            parallelWorld.jobs = &jobs;
+            parallelNs = std::min(parallelNs, run(parallelWorld, ConfigRules{parallelWorld.config}, ticks));
+            identical &= hashWorld(runtimeWorld) == hashWorld(parallelWorld);
+        }
+    }
+
+    printf("%d ships per player, %d ticks\n", shipsPerPlayer, ticks);
+    printf("runtime config:       %10.0f ns/tick\n", runtimeNs);
+    printf("compile-time profile: %10.0f ns/tick (%.2fx)\n", staticNs, runtimeNs / staticNs);
+    if (threads > 0) {
+        printf("runtime, %2d workers:  %10.0f ns/tick (%.2fx)\n", threads, parallelNs, runtimeNs / parallelNs);
+    }
+    printf("identical end state:  %s\n", identical ? "yes" : "no");
+    return 0;
+}
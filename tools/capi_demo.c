@@ -0,0 +1,110 @@
+/*
+ * Drives matches through libspaceships from plain C, as embedding tools do:
+ *   capi_demo [--matches N]
+ * Plays each match with random buttons, checks that a snapshot taken half way
+ * and restored into a clone replays to the same hash, and prints the winners.
+ * Checks first that teams_alive reports teams rather than owners.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "capi/spaceships.h"
+
+#define PLAYERS 2
+#define CHUNK 60      /* ticks per ss_world_step */
+#define MAX_TICKS 18000
+
+static uint64_t next(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void randomInputs(uint8_t* inputs, uint64_t* rng) {
+    for (int i = 0; i < CHUNK * PLAYERS; i++) {
+        uint64_t r = next(rng) % 100;
+        inputs[i] = (r < 50 ? SS_INPUT_ROTATE : 0) | (r < 5 ? SS_INPUT_SHOOT : 0) | (r == 99 ? SS_INPUT_BOOST : 0)
+                    | (r == 98 ? SS_INPUT_SPLIT : 0) | (r == 97 ? SS_INPUT_SWITCH : 0);
+    }
+}
+
+int main(int argc, char** argv) {
+    int matches = argc == 3 && !strcmp(argv[1], "--matches") ? atoi(argv[2]) : 5;
+    if (ss_api_version() != SS_API_VERSION) {
+        fprintf(stderr, "libspaceships has API version %u, expected %d\n", ss_api_version(), SS_API_VERSION);
+        return 1;
+    }
+    ss_settings settings;
+    ss_default_settings(&settings);
+    uint8_t inputs[CHUNK * PLAYERS];
+    int failures = 0;
+
+    const int32_t teams[4] = {1, 1, 0, 0};
+    ss_world* teamWorld = ss_world_create(&settings, 4, teams, 1);
+    int32_t lowest;
+    int32_t teamsAlive = ss_world_teams_alive(teamWorld, &lowest);
+    if (teamsAlive != 2 || lowest != 0) {
+        fprintf(stderr, "teams {1, 1, 0, 0}: %d teams alive, lowest %d, expected 2 and 0\n", teamsAlive, lowest);
+        failures++;
+    }
+    ss_world_destroy(teamWorld);
+
+    for (int m = 0; m < matches; m++) {
+        ss_world* world = ss_world_create(&settings, PLAYERS, NULL, 1000 + m);
+        uint64_t rng = 0x9e3779b97f4a7c15ull + m;
+        uint8_t* saved = NULL;
+        size_t savedSize = 0;
+        uint64_t savedRng = 0;
+        uint64_t hits = 0;
+        while (ss_world_teams_alive(world, NULL) > 1 && ss_world_tick(world) < MAX_TICKS) {
+            if (saved == NULL && ss_world_tick(world) >= 600) {
+                savedSize = ss_world_snapshot(world, NULL, 0);
+                saved = malloc(savedSize);
+                ss_world_snapshot(world, saved, savedSize);
+                savedRng = rng;
+            }
+            randomInputs(inputs, &rng);
+            ss_world_step(world, inputs, CHUNK);
+            size_t count;
+            const ss_event* events = ss_world_events(world, &count);
+            for (size_t i = 0; i < count; i++) {
+                hits += events[i].type == SS_EVENT_SHIP_HIT;
+            }
+        }
+
+        /* the second half again on a clone restored from the snapshot */
+        int32_t winner;
+        int alive = ss_world_teams_alive(world, &winner);
+        uint32_t ticks = ss_world_tick(world);
+        if (saved != NULL) {
+            ss_world* replay = ss_world_clone(world);
+            if (ss_world_restore(replay, saved, savedSize) != SS_RESTORE_OK) {
+                fprintf(stderr, "match %d: snapshot rejected\n", m);
+                failures++;
+            } else {
+                rng = savedRng;
+                while (ss_world_tick(replay) < ticks) {
+                    randomInputs(inputs, &rng);
+                    ss_world_step(replay, inputs, CHUNK);
+                }
+                if (ss_world_hash(replay) != ss_world_hash(world)) {
+                    fprintf(stderr, "match %d: replay from the snapshot diverged\n", m);
+                    failures++;
+                }
+            }
+            ss_world_destroy(replay);
+            free(saved);
+        }
+        ss_ships_view ships = ss_world_ships(world);
+        int value = 0;
+        for (size_t i = 0; i < ships.count; i++) {
+            value += ships.value[i];
+        }
+        printf("match %d: %u ticks, %s, %llu hits, %d value left in %zu spaceships\n", m, ticks,
+               alive == 1 ? (winner == 0 ? "player 1 wins" : "player 2 wins") : "no winner",
+               (unsigned long long)hits, value, ships.count);
+        ss_world_destroy(world);
+    }
+    return failures > 0;
+}
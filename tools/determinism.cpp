@@ -0,0 +1,313 @@
+// Determinism harness: plays scripted matches and checks that the same seed and
+// inputs always produce the same world, over repeated runs, over thread counts,
+// after a snapshot save/restore halfway, when played back from its encoded
+// replay with seeks back and forth, and (with --trace / --compare) between
+// builds with different compiler flags.
+//   determinism [--seeds N] [--ticks T] [--interval K] [--threads J] [--trace FILE]
+//   determinism --compare FILE FILE
+// The world is hashed every K ticks. On a mismatch the first differing check
+// tick is reported along with the first entity whose hash differs there.
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim/world.h"
+#include "sim/rules.h"
+#include "sim/hash.h"
+#include "sim/snapshot.h"
+#include "sim/replay.h"
+
+struct Check {
+    uint32_t tick;
+    uint64_t hash;
+    std::vector<EntityHash> entities;
+};
+
+struct Trace {
+    uint64_t seed;
+    std::vector<Check> checks;
+};
+
+static uint8_t scriptedInput(Rng& rng) {
+    uint32_t r = rng.below(1000);
+    uint8_t buttons = rng.below(2) ? INPUT_ROTATE : 0;
+    if (r < 30) buttons |= INPUT_BOOST;
+    else if (r < 80) buttons |= INPUT_SHOOT;
+    else if (r < 90) buttons |= INPUT_SPLIT;
+    else if (r < 100) buttons |= INPUT_SWITCH;
+    return buttons;
+}
+
+static void addCheck(Trace& trace, const World& world) {
+    trace.checks.push_back({world.tick, world.stateHash, {}});
+    hashEntities(world, trace.checks.back().entities);
+}
+
+// With restoreAt > 0 the match is saved to a snapshot at that tick and
+// continues in a fresh world restored from it. With record set, the inputs
+// are recorded into it.
+static Trace play(const SimConfig& config, uint64_t seed, uint32_t ticks, uint32_t interval, uint32_t restoreAt = 0,
+                  Replay* record = nullptr) {
+    World world(config, 2, seed);
+    world.spawnPlayer(0);
+    world.spawnPlayer(1);
+    world.hashInterval = interval;
+    Rng script = world.rngStream(RNG_STREAM_SCRIPT);
+    if (record != nullptr) {
+        record->begin(world);
+    }
+
+    Trace trace{seed, {}};
+    for (uint32_t t = 0; t < ticks; t++) {
+        if (restoreAt != 0 && t == restoreAt) {
+            std::vector<uint8_t> snapshot;
+            saveSnapshot(world, snapshot);
+            World restored(config, 1, 0);
+            if (!loadSnapshot(restored, snapshot.data(), snapshot.size())) {
+                printf("seed %" PRIu64 ": snapshot at tick %u could not be restored\n", seed, t);
+                return trace;
+            }
+            world = std::move(restored);
+        }
+        uint8_t buttons[2];
+        for (int owner = 0; owner < world.numPlayers(); owner++) {
+            buttons[owner] = scriptedInput(script);
+            world.applyInput(owner, buttons[owner]);
+        }
+        if (record != nullptr) {
+            record->record(buttons);
+        }
+        world.step();
+        world.events.clear();
+        if (world.tick % interval == 0) {
+            addCheck(trace, world);
+        }
+    }
+    return trace;
+}
+
+// Records the match, encodes and decodes the replay, then plays it back
+// from the start after seeking around, with a jump forward and back halfway.
+static Trace replayed(const SimConfig& config, uint64_t seed, uint32_t ticks, uint32_t interval) {
+    Replay recorded, decoded;
+    play(config, seed, ticks, interval, 0, &recorded);
+    std::vector<uint8_t> data;
+    encodeReplay(recorded, data);
+    ReplayPlayer player;
+    Trace trace{seed, {}};
+    if (!decodeReplay(decoded, data.data(), data.size()) || !player.open(decoded, interval * 7)) {
+        printf("seed %" PRIu64 ": replay could not be played back\n", seed);
+        return trace;
+    }
+    player.seek(ticks * 3 / 4);
+    player.seek(0);
+    for (uint32_t t = 0; t < ticks; t++) {
+        if (t == ticks / 2) {
+            player.seek(ticks * 3 / 4);
+            player.seek(t);
+        }
+        player.stepForward();
+        if (player.world.tick % interval == 0) {
+            addCheck(trace, player.world);
+        }
+    }
+    return trace;
+}
+
+static const char* tableName(char table) {
+    switch (table) {
+        case 'S': return "ship";
+        case 'B': return "bullet";
+        case 'L': return "laser";
+        case 'M': return "mine";
+        case 'P': return "powerup";
+        default: return "entity";
+    }
+}
+
+static void reportEntity(const std::vector<EntityHash>& a, const std::vector<EntityHash>& b) {
+    size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; i++) {
+        if (a[i].table != b[i].table || a[i].id != b[i].id) {
+            printf("  %s %d exists on one side only\n", tableName(a[i].table), a[i].id);
+            return;
+        }
+        if (a[i].hash != b[i].hash) {
+            printf("  first differing entity: %s %d\n", tableName(a[i].table), a[i].id);
+            return;
+        }
+    }
+    if (a.size() != b.size()) {
+        const EntityHash& extra = a.size() > n ? a[n] : b[n];
+        printf("  %s %d exists on one side only\n", tableName(extra.table), extra.id);
+        return;
+    }
+    printf("  every entity matches, the difference is in world-level state (rng, timers, active ships)\n");
+}
+
+// prints the first divergence and returns false, true if both traces agree
+static bool compare(const Trace& a, const Trace& b, const char* what) {
+    uint32_t lastMatch = 0;
+    size_t n = std::min(a.checks.size(), b.checks.size());
+    for (size_t i = 0; i < n; i++) {
+        const Check& ca = a.checks[i];
+        const Check& cb = b.checks[i];
+        if (ca.tick == cb.tick && ca.hash == cb.hash) {
+            lastMatch = ca.tick;
+            continue;
+        }
+        printf("seed %" PRIu64 ": %s diverged at tick %u (last identical check at tick %u)\n", a.seed, what, ca.tick, lastMatch);
+        reportEntity(ca.entities, cb.entities);
+        return false;
+    }
+    if (a.checks.size() != b.checks.size()) {
+        printf("seed %" PRIu64 ": %s traces have %zu and %zu checks\n", a.seed, what, a.checks.size(), b.checks.size());
+        return false;
+    }
+    return true;
+}
+
+static std::vector<Trace> playAll(const SimConfig& config, const std::vector<uint64_t>& seeds, uint32_t ticks, uint32_t interval, int threads) {
+    std::vector<Trace> traces(seeds.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < seeds.size(); i = next++) {
+            traces[i] = play(config, seeds[i], ticks, interval);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    return traces;
+}
+
+// one line per check: tick hash count then table:id:hash for every entity
+static bool writeTraces(const char* path, const std::vector<Trace>& traces) {
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) {
+        return false;
+    }
+    for (const Trace& trace : traces) {
+        fprintf(f, "seed %" PRIu64 " %zu\n", trace.seed, trace.checks.size());
+        for (const Check& check : trace.checks) {
+            fprintf(f, "%u %016" PRIx64 " %zu", check.tick, check.hash, check.entities.size());
+            for (const EntityHash& e : check.entities) {
+                fprintf(f, " %c:%d:%016" PRIx64, e.table, e.id, e.hash);
+            }
+            fputc('\n', f);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool readTraces(const char* path, std::vector<Trace>& traces) {
+    FILE* f = fopen(path, "r");
+    if (f == nullptr) {
+        return false;
+    }
+    Trace trace;
+    size_t numChecks;
+    while (fscanf(f, " seed %" SCNu64 " %zu", &trace.seed, &numChecks) == 2) {
+        trace.checks.resize(numChecks);
+        for (Check& check : trace.checks) {
+            size_t numEntities;
+            if (fscanf(f, "%u %" SCNx64 " %zu", &check.tick, &check.hash, &numEntities) != 3) {
+                fclose(f);
+                return false;
+            }
+            check.entities.resize(numEntities);
+            for (EntityHash& e : check.entities) {
+                if (fscanf(f, " %c:%d:%" SCNx64, &e.table, &e.id, &e.hash) != 3) {
+                    fclose(f);
+                    return false;
+                }
+            }
+        }
+        traces.push_back(trace);
+    }
+    fclose(f);
+    return true;
+}
+
+static int compareFiles(const char* pathA, const char* pathB) {
+    std::vector<Trace> a, b;
+    if (!readTraces(pathA, a) || !readTraces(pathB, b)) {
+        fprintf(stderr, "could not read %s or %s\n", pathA, pathB);
+        return 2;
+    }
+    std::string what = std::string(pathA) + " vs " + pathB;
+    bool same = a.size() == b.size();
+    for (size_t i = 0; i < std::min(a.size(), b.size()); i++) {
+        same &= compare(a[i], b[i], what.c_str());
+    }
+    printf("%s: %s\n", what.c_str(), same ? "identical" : "DIVERGED");
+    return same ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    int numSeeds = 8;
+    uint32_t ticks = 3600, interval = 10;
+    int threads = std::max(2u, std::thread::hardware_concurrency());
+    const char* tracePath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--compare") && i + 2 < argc) {
+            return compareFiles(argv[i + 1], argv[i + 2]);
+        } else if (!strcmp(argv[i], "--seeds") && i + 1 < argc) {
+            numSeeds = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--ticks") && i + 1 < argc) {
+            ticks = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--interval") && i + 1 < argc) {
+            interval = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--seeds N] [--ticks T] [--interval K] [--threads J] [--trace FILE]\n"
+                            "       %s --compare FILE FILE\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    const SimConfig config = TournamentProfile::config();
+    std::vector<uint64_t> seeds;
+    for (int i = 0; i < numSeeds; i++) {
+        seeds.push_back(1000 + i);
+    }
+
+    std::vector<Trace> reference = playAll(config, seeds, ticks, interval, 1);
+    std::vector<Trace> rerun = playAll(config, seeds, ticks, interval, 1);
+    std::vector<Trace> threaded = playAll(config, seeds, ticks, interval, threads);
+    std::vector<Trace> restored, replays;
+    for (uint64_t seed : seeds) {
+        restored.push_back(play(config, seed, ticks, interval, ticks / 2));
+        replays.push_back(replayed(config, seed, ticks, interval));
+    }
+
+    bool same = true;
+    std::string threadsLabel = "run on " + std::to_string(threads) + " threads";
+    for (size_t i = 0; i < seeds.size(); i++) {
+        same &= compare(reference[i], rerun[i], "repeated run");
+        same &= compare(reference[i], threaded[i], threadsLabel.c_str());
+        same &= compare(reference[i], restored[i], "run restored from a snapshot");
+        same &= compare(reference[i], replays[i], "replay played back with seeks");
+    }
+    printf("%d seeds x %u ticks, hashed every %u ticks: %s\n", numSeeds, ticks, interval, same ? "deterministic" : "DIVERGED");
+
+    if (tracePath != nullptr && !writeTraces(tracePath, reference)) {
+        fprintf(stderr, "could not write %s\n", tracePath);
+        return 2;
+    }
+    return same ? 0 : 1;
+}
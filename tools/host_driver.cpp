@@ -0,0 +1,119 @@
+// Local driver for the match host: keeps adding matches with scripted inputs
+// until --matches are running or the host refuses more, replaces the matches
+// that end, and reports tick lateness and how many matches were turned away.
+// Fails if the host ever holds more than --matches, finished ones included.
+// --arena shrinks the arena to PX by PX with one spaceship each, so matches
+// end within a few ticks and get replaced all the time.
+//   host_driver [--matches N] [--threads J] [--seconds T] [--seed S] [--max-load L] [--arena PX]
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "server/match_host.h"
+#include "sim/rules.h"
+
+// buttons held for a few ticks at a time, roughly like a human player
+static InputSource scriptedInputs(uint64_t seed) {
+    Rng rng(seed, RNG_STREAM_SCRIPT);
+    std::vector<uint8_t> held;
+    return [rng, held](const World& world, uint8_t* buttons) mutable {
+        held.resize(world.numPlayers(), 0);
+        for (int owner = 0; owner < world.numPlayers(); owner++) {
+            if (rng.below(20) == 0) {
+                held[owner] ^= INPUT_ROTATE;
+            }
+            buttons[owner] = held[owner];
+            if (rng.below(30) == 0) {
+                buttons[owner] |= 1 << (1 + rng.below(4));
+            }
+        }
+    };
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+int main(int argc, char** argv) {
+    int target = 200;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    double seconds = 10.0;
+    uint64_t seed = 1;
+    HostLimits limits{0, 0.85f, 2.0f};
+    int arena = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--matches") && i + 1 < argc) {
+            target = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--max-load") && i + 1 < argc) {
+            limits.maxLoad = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--arena") && i + 1 < argc) {
+            arena = std::max(0, atoi(argv[++i]));
+        } else {
+            fprintf(stderr, "usage: %s [--matches N] [--threads J] [--seconds T] [--seed S] [--max-load L] [--arena PX]\n", argv[0]);
+            return 2;
+        }
+    }
+    limits.maxMatches = target;
+
+    SimConfig config = TournamentProfile::config();
+    if (arena > 0) {
+        config.w = config.h = arena;
+        config.numStartSpaceships = 1;
+        config.finalize();
+    }
+    MatchHost host(threads, limits);
+    // a few matches per slice, so the load measurement catches up before the next ones
+    const double slice = 0.1;
+    const int perSlice = std::max(8, target / 20);
+    int started = 0, peak = 0, hosted = 0;
+    std::vector<MatchReport> reports;
+    for (double t = 0.0; t < seconds; t += slice) {
+        for (int i = 0; i < perSlice && host.activeMatches() < target; i++) {
+            if (host.addMatch(config, 2, seed + started, scriptedInputs(seed + started)) < 0) {
+                break;
+            }
+            started++;
+        }
+        peak = std::max(peak, host.activeMatches());
+        hosted = std::max(hosted, host.hostedMatches());
+        host.run(slice);
+        hosted = std::max(hosted, host.hostedMatches());
+        std::vector<MatchReport> finished = host.takeFinished();
+        reports.insert(reports.end(), finished.begin(), finished.end());
+    }
+    const size_t numFinished = reports.size();
+    std::vector<MatchReport> running = host.report();
+    reports.insert(reports.end(), running.begin(), running.end());
+    std::vector<double> meanLate, maxLate;
+    uint64_t ticks = 0, lateTicks = 0;
+    for (const MatchReport& r : reports) {
+        meanLate.push_back(r.meanLateness * 1000.0);
+        maxLate.push_back(r.maxLateness * 1000.0);
+        ticks += r.ticks;
+        lateTicks += r.lateTicks;
+    }
+    printf("%d matches started (peak %d at once, %d refused) on %d threads over %.1f s\n", started, peak, host.refusedMatches(), threads, seconds);
+    printf("%" PRIu64 " ticks, %.0f ticks/s, last load %.2f\n", ticks, ticks / seconds, host.load());
+    printf("tick lateness per match, mean: p50 %.3f ms, p99 %.3f ms; worst: p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           percentile(meanLate, 0.5), percentile(meanLate, 0.99), percentile(maxLate, 0.5), percentile(maxLate, 0.99), percentile(maxLate, 1.0));
+    printf("%" PRIu64 " ticks (%.3f%%) started more than a tick late\n", lateTicks, ticks > 0 ? 100.0 * lateTicks / ticks : 0.0);
+    printf("%zu matches finished, at most %d hosted at once\n", numFinished, hosted);
+    if (hosted > target) {
+        fprintf(stderr, "the host kept %d matches for a limit of %d\n", hosted, target);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+// One side of an online match with scripted inputs, run two of them to test
+// the rollback netcode over loopback:
+//   net_peer --player 0 --port 7000 [options]
+//   net_peer --player 1 --port 7001 --peer 127.0.0.1:7000 [options]
+// Options: --seed N (player 0), --ticks N, --delay TICKS, --prediction TICKS,
+// and the simulated network --latency MS, --jitter MS, --loss PERCENT.
+// Both scripts derive from the seed, so every peer also plays the match
+// offline at the end and checks that the online run arrived at the same state.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "net/rollback.h"
+#include "sim/rules.h"
+#include "sim/hash.h"
+
+using Clock = std::chrono::steady_clock;
+
+static uint8_t scriptedInput(Rng& rng) {
+    uint32_t r = rng.below(1000);
+    uint8_t buttons = rng.below(2) ? INPUT_ROTATE : 0;
+    if (r < 30) buttons |= INPUT_BOOST;
+    else if (r < 80) buttons |= INPUT_SHOOT;
+    else if (r < 90) buttons |= INPUT_SPLIT;
+    else if (r < 100) buttons |= INPUT_SWITCH;
+    return buttons;
+}
+
+static Rng script(uint64_t seed, int player) {
+    return Rng(seed + player, RNG_STREAM_SCRIPT);
+}
+
+static World newMatch(const SimConfig& config, uint64_t seed) {
+    World world(config, 2, seed);
+    world.spawnPlayer(0);
+    world.spawnPlayer(1);
+    return world;
+}
+
+// the match without any network, every input lands on the tick it was meant for
+static uint64_t playOffline(const SimConfig& config, uint64_t seed, uint32_t ticks, uint32_t inputDelay) {
+    World world = newMatch(config, seed);
+    Rng scripts[] = {script(seed, 0), script(seed, 1)};
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        for (int owner = 0; owner < 2; owner++) {
+            world.applyInput(owner, tick < inputDelay ? 0 : scriptedInput(scripts[owner]));
+        }
+        world.step();
+    }
+    return hashWorld(world);
+}
+
+int main(int argc, char** argv) {
+    int player = 0;
+    int port = -1;
+    const char* peerName = nullptr;
+    uint64_t seed = 1;
+    uint32_t ticks = 1200;
+    RollbackConfig rollback = DEFAULT_ROLLBACK;
+    NetConditions conditions = {0.0f, 0.0f, 0.0f};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--player")) {
+            player = atoi(argv[i + 1]) == 1;
+        } else if (!strcmp(argv[i], "--port")) {
+            port = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--peer")) {
+            peerName = argv[i + 1];
+        } else if (!strcmp(argv[i], "--seed")) {
+            seed = strtoull(argv[i + 1], nullptr, 10);
+        } else if (!strcmp(argv[i], "--ticks")) {
+            ticks = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--delay")) {
+            rollback.inputDelay = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--prediction")) {
+            rollback.maxPrediction = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--latency")) {
+            conditions.latency = atof(argv[i + 1]) / 1000.0f;
+        } else if (!strcmp(argv[i], "--jitter")) {
+            conditions.jitter = atof(argv[i + 1]) / 1000.0f;
+        } else if (!strcmp(argv[i], "--loss")) {
+            conditions.loss = atof(argv[i + 1]) / 100.0f;
+        }
+    }
+
+    NetAddress peer = {0, 0};
+    if (player == 1 && (peerName == nullptr || !NetAddress::parse(peerName, peer))) {
+        fprintf(stderr, "player 1 needs --peer HOST:PORT of player 0\n");
+        return 2;
+    }
+    UdpSocket socket;
+    if (!socket.open(port >= 0 ? port : 7000 + player)) {
+        fprintf(stderr, "cannot open UDP port %d\n", port >= 0 ? port : 7000 + player);
+        return 2;
+    }
+    socket.simulate(conditions, 0x5eed + player);
+    if (!connectPeer(socket, player, peer, seed, 30.0f)) {
+        fprintf(stderr, "player %d: no peer within 30 s\n", player);
+        return 1;
+    }
+
+    const SimConfig config = TournamentProfile::config();
+    World world = newMatch(config, seed);
+    RollbackSession session(world, socket, peer, player, seed, rollback);
+    Rng inputs = script(seed, player);
+
+    // real time at the tick rate, until every tick is confirmed on this side
+    Clock::time_point start = Clock::now();
+    Clock::time_point nextTick = start;
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(config.tickDuration));
+    while (session.confirmedFrame() < ticks && !session.disconnected() && !session.desynced()) {
+        session.poll();
+        if (session.frame() < ticks && session.readyToAdvance()) {
+            session.advance(scriptedInput(inputs));
+        }
+        nextTick += tickDuration;
+        std::this_thread::sleep_until(nextTick);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t online = hashWorld(world);
+    // keep answering for a moment, the peer may still miss our last inputs
+    for (Clock::time_point until = Clock::now() + std::chrono::seconds(1); Clock::now() < until;) {
+        session.poll();
+        std::this_thread::sleep_for(tickDuration);
+    }
+
+    const RollbackStats& stats = session.stats();
+    printf("player %d: %u ticks in %.1f s, state %016llx\n", player, session.frame(), seconds, (unsigned long long)online);
+    printf("  rollbacks %u, %.1f ticks on average, longest %u, %u ticks stalled\n", stats.rollbacks,
+           stats.rollbacks > 0 ? (double)stats.resimulated / stats.rollbacks : 0.0, stats.maxRollback, stats.stalls);
+    printf("  save %.2f us, restore %.2f us\n", stats.saveNanos / 1000.0 / std::max(stats.saves, 1u),
+           stats.restoreNanos / 1000.0 / std::max(stats.restores, 1u));
+    if (session.disconnected()) {
+        printf("  peer disconnected\n");
+        return 1;
+    }
+    if (session.desynced()) {
+        printf("  desync at tick %u\n", session.desyncedAt());
+        return 1;
+    }
+    bool same = online == playOffline(config, seed, ticks, std::min(rollback.inputDelay, 8u));
+    printf("  same state as offline: %s\n", same ? "yes" : "no");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// Dedicated server and clients with scripted inputs, to measure the snapshot
+// stream over loopback:
+//   net_state --server PORT [--bullets N] [--seconds S]
+//   net_state --client HOST:PORT [--seconds S]
+// Both take the simulated network --latency MS, --jitter MS and --loss PERCENT.
+// The server keeps at least N bullets in the arena, and the spaceships healed
+// so the filler does not end the match right away. Both sides report what went
+// over the wire per second, the server also the time spent per tick in the
+// simulation and on the network.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "net/state_server.h"
+#include "net/state_client.h"
+#include "sim/rules.h"
+
+using Clock = std::chrono::steady_clock;
+
+static uint8_t scriptedInput(Rng& rng) {
+    uint32_t r = rng.below(1000);
+    uint8_t buttons = rng.below(2) ? INPUT_ROTATE : 0;
+    if (r < 30) buttons |= INPUT_BOOST;
+    else if (r < 80) buttons |= INPUT_SHOOT;
+    else if (r < 90) buttons |= INPUT_SPLIT;
+    else if (r < 100) buttons |= INPUT_SWITCH;
+    return buttons;
+}
+
+static World newMatch(const SimConfig& config, uint64_t seed) {
+    World world(config, 2, seed);
+    world.spawnPlayer(0);
+    world.spawnPlayer(1);
+    return world;
+}
+
+const int FILLER_SHIP_VALUE = 20;
+
+// bullets fired from random points of the arena, like World::shoot does
+static void topUpBullets(World& world, size_t count, Rng& rng) {
+    BulletTable& bullets = world.bullets;
+    while (bullets.size() < count) {
+        int id = world.nextId++;
+        Vector2 pos(world.config.bulletMinX + rng.below(world.config.w - 2 * (int)world.config.bulletMinX),
+                    world.config.bulletMinY + rng.below(world.config.h - 2 * (int)world.config.bulletMinY));
+        bullets.id.push_back(id);
+        bullets.owner.push_back(id % 2);
+        bullets.pos.push_back(pos);
+        bullets.prevPos.push_back(pos);
+        bullets.angle.push_back((float)rng.below(360));
+        bullets.speed.push_back(world.config.bulletSpeed);
+        bullets.expiresAt.push_back(world.tick + world.config.bulletLifeTicks);
+        bullets.eol.push_back(false);
+        world.timers.schedule(bullets.expiresAt.back(), TimerKind::BULLET_EXPIRE, id);
+    }
+    for (int& value : world.ships.value) {
+        value = std::max(value, FILLER_SHIP_VALUE);
+    }
+}
+
+static int runServer(int port, size_t bulletCount, float seconds, const NetConditions& conditions) {
+    UdpSocket socket;
+    if (!socket.open(port)) {
+        fprintf(stderr, "cannot open UDP port %d\n", port);
+        return 2;
+    }
+    socket.simulate(conditions, 0x5eed);
+    const SimConfig config = TournamentProfile::config();
+    uint64_t seed = 1;
+    World world = newMatch(config, seed);
+    StateServer server(world, socket);
+    Rng scripts[] = {Rng(seed, RNG_STREAM_SCRIPT), Rng(seed + 1, RNG_STREAM_SCRIPT)};
+    Rng filler(seed + 2, RNG_STREAM_SCRIPT);
+
+    // the clock starts with the first client
+    while (server.clients() == 0) {
+        server.poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const uint32_t ticks = config.ticks(seconds);
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(config.tickDuration));
+    uint64_t simNanos = 0;
+    uint32_t matches = 1;
+    size_t peakClients = 0;
+    Clock::time_point nextTick = Clock::now();
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        server.poll();
+        peakClients = std::max(peakClients, server.clients());
+        Clock::time_point start = Clock::now();
+        if (!world.hasSpaceship(0) || !world.hasSpaceship(1)) {
+            world = newMatch(config, seed + matches++);
+        }
+        if (bulletCount > 0) {
+            topUpBullets(world, bulletCount, filler);
+        }
+        for (int owner = 0; owner < 2; owner++) {
+            uint8_t scripted = scriptedInput(scripts[owner]);
+            world.applyInput(owner, server.controlled(owner) ? server.takeInput(owner) : scripted);
+        }
+        world.step();
+        world.events.clear();
+        simNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        server.sendSnapshots();
+        nextTick += tickDuration;
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    const StateServerStats& stats = server.stats();
+    printf("server: %u ticks, %zu bullets, %u matches, %zu clients\n", ticks, world.bullets.size(), matches, peakClients);
+    printf("  simulation %.1f us per tick, network %.1f us per tick\n", simNanos / 1000.0 / ticks, stats.netNanos / 1000.0 / ticks);
+    printf("  %u snapshots, %u without baseline, %.0f bytes on average, %.0f bytes/s per client\n", stats.snapshots,
+           stats.fullSnapshots, (double)stats.bytesSent / std::max(stats.snapshots, 1u),
+           stats.bytesSent / seconds / std::max(peakClients, (size_t)1));
+    return 0;
+}
+
+static int runClient(const char* address, float seconds, const NetConditions& conditions) {
+    NetAddress server;
+    if (!NetAddress::parse(address, server)) {
+        fprintf(stderr, "cannot resolve %s\n", address);
+        return 2;
+    }
+    UdpSocket socket;
+    if (!socket.open(0)) {
+        fprintf(stderr, "cannot open a UDP socket\n");
+        return 2;
+    }
+    socket.simulate(conditions, socket.localPort());
+    StateClient client(socket, server);
+    if (!client.connect(30.0f)) {
+        fprintf(stderr, "no server at %s within 30 s\n", address);
+        return 1;
+    }
+
+    // what a window would do every tick: send the buttons, draw the interpolated state
+    const SimConfig config = TournamentProfile::config();
+    World view(config, client.numPlayers(), 0);
+    Rng inputs(client.owner() + 100, RNG_STREAM_SCRIPT);
+    StateFrame frame;
+    size_t mostEntities = 0;
+    const uint32_t ticks = config.ticks(seconds);
+    const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(config.tickDuration));
+    Clock::time_point nextTick = Clock::now();
+    for (uint32_t tick = 0; tick < ticks && !client.disconnected(); tick++) {
+        client.sendInput(client.owner() >= 0 ? scriptedInput(inputs) : 0);
+        client.poll();
+        client.advance(config.tickDuration, config.tickRate);
+        if (client.sample(frame)) {
+            buildView(frame, view);
+            mostEntities = std::max(mostEntities, frame.entities.size());
+        }
+        nextTick += tickDuration;
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    const StateClientStats& stats = client.stats();
+    printf("client %d: %.0f bytes/s, %.1f snapshots/s, %u dropped, up to %zu entities drawn\n", client.owner(),
+           stats.bytesReceived / seconds, stats.snapshots / seconds, stats.dropped, mostEntities);
+    return client.disconnected() ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    int port = -1;
+    const char* address = nullptr;
+    size_t bullets = 0;
+    float seconds = 10.0f;
+    NetConditions conditions = {0.0f, 0.0f, 0.0f};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--server")) {
+            port = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--client")) {
+            address = argv[i + 1];
+        } else if (!strcmp(argv[i], "--bullets")) {
+            bullets = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--seconds")) {
+            seconds = atof(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--latency")) {
+            conditions.latency = atof(argv[i + 1]) / 1000.0f;
+        } else if (!strcmp(argv[i], "--jitter")) {
+            conditions.jitter = atof(argv[i + 1]) / 1000.0f;
+        } else if (!strcmp(argv[i], "--loss")) {
+            conditions.loss = atof(argv[i + 1]) / 100.0f;
+        }
+    }
+    if (port > 0) {
+        return runServer(port, bullets, seconds, conditions);
+    }
+    if (address != nullptr) {
+        return runClient(address, seconds, conditions);
+    }
+    fprintf(stderr, "usage: %s --server PORT [--bullets N] [--seconds S] | --client HOST:PORT [--seconds S] "
+                    "[--latency MS] [--jitter MS] [--loss PERCENT]\n", argv[0]);
+    return 2;
+}
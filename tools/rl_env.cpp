@@ -0,0 +1,128 @@
+// Steps a batch of environments with random actions and reports the env
+// steps per second:
+//   rl_env [--envs B] [--players N] [--teams K] [--threads T] [--seconds S] [--grid RES] [--arena PX]
+// An env step is one tick of one world, every agent of it acting. --grid
+// renders a RES x RES observation grid of half the arena per agent as well,
+// --teams puts neighbouring players in K teams, --arena shrinks the arena to
+// PX by PX with one spaceship each so episodes end within a few ticks. Fails
+// if the agents of the teams that won were not rewarded above the others on
+// average.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "rl/vec_env.h"
+#include "sim/rules.h"
+
+int main(int argc, char** argv) {
+    VecEnvConfig config = {TournamentProfile::config(), 256, 2, 0, 60.0f, (int)std::max(1u, std::thread::hardware_concurrency()),
+                            {0, 0.0f, false}};
+    float seconds = 5.0f;
+    int arena = 0;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            fprintf(stderr, "usage: %s [--envs B] [--players N] [--teams K] [--threads T] [--seconds S] [--grid RES] [--arena PX]\n", argv[0]);
+            return 2;
+        } else if (!strcmp(argv[i], "--envs")) {
+            config.numEnvs = std::max(1, atoi(argv[i + 1]));
+        } else if (!strcmp(argv[i], "--players")) {
+            config.numPlayers = std::clamp(atoi(argv[i + 1]), 2, RL_MAX_PLAYERS);
+        } else if (!strcmp(argv[i], "--teams")) {
+            config.numTeams = std::max(0, atoi(argv[i + 1]));
+        } else if (!strcmp(argv[i], "--threads")) {
+            config.numThreads = std::max(1, atoi(argv[i + 1]));
+        } else if (!strcmp(argv[i], "--seconds")) {
+            seconds = atof(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--grid")) {
+            config.grid.resolution = std::max(0, atoi(argv[i + 1]));
+        } else if (!strcmp(argv[i], "--arena")) {
+            arena = std::max(0, atoi(argv[i + 1]));
+        } else {
+            fprintf(stderr, "usage: %s [--envs B] [--players N] [--teams K] [--threads T] [--seconds S] [--grid RES] [--arena PX]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (arena > 0) {
+        config.sim.w = config.sim.h = arena;
+        config.sim.numStartSpaceships = 1;
+        config.sim.finalize();
+    }
+    config.grid.viewSize = config.sim.w / 2.0f;
+    config.grid.rotate = true;
+    VecEnv env(config);
+    std::vector<float> observations((size_t)env.numAgents() * OBSERVATION_SIZE);
+    std::vector<float> rewards(env.numAgents());
+    std::vector<uint8_t> dones(env.numEnvs());
+    std::vector<uint64_t> seeds(env.numEnvs());
+    for (int i = 0; i < env.numEnvs(); i++) {
+        seeds[i] = i + 1;
+    }
+    std::vector<float> grids((size_t)env.numAgents() * gridSize(config.grid));
+    env.bind(observations.data(), rewards.data(), dones.data());
+    env.bindGrids(grids.data());
+    env.reset(seeds.data());
+
+    // a random policy that shoots more than it does anything else
+    Rng rng(1, RNG_STREAM_SCRIPT);
+    std::vector<uint8_t> actions(env.numAgents());
+    uint64_t episodes = 0;
+    double rewardSum = 0.0;
+    // rewards of the last step of episodes won by a team, of its agents and of the others
+    double winnerReward = 0.0, loserReward = 0.0;
+    uint64_t winnerSteps = 0, loserSteps = 0;
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    while (elapsed < seconds) {
+        for (uint8_t& action : actions) {
+            uint32_t r = rng.below(16);
+            action = r < 6 ? (uint8_t)r : (uint8_t)(r < 10 ? ACTION_SHOOT : ACTION_ROTATE);
+        }
+        env.step(actions.data());
+        for (int i = 0; i < env.numEnvs(); i++) {
+            episodes += dones[i] != DONE_NONE;
+            if (dones[i] == DONE_TERMINATED && env.winner(i) >= 0) {
+                for (int owner = 0; owner < config.numPlayers; owner++) {
+                    float reward = rewards[i * config.numPlayers + owner];
+                    if (env.world(i).team[owner] == env.winner(i)) {
+                        winnerReward += reward;
+                        winnerSteps++;
+                    } else {
+                        loserReward += reward;
+                        loserSteps++;
+                    }
+                }
+            }
+        }
+        for (float reward : rewards) {
+            rewardSum += reward;
+        }
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    uint64_t steps = env.steps() * env.numEnvs();
+    printf("%d envs of %d players on %d threads: %.0f env steps/s, %.0f agent steps/s\n", env.numEnvs(), config.numPlayers,
+           config.numThreads, steps / elapsed, steps * config.numPlayers / elapsed);
+    if (config.grid.resolution > 0) {
+        double covered = 0.0;
+        for (float cell : grids) {
+            covered += cell > 0.0f;
+        }
+        printf("  %dx%d grids, %.2f%% of the last cells covered\n", config.grid.resolution, config.grid.resolution,
+               100.0 * covered / grids.size());
+    }
+    printf("  %llu episodes, %.1f ticks per episode, %.3f reward per agent step\n", (unsigned long long)episodes,
+           episodes > 0 ? (double)steps / episodes : 0.0, rewardSum / (steps * config.numPlayers));
+    if (winnerSteps > 0 && loserSteps > 0) {
+        printf("  last step of a won episode: %.3f reward per winning agent, %.3f per other\n", winnerReward / winnerSteps,
+               loserReward / loserSteps);
+        if (winnerReward / winnerSteps <= loserReward / loserSteps) {
+            fprintf(stderr, "the winning teams were not rewarded above the others\n");
+            return 1;
+        }
+    }
+    return 0;
+}